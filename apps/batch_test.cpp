@@ -0,0 +1,294 @@
+/**
+ *  Function:
+ *  test of StationBatch: simulated GPS stations processed with the SPP
+ *  chain (ComputeCombination, ComputeSatPos, ComputeDerivative,
+ *  ComputeTropModel, LsqSPP), all of them sharing one Rx3NavStore and one
+ *  LinearCombinations. The stations are processed on one thread, then on
+ *  several, and the solutions must be the same, bit for bit, and close
+ *  to the simulated positions.
+ *
+ *  Built with -DUSE_TSAN=ON (ThreadSanitizer, without OpenMP), it checks
+ *  that the stations share no mutable state:
+ *
+ *    cmake -S . -B build_tsan -DUSE_TSAN=ON
+ *    cmake --build build_tsan --target batch_test
+ *    build_tsan/apps/batch_test 4 4
+ *
+ *  Usage: batch_test [numberOfStations] [numberOfThreads]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <cmath>
+
+#include "GPSWeekSecond.hpp"
+#include "Rx3NavStore.hpp"
+#include "Rx3ObsData.hpp"
+#include "LinearCombinations.hpp"
+#include "ComputeCombination.hpp"
+#include "ComputeSatPos.hpp"
+#include "ComputeDerivative.hpp"
+#include "ComputeTropModel.hpp"
+#include "TropModel.hpp"
+#include "LsqSPP.hpp"
+#include "StationBatch.hpp"
+
+using namespace std;
+using namespace timeSpace;
+using namespace gnssSpace;
+using namespace utilSpace;
+
+static const int numSats(24);
+static const double interval(30.0);
+
+// GPS time of epoch k
+static CommonTime epochTime(int k)
+{
+    return GPSWeekSecond( 2200, 3600.0*24 + k*interval,
+                          TimeSystem::GPS ).convertToCommonTime();
+}
+
+// uniform noise in [-1, 1], the same on every run
+static double noise(unsigned int& seed)
+{
+    seed = seed*1103515245u + 12345u;
+    return double((seed >> 8) & 0xffff)/32767.5 - 1.0;
+}
+
+// 24 satellites on 6 planes, an ephemeris every 2 hours
+static void simulateNav(Rx3NavStore& navStore)
+{
+    for(int j=0; j<numSats; j++)
+    {
+        SatID sat(j+1, SatelliteSystem::GPS);
+        int plane(j/4), slot(j%4);
+
+        for(int h=0; h<=6; h+=2)
+        {
+            GPSEphemeris eph;
+            eph.satID = sat;
+            eph.ctToe = GPSWeekSecond( 2200, 3600.0*(24 + h),
+                                       TimeSystem::GPS ).convertToCommonTime();
+            eph.ctToc = eph.ctToe;
+            eph.Toe = eph.Toc = 3600.0*(24 + h);
+            eph.GPSWeek = 2200;
+
+            eph.sqrt_A = 5153.7;
+            eph.ecc = 0.005 + 0.001*slot;
+            eph.i0 = 55.0*DEG_TO_RAD;
+            eph.OMEGA_0 = plane*60.0*DEG_TO_RAD;
+            eph.OMEGA_DOT = -8.0e-9;
+            eph.omega = 0.1*j;
+            eph.M0 = (slot*90.0 + plane*15.0)*DEG_TO_RAD
+                     + 1.4585e-4*3600.0*h;
+            eph.Delta_n = eph.IDOT = 0.0;
+            eph.Cuc = eph.Cus = eph.Crc = eph.Crs = eph.Cic = eph.Cis = 0.0;
+
+            eph.af0 = 1.e-5*(j%7 - 3);
+            eph.af1 = 1.e-12*(j%3 - 1);
+            eph.af2 = 0.0;
+            eph.TGD = 0.0;
+
+            navStore.gpsEphData[sat][eph.ctToe] = eph;
+        }
+        navStore.satTable.push_back(sat);
+    }
+}
+
+// position of station i
+static Triple stationPos(int i)
+{
+    double lat( (-60.0 + 120.0*((i*37)%17)/16.0)*DEG_TO_RAD );
+    double lon( (i*97 % 360)*DEG_TO_RAD );
+    double r(6378137.0 - 21385.0*std::sin(lat)*std::sin(lat) + 100.0*(i%5));
+    return Triple( r*std::cos(lat)*std::cos(lon),
+                   r*std::cos(lat)*std::sin(lon),
+                   r*std::sin(lat) );
+}
+
+// number of epochs of station i: the stations are of different lengths
+static int stationEpochs(int i)
+{
+    return 120 + 40*(i%5);
+}
+
+// C1G and C2G of the visible satellites at epoch k for station i
+static void simulateObs( Rx3NavStore& navStore, int i, int k,
+                         Rx3ObsData& data )
+{
+    Triple rx( stationPos(i) );
+    double rxMag( rx.mag() );
+
+    data.currEpoch = epochTime(k);
+    data.stvData.clear();
+
+    unsigned int seed( 7919u*k + 104729u*i + 1 );
+    double cdt( 3000.0*noise(seed) );
+
+    for(int j=0; j<numSats; j++)
+    {
+        SatID sat(j+1, SatelliteSystem::GPS);
+
+        double tau(0.075), rho(0.0);
+        Xvt xvt;
+        Triple sv;
+        for(int iter=0; iter<3; iter++)
+        {
+            CommonTime tt(data.currEpoch);
+            tt -= tau;
+            xvt = navStore.getXvt(sat, tt);
+
+            double wt( OMEGA_EARTH*tau );
+            sv = Triple( xvt.x[0]*std::cos(wt) + xvt.x[1]*std::sin(wt),
+                        -xvt.x[0]*std::sin(wt) + xvt.x[1]*std::cos(wt),
+                         xvt.x[2] );
+            rho = (sv - rx).mag();
+            tau = rho/C_MPS;
+        }
+
+        double sinEl( (sv - rx).dot(rx)/(rho*rxMag) );
+        if(sinEl < std::sin(10.0*DEG_TO_RAD)) continue;
+
+        double tropo( 2.4/sinEl );
+        double iono( (2.0 + 0.1*(j%5))/sinEl );
+        double clk( C_MPS*(xvt.clkbias + xvt.relcorr) );
+
+        typeValueMap& tv( data.stvData[sat] );
+        tv[TypeID::C1G] = rho + cdt - clk + tropo + iono + 0.3*noise(seed);
+        tv[TypeID::C2G] = rho + cdt - clk + tropo + GAMMA_GPS_L1L2*iono
+                          + 0.3*noise(seed);
+    }
+}
+
+// SPP of station i, one solution per epoch
+static void processStation( Rx3NavStore& navStore,
+                            const LinearCombinations& linear,
+                            int i, const std::string& station,
+                            std::vector<Triple>& solutions )
+{
+    ComputeCombination computeIF;
+    computeIF.addLinear(SatelliteSystem::GPS, linear.pc12CombOfGPS);
+
+    gnssLinearCombination c1PrefitOfGPS = linear.c1PrefitOfGPS;
+    gnssLinearCombination c2PrefitOfGPS = linear.c2PrefitOfGPS;
+    c1PrefitOfGPS.addOptionalType(TypeID::gravDelay);
+    c2PrefitOfGPS.addOptionalType(TypeID::gravDelay);
+
+    ComputeCombination sppPrefit;
+    sppPrefit.addLinear(SatelliteSystem::GPS, c1PrefitOfGPS);
+    sppPrefit.addLinear(SatelliteSystem::GPS, c2PrefitOfGPS);
+
+    ComputeSatPos computeSatPos(navStore);
+    ComputeDerivative computeDerivative;
+
+    NeillTropModel neillTM;
+    ComputeTropModel computeTrop;
+    computeTrop.setTropModel(neillTM);
+
+    LsqSPP lsqSPP;
+    lsqSPP.setSource(station);
+
+    Triple rcvPos( stationPos(i) + Triple(100.0, -100.0, 50.0) );
+
+    Rx3ObsData rxData;
+    int nEpochs( stationEpochs(i) );
+    solutions.assign(nEpochs, Triple());
+
+    for(int k=0; k<nEpochs; k++)
+    {
+        simulateObs(navStore, i, k, rxData);
+        computeIF.Process(rxData);
+
+        if(rxData.numSats() <= 6) continue;
+
+        for(int iter=0; iter<6; iter++)
+        {
+            computeSatPos.setRxPos(rcvPos);
+            computeSatPos.Process(rxData);
+            computeDerivative.setCoordinates(rcvPos);
+            computeDerivative.Process(rxData);
+            computeTrop.setAllParameters(rxData.currEpoch, rcvPos);
+            computeTrop.Process(rxData);
+            sppPrefit.Process(rxData);
+
+            lsqSPP.Process(rxData);
+
+            Triple dx( lsqSPP.getDx() );
+            rcvPos = rcvPos + dx;
+            if(dx.mag() < 0.01) break;
+        }
+
+        solutions[k] = rcvPos;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int nStations(argc > 1 ? atoi(argv[1]) : 16);
+    int nThreads(argc > 2 ? atoi(argv[2]) : 4);
+
+    // loaded once, only read by the stations
+    Rx3NavStore navStore;
+    simulateNav(navStore);
+
+    const LinearCombinations linear;
+
+    std::vector<std::string> stations;
+    for(int i=0; i<nStations; i++)
+    {
+        ostringstream name;
+        name << "ST" << setfill('0') << setw(2) << i;
+        stations.push_back(name.str());
+    }
+
+    std::vector< std::vector<Triple> > sequential(nStations), parallel(nStations);
+
+    StationBatch batch;
+    batch.setStations(stations);
+
+    batch.setThreads(1)
+         .setStationFunction( [&](size_t i, const std::string& station)
+         {
+             processStation(navStore, linear, i, station, sequential[i]);
+         } );
+    batch.run();
+    double seqSeconds( batch.getSeconds() );
+
+    batch.setThreads(nThreads)
+         .setStationFunction( [&](size_t i, const std::string& station)
+         {
+             processStation(navStore, linear, i, station, parallel[i]);
+         } );
+    batch.run();
+
+    batch.dumpReport(cout);
+    cout << " one thread " << fixed << setprecision(3) << seqSeconds
+         << " s, " << nThreads << " threads " << batch.getSeconds()
+         << " s" << endl;
+
+    bool same( batch.numFailed() == 0 );
+    double maxErr(0.0);
+    int numSols(0);
+    for(int i=0; i<nStations; i++)
+    {
+        if(parallel[i].size() != sequential[i].size()) same = false;
+        for(size_t k=0; k<parallel[i].size() && k<sequential[i].size(); k++)
+        {
+            if( !(parallel[i][k] == sequential[i][k]) ) same = false;
+
+            // epochs without solution are left at zero
+            if(parallel[i][k].mag() == 0.0) continue;
+            numSols++;
+            maxErr = std::max(maxErr, (parallel[i][k] - stationPos(i)).mag());
+        }
+    }
+
+    cout << " " << nStations << " stations: "
+         << (same ? "same results" : "FAILED")
+         << ", " << numSols << " solutions, largest position error "
+         << setprecision(2) << maxErr << " m" << endl;
+
+    return (same && numSols > 0 && maxErr < 20.0) ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+/**
+ *  Function:
+ *  compare broadcast orbits and clocks with precise ones for all
+ *  satellites and epochs of the precise products, and write a summary
+ *  of the radial, along-track, cross-track and clock differences for
+ *  each satellite and each system.
+ */
+
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <vector>
+#include <cstdlib>
+
+#include "OptionUtil.hpp"
+#include "Counter.hpp"
+#include "SP3EphStore.hpp"
+#include "Rx3NavStore.hpp"
+#include "CompareEph.hpp"
+
+#define debug 0
+
+using namespace std;
+using namespace gnssSpace;
+using namespace utilSpace;
+
+int main(int argc, char* argv[])
+{
+    string helpInfo
+        =
+    "Usage:\n"
+    " \n"
+    "required options:\n"
+    "    --nav <nav_file>          broadcast nav file, this option can be repeated\n"
+    "    --sp3 <sp3_file>          precise orbit file, this option can be repeated\n"
+    "optional options:\n"
+    "    --clk <clk_file>          rinex clock file, this option can be repeated\n"
+    "    --interval <seconds>      time step of the comparison, default 300\n"
+    "    --output <output_file>    summary file, default standard output\n"
+    "    --help                    Prints this help\n"
+    " \n"
+    "Examples:\n"
+    "eph_compare --nav BRDC.rnx --sp3 COD.SP3 --clk COD.CLK --output ./summary.txt \n";
+
+    ///initialization
+    OptionAttribute navAttribute(1, 1);
+    OptionAttribute sp3Attribute(1, 1);
+    OptionAttribute clkAttribute(1, 1);
+    OptionAttribute intervalAttribute(1, 0);
+    OptionAttribute outputAttribute(1, 0);
+    OptionAttribute helpAttribute(0, 0);
+
+    OptionAttMap optAttData;
+    OptionValueMap optValData;
+
+    /// define and insert
+    optAttData["--nav"] = navAttribute;
+    optAttData["--sp3"] = sp3Attribute;
+    optAttData["--clk"] = clkAttribute;
+    optAttData["--interval"] = intervalAttribute;
+    optAttData["--output"] = outputAttribute;
+    optAttData["--help"] = helpAttribute;
+
+    ///prase the options
+    parseOption(argc, argv, optAttData, optValData, helpInfo);
+
+    if (optValData.find("--nav") == optValData.end() ||
+        optValData.find("--sp3") == optValData.end())
+    {
+        cerr << "--nav and --sp3 are required!" << endl;
+        exit(-1);
+    }
+
+    double interval(300.0);
+    if (optValData.find("--interval") != optValData.end())
+    {
+        interval = atof(optValData["--interval"][0].c_str());
+    }
+
+    double clock1(Counter::now());
+
+    Rx3NavStore navStore;
+    SP3EphStore sp3Store;
+    try
+    {
+        for (auto f: optValData["--nav"])
+        {
+            navStore.loadFile(f);
+        }
+
+        sp3Store.loadSP3Files(optValData["--sp3"]);
+
+        if (optValData.find("--clk") != optValData.end())
+        {
+            sp3Store.loadRinexClockFiles(optValData["--clk"]);
+        }
+    }
+    catch (Exception& e)
+    {
+        cerr << e << endl;
+        exit(-1);
+    }
+
+    double clock2(Counter::now());
+
+    CompareEph compareEph(navStore, sp3Store);
+    try
+    {
+        compareEph.Process(sp3Store.getSatList(),
+                           sp3Store.getInitialTime(),
+                           sp3Store.getFinalTime(),
+                           interval);
+    }
+    catch (Exception& e)
+    {
+        cerr << e << endl;
+        exit(-1);
+    }
+
+    double clock3(Counter::now());
+
+    if (optValData.find("--output") != optValData.end())
+    {
+        fstream outFileStrm(optValData["--output"][0].c_str(), ios::out);
+        compareEph.printSummary(outFileStrm);
+        outFileStrm.close();
+    }
+    else
+    {
+        compareEph.printSummary(cout);
+    }
+
+    cerr << "load " << clock2 - clock1 << " s, compare "
+         << clock3 - clock2 << " s" << endl;
+
+    return 0;
+}
@@ -0,0 +1,280 @@
+/**
+ *  Function:
+ *  benchmark of the SPP processing chain (ComputeCombination,
+ *  ComputeDerivative, ComputeTropModel, prefit ComputeCombination,
+ *  LsqSPP) on satTypeValueMap and on satTypeValueTable, with simulated
+ *  GPS/Galileo/BDS epochs. The satellite positions and clocks are
+ *  simulated too, so no ephemeris is needed.
+ *
+ *  The heap allocations (operator new) and the bytes allocated per epoch
+ *  are counted too, and those taken from the EpochArena.
+ *
+ *  Usage: epoch_bench [numberOfEpochs]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <new>
+
+#include "Counter.hpp"
+#include "EpochArena.hpp"
+#include "GPSWeekSecond.hpp"
+#include "DataStructures.hpp"
+#include "SatTypeValueTable.hpp"
+#include "Rx3ObsData.hpp"
+#include "LinearCombinations.hpp"
+#include "ComputeCombination.hpp"
+#include "ComputeDerivative.hpp"
+#include "ComputeTropModel.hpp"
+#include "TropModel.hpp"
+#include "LsqSPP.hpp"
+
+using namespace std;
+using namespace timeSpace;
+using namespace gnssSpace;
+using namespace utilSpace;
+
+// heap allocations of the program, and their bytes
+static size_t numNew(0), bytesNew(0);
+
+void* operator new(size_t n)
+{
+    numNew++;
+    bytesNew += n;
+    void* p( std::malloc(n ? n : 1) );
+    if(p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+// satellites of the simulation, with their orbit phase
+struct SimSat
+{
+    SatID sat;
+    double a, inc, raan, u0;
+};
+
+// observations of one epoch seen from rcvPos
+static void simulate( const std::vector<SimSat>& sats, double t,
+                      const Triple& rcvPos, satTypeValueMap& stvData )
+{
+    stvData.clear();
+
+    const double gm(3.986004418e14), we(7.2921151467e-5);
+    for(size_t j=0; j<sats.size(); j++)
+    {
+        const SimSat& s(sats[j]);
+        double u(s.u0 + std::sqrt(gm/(s.a*s.a*s.a))*t);
+        double lan(s.raan - we*t);
+        Triple pos( s.a*(std::cos(u)*std::cos(lan) -
+                         std::sin(u)*std::cos(s.inc)*std::sin(lan)),
+                    s.a*(std::cos(u)*std::sin(lan) +
+                         std::sin(u)*std::cos(s.inc)*std::cos(lan)),
+                    s.a*std::sin(u)*std::sin(s.inc) );
+
+        Triple d(pos - rcvPos);
+        double rho(d.mag());
+
+        // above the horizon, roughly
+        if(d.dot(rcvPos) < 0.1*rho*rcvPos.mag()) continue;
+
+        double cdtSat(1.e-4*(j+1)*C_MPS*1.e-3);
+        double iono(3.0 + 0.1*j);
+
+        typeValueMap& tv(stvData[s.sat]);
+        tv[TypeID::satXECEF] = pos[0];
+        tv[TypeID::satYECEF] = pos[1];
+        tv[TypeID::satZECEF] = pos[2];
+        tv[TypeID::cdtSat] = cdtSat;
+        tv[TypeID::relativity] = 0.0;
+        tv[TypeID::gravDelay] = 0.0;
+
+        double pr(rho - cdtSat + 2.4);
+        if(s.sat.system == SatelliteSystem::GPS)
+        {
+            tv[TypeID::C1G] = pr + iono;
+            tv[TypeID::C2G] = pr + 1.65*iono;
+            tv[TypeID::L1G] = pr - iono;
+            tv[TypeID::L2G] = pr - 1.65*iono;
+        }
+        else if(s.sat.system == SatelliteSystem::Galileo)
+        {
+            tv[TypeID::C1E] = pr + iono;
+            tv[TypeID::C5E] = pr + 1.79*iono;
+            tv[TypeID::L1E] = pr - iono;
+            tv[TypeID::L5E] = pr - 1.79*iono;
+        }
+        else
+        {
+            tv[TypeID::C2C] = pr + iono;
+            tv[TypeID::C6C] = pr + 1.52*iono;
+            tv[TypeID::L2C] = pr - iono;
+            tv[TypeID::L6C] = pr - 1.52*iono;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int nEpochs(argc > 1 ? atoi(argv[1]) : 2000);
+
+    // 32 GPS, 24 Galileo, 30 BDS MEO-like satellites
+    std::vector<SimSat> sats;
+    for(int j=0; j<86; j++)
+    {
+        SimSat s;
+        if(j < 32)
+        { s.sat = SatID(j+1, SatelliteSystem::GPS); s.a = 26560.e3; }
+        else if(j < 56)
+        { s.sat = SatID(j-31, SatelliteSystem::Galileo); s.a = 29600.e3; }
+        else
+        { s.sat = SatID(j-55, SatelliteSystem::BDS); s.a = 27900.e3; }
+        s.inc = 0.96;
+        s.raan = 2.0*PI*(j%6)/6.0;
+        s.u0 = 2.0*PI*j/86.0*7.0;
+        sats.push_back(s);
+    }
+
+    CommonTime t0 = GPSWeekSecond(2138, 0.0, TimeSystem::GPS).convertToCommonTime();
+    Triple rcvTrue(-2267750.0, 5009154.0, 3221290.0);
+
+    LinearCombinations linear;
+
+    ComputeCombination computeIF;
+    computeIF.addLinear(SatelliteSystem::GPS,     linear.pc12CombOfGPS);
+    computeIF.addLinear(SatelliteSystem::GPS,     linear.lc12CombOfGPS);
+    computeIF.addLinear(SatelliteSystem::BDS,     linear.pc26CombOfBDS);
+    computeIF.addLinear(SatelliteSystem::BDS,     linear.lc26CombOfBDS);
+    computeIF.addLinear(SatelliteSystem::Galileo, linear.pc15CombOfGAL);
+    computeIF.addLinear(SatelliteSystem::Galileo, linear.lc15CombOfGAL);
+
+    ComputeCombination sppPrefit;
+    sppPrefit.addLinear(SatelliteSystem::GPS,     linear.c1PrefitOfGPS);
+    sppPrefit.addLinear(SatelliteSystem::GPS,     linear.c2PrefitOfGPS);
+    sppPrefit.addLinear(SatelliteSystem::Galileo, linear.c1PrefitOfGAL);
+    sppPrefit.addLinear(SatelliteSystem::Galileo, linear.c5PrefitOfGAL);
+    sppPrefit.addLinear(SatelliteSystem::BDS,     linear.c2PrefitOfBDS);
+    sppPrefit.addLinear(SatelliteSystem::BDS,     linear.c6PrefitOfBDS);
+
+    NeillTropModel neillTM;
+    ComputeTropModel computeTrop;
+    computeTrop.setTropModel(neillTM);
+    ComputeDerivative computeDerivative;
+
+    // simulated epochs, 1 s apart
+    std::vector<satTypeValueMap> epochs(nEpochs);
+    for(int k=0; k<nEpochs; k++)
+        simulate(sats, k, rcvTrue, epochs[k]);
+
+    cout << nEpochs << " epochs, " << epochs[0].numSats()
+         << " satellites in the first one; microsec per epoch" << endl;
+    cout << left << setw(18) << " container" << right
+         << " combine  derive    trop  prefit convert     lsq   total  maxdiff(m)"
+         << "  heap/ep  kB/ep arena/ep"
+         << endl;
+
+    std::vector<Triple> solMap(nEpochs), solTable(nEpochs);
+
+    for(int mode=0; mode<2; mode++)
+    {
+        LsqSPP lsqSPP;
+        Rx3ObsData rxData;
+        satTypeValueTable table;
+        double tComb(0), tDeriv(0), tTrop(0), tPrefit(0), tConv(0), tLsq(0);
+        size_t numArena(0);
+        size_t numNew0(numNew), bytesNew0(bytesNew);
+
+        double begin(Counter::now());
+        for(int k=0; k<nEpochs; k++)
+        {
+            rxData.currEpoch = t0 + double(k);
+            Triple rcvPos(rcvTrue + Triple(100.0, -100.0, 50.0));
+            computeTrop.setAllParameters(t0, rcvPos);
+
+            for(int iter=0; iter<3; iter++)
+            {
+                double c0(Counter::now());
+                computeDerivative.setCoordinates(rcvPos);
+                if(mode == 0)
+                {
+                    rxData.stvData = epochs[k];
+                    double c1(Counter::now());
+                    computeIF.Process(rxData.currEpoch, rxData.stvData);
+                    double c2(Counter::now());
+                    computeDerivative.Process(rxData.currEpoch, rxData.stvData);
+                    double c3(Counter::now());
+                    computeTrop.Process(rxData.currEpoch, rxData.stvData);
+                    double c4(Counter::now());
+                    sppPrefit.Process(rxData.currEpoch, rxData.stvData);
+                    double c5(Counter::now());
+                    tConv += c1 - c0;
+                    tComb += c2 - c1;  tDeriv += c3 - c2;
+                    tTrop += c4 - c3;  tPrefit += c5 - c4;
+                }
+                else
+                {
+                    table.fromMap(epochs[k]);
+                    double c1(Counter::now());
+                    computeIF.Process(rxData.currEpoch, table);
+                    double c2(Counter::now());
+                    computeDerivative.Process(rxData.currEpoch, table);
+                    double c3(Counter::now());
+                    computeTrop.Process(rxData.currEpoch, table);
+                    double c4(Counter::now());
+                    sppPrefit.Process(rxData.currEpoch, table);
+                    double c5(Counter::now());
+                    table.toMap(rxData.stvData);
+                    double c6(Counter::now());
+                    tConv += (c1 - c0) + (c6 - c5);
+                    tComb += c2 - c1;  tDeriv += c3 - c2;
+                    tTrop += c4 - c3;  tPrefit += c5 - c4;
+                }
+
+                double c6(Counter::now());
+                lsqSPP.Process(rxData);
+                tLsq += Counter::now() - c6;
+
+                rcvPos = rcvPos + lsqSPP.getDx();
+            }
+
+            (mode == 0 ? solMap : solTable)[k] = rcvPos;
+
+            numArena += EpochArena::local().numAllocs();
+            EpochArena::local().reset();
+        }
+        double tTotal(Counter::now() - begin);
+
+        double maxDiff(0.0);
+        if(mode == 1)
+        {
+            for(int k=0; k<nEpochs; k++)
+                maxDiff = std::max(maxDiff, (solTable[k] - solMap[k]).mag());
+        }
+
+        double scale(1.e6/nEpochs);
+        cout << left << setw(18)
+             << (mode == 0 ? " satTypeValueMap" : " satTypeValueTable")
+             << right << fixed << setprecision(1)
+             << setw(8) << tComb*scale
+             << setw(8) << tDeriv*scale
+             << setw(8) << tTrop*scale
+             << setw(8) << tPrefit*scale
+             << setw(8) << tConv*scale
+             << setw(8) << tLsq*scale
+             << setw(8) << tTotal*scale
+             << scientific << setprecision(1) << setw(12) << maxDiff
+             << fixed << setprecision(0)
+             << setw(9) << double(numNew - numNew0)/nEpochs
+             << setw(7) << double(bytesNew - bytesNew0)/nEpochs/1024.0
+             << setw(9) << double(numArena)/nEpochs
+             << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ *  Function:
+ *  convert the GPT2 grid file of ViennaTropModel (gpt2_1.grd, or the
+ *  gpt2_1w.grd of GPT2w, with the same first 44 columns) into the binary
+ *  format that ViennaTropModel::loadFile() maps into memory, and check
+ *  that both give the same weather.
+ *
+ *  Usage: gpt2_convert gridFile binaryFile
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+#include "Counter.hpp"
+#include "TropModel.hpp"
+
+using namespace std;
+using namespace timeSpace;
+using namespace gnssSpace;
+using namespace utilSpace;
+
+int main(int argc, char *argv[])
+{
+    if(argc < 3)
+    {
+        cerr << "Usage: gpt2_convert gridFile binaryFile" << endl;
+        return 1;
+    }
+
+    ViennaTropModel textTM, binaryTM;
+
+    try
+    {
+        double begin( Counter::now() );
+        textTM.loadFile(argv[1]);
+        double textSeconds( Counter::now() - begin );
+
+        textTM.writeBinaryFile(argv[2]);
+
+        begin = Counter::now();
+        binaryTM.loadFile(argv[2]);
+        double binarySeconds( Counter::now() - begin );
+
+        cout << textTM.getGridSize() << " cells, text file read in "
+             << fixed << setprecision(4) << textSeconds
+             << " s, binary file mapped in " << binarySeconds << " s"
+             << endl;
+
+        // the same weather over the grid
+        double maxDiff(0.0);
+        for(double lat=-85.0; lat<=85.0; lat+=10.0)
+        {
+            for(double lon=-175.0; lon<=175.0; lon+=25.0)
+            {
+                textTM.setReceiverLatitude(lat);
+                textTM.setReceiverLongitude(lon);
+                textTM.setReceiverHeight(100.0);
+                textTM.setModifiedJulianDate(59000.0);
+
+                binaryTM.setReceiverLatitude(lat);
+                binaryTM.setReceiverLongitude(lon);
+                binaryTM.setReceiverHeight(100.0);
+                binaryTM.setModifiedJulianDate(59000.0);
+
+                maxDiff = std::max( maxDiff,
+                                    std::fabs( textTM.correction(10.0)
+                                               - binaryTM.correction(10.0) ) );
+            }
+        }
+
+        if(maxDiff != 0.0)
+        {
+            cerr << "the binary grid differs by " << maxDiff << " m" << endl;
+            return 1;
+        }
+    }
+    catch(Exception& e)
+    {
+        cerr << e << endl;
+        return 1;
+    }
+
+    return 0;
+}
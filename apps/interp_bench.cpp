@@ -0,0 +1,242 @@
+/**
+ *  Function:
+ *  benchmark of the Lagrange interpolation in PositionSatStore and
+ *  ClockSatStore: kernels of fixed (compile-time) order against the
+ *  general code with the order given at run time; and high-rate (30 s)
+ *  clocks from ClockSatStore against the grid of ClockTable.
+ *
+ *  Usage: interp_bench [numberOfCalls]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+
+#include "Counter.hpp"
+#include "PositionSatStore.hpp"
+#include "ClockSatStore.hpp"
+#include "ClockTable.hpp"
+#include "GPSWeekSecond.hpp"
+
+using namespace std;
+using namespace timeSpace;
+using namespace gnssSpace;
+
+// stores which may be switched back to the run-time order code
+class RuntimePositionStore : public PositionSatStore
+{
+public:
+    void useRuntimeOrder() { fixedGetValue = NULL; }
+};
+
+class RuntimeClockStore : public ClockSatStore
+{
+public:
+    void useRuntimeOrder() { fixedGetValue = NULL; }
+};
+
+// circular orbit (km) of a GPS-like satellite
+static Triple orbit(double t)
+{
+    const double a(26560.0), n(std::sqrt(398600.4418/(a*a*a))), inc(0.96);
+    double u(n*t);
+    return Triple(a*std::cos(u), a*std::sin(u)*std::cos(inc),
+                  a*std::sin(u)*std::sin(inc));
+}
+
+int main(int argc, char *argv[])
+{
+    int nCalls(argc > 1 ? atoi(argv[1]) : 200000);
+
+    SatID sat(1, SatelliteSystem::GPS);
+    CommonTime t0 = GPSWeekSecond(2138, 0.0, TimeSystem::GPS).convertToCommonTime();
+
+    // one day of 15 min orbits, and 5 min clocks
+    RuntimePositionStore posFixed, posRuntime;
+    for(int k=0; k<97; k++)
+    {
+        CommonTime t(t0 + 900.0*k);
+        posFixed.addPositionData(sat, t, orbit(900.0*k), Triple(0,0,0));
+        posRuntime.addPositionData(sat, t, orbit(900.0*k), Triple(0,0,0));
+    }
+
+    RuntimeClockStore clkFixed, clkRuntime;
+    clkFixed.setLagrangeInterp();
+    clkRuntime.setLagrangeInterp();
+    for(int k=0; k<289; k++)
+    {
+        CommonTime t(t0 + 300.0*k);
+        double bias(1.e-4 + 1.e-11*300.0*k + 1.e-9*std::sin(300.0*k/3000.0));
+        clkFixed.addClockBias(sat, t, bias);
+        clkRuntime.addClockBias(sat, t, bias);
+    }
+
+    cout << "Lagrange interpolation, " << nCalls
+         << " calls of getValue(), microsec per call" << endl;
+    cout << " order   position: runtime    fixed  maxdiff(m)"
+         << "   clock: runtime    fixed  maxdiff(s)" << endl;
+
+    int orders[] = {2, 4, 8, 10, 12};
+    for(int j=0; j<5; j++)
+    {
+        int order(orders[j]);
+
+        posFixed.setInterpolationOrder(order);
+        posRuntime.setInterpolationOrder(order);
+        posRuntime.useRuntimeOrder();
+
+        clkFixed.setInterpolationOrder(order);
+        clkRuntime.setInterpolationOrder(order);
+        clkRuntime.useRuntimeOrder();
+
+        // times spread over the middle of the day
+        double step(43200.0/nCalls);
+
+        double tPosRuntime(-1.0), tPosFixed, dPos(0.0);
+        double tClkRuntime(-1.0), tClkFixed, dClk(0.0);
+        double sum(0.0);
+
+        // the run-time order code needs at least 4 points
+        if(order >= 4)
+        {
+            double begin(Counter::now());
+            for(int i=0; i<nCalls; i++)
+                sum += posRuntime.getValue(sat, t0 + 21600.0 + i*step).Pos[0];
+            tPosRuntime = Counter::now() - begin;
+
+            begin = Counter::now();
+            for(int i=0; i<nCalls; i++)
+                sum += clkRuntime.getValue(sat, t0 + 21600.0 + i*step).bias;
+            tClkRuntime = Counter::now() - begin;
+        }
+
+        double begin(Counter::now());
+        for(int i=0; i<nCalls; i++)
+            sum += posFixed.getValue(sat, t0 + 21600.0 + i*step).Pos[0];
+        tPosFixed = Counter::now() - begin;
+
+        begin = Counter::now();
+        for(int i=0; i<nCalls; i++)
+            sum += clkFixed.getValue(sat, t0 + 21600.0 + i*step).bias;
+        tClkFixed = Counter::now() - begin;
+
+        // agreement of the two codes
+        if(order >= 4)
+        {
+            for(int i=0; i<nCalls; i+=97)
+            {
+                CommonTime t(t0 + 21600.0 + i*step);
+                PositionRecord p1(posFixed.getValue(sat, t));
+                PositionRecord p2(posRuntime.getValue(sat, t));
+                for(int k=0; k<3; k++)
+                    dPos = std::max(dPos, 1000.0*std::abs(p1.Pos[k]-p2.Pos[k]));
+                dClk = std::max(dClk, std::abs(clkFixed.getValue(sat, t).bias -
+                                               clkRuntime.getValue(sat, t).bias));
+            }
+        }
+
+        double scale(1.e6/nCalls);
+        cout << setw(6) << order << fixed << setprecision(3);
+        if(order >= 4)
+            cout << setw(19) << tPosRuntime*scale;
+        else
+            cout << setw(19) << "-";
+        cout << setw(9) << tPosFixed*scale
+             << scientific << setprecision(1) << setw(12) << dPos
+             << fixed << setprecision(3);
+        if(order >= 4)
+            cout << setw(16) << tClkRuntime*scale;
+        else
+            cout << setw(16) << "-";
+        cout << setw(9) << tClkFixed*scale
+             << scientific << setprecision(1) << setw(12) << dClk
+             << fixed << endl;
+
+        // keep the loops
+        if(sum == 0.123) cout << sum << endl;
+    }
+
+    // one day of 30 s clocks of 32 satellites, e.g. for 1 Hz PPP
+    const int nSat(32);
+    ClockSatStore clkStore;
+    for(int j=0; j<nSat; j++)
+    {
+        SatID s(j+1, SatelliteSystem::GPS);
+        for(int k=0; k<2880; k++)
+        {
+            double t(30.0*k);
+            double bias(1.e-4*(j+1) + 1.e-11*t + 1.e-9*std::sin(t/(3000.0+j)));
+            clkStore.addClockBias(s, t0 + t, bias);
+        }
+    }
+
+    ClockTable table;
+    table.build(clkStore);
+
+    cout << endl << "30 s clocks of " << nSat << " satellites, " << nCalls/nSat
+         << " epochs of 1 s, microsec per satellite and epoch" << endl;
+    cout << " points      store    table    batch  maxdiff(s)" << endl;
+
+    for(int nPoints=2; nPoints<=3; nPoints++)
+    {
+        table.setInterpolationPoints(nPoints);
+        if(nPoints == 2) clkStore.setLinearInterp();
+        else clkStore.setLagrangeInterp();
+
+        // epochs of 1 s from the middle of the day
+        int nEpochs(nCalls/nSat);
+        double sum(0.0), bias, drift;
+
+        double begin(Counter::now());
+        for(int i=0; i<nEpochs; i++)
+            for(int j=0; j<nSat; j++)
+                sum += clkStore.getValue(SatID(j+1, SatelliteSystem::GPS),
+                                         t0 + 43200.0 + i).bias;
+        double tStore(Counter::now() - begin);
+
+        begin = Counter::now();
+        for(int i=0; i<nEpochs; i++)
+            for(int j=0; j<nSat; j++)
+            {
+                table.getValue(SatID(j+1, SatelliteSystem::GPS),
+                               t0 + 43200.0 + i, bias, drift);
+                sum += bias;
+            }
+        double tTable(Counter::now() - begin);
+
+        std::vector<double> biases, drifts;
+        std::vector<char> ok;
+        begin = Counter::now();
+        for(int i=0; i<nEpochs; i++)
+        {
+            table.getValues(t0 + 43200.0 + i, biases, drifts, ok);
+            sum += biases[0];
+        }
+        double tBatch(Counter::now() - begin);
+
+        // agreement with the store; quadratic is compared to the Lagrange
+        // interpolation of the store, so it shows the interpolation error
+        double dClk(0.0);
+        for(int i=0; i<nEpochs; i+=7)
+            for(int j=0; j<nSat; j++)
+            {
+                SatID s(j+1, SatelliteSystem::GPS);
+                CommonTime t(t0 + 43200.0 + i);
+                if(table.getValue(s, t, bias, drift))
+                    dClk = std::max(dClk, std::abs(bias - clkStore.getValue(s, t).bias));
+            }
+
+        double scale(1.e6/(nEpochs*nSat));
+        cout << setw(7) << nPoints << fixed << setprecision(3)
+             << setw(11) << tStore*scale
+             << setw(9) << tTable*scale
+             << setw(9) << tBatch*scale
+             << scientific << setprecision(1) << setw(12) << dClk
+             << fixed << endl;
+
+        if(sum == 0.123) cout << sum << endl;
+    }
+
+    return 0;
+}
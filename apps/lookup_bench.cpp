@@ -0,0 +1,182 @@
+/**
+ *  Function:
+ *  benchmark of the look-up of values which may be missing, on simulated
+ *  epochs where many satellites lack some of the types (cdtSat and
+ *  relativity, elevation, one of the MW combinations). It times
+ *  ComputeDerivative, ComputeElevWeights and DetectCSMW, and compares the
+ *  look-up with getValue() and a catch of TypeIDNotFound against tryGet().
+ *
+ *  Usage: lookup_bench [numberOfEpochs] [fractionMissing]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+
+#include "Counter.hpp"
+#include "EpochArena.hpp"
+#include "GPSWeekSecond.hpp"
+#include "DataStructures.hpp"
+#include "ComputeDerivative.hpp"
+#include "ComputeElevWeights.hpp"
+#include "DetectCSMW.hpp"
+
+using namespace std;
+using namespace timeSpace;
+using namespace gnssSpace;
+using namespace utilSpace;
+
+// one epoch of 32 GPS and 30 BDS satellites, of which 'missing' (0..1)
+// lack one of the types looked for
+static void simulate( int k, double missing, const Triple& rcvPos,
+                      satTypeValueMap& stvData )
+{
+    stvData.clear();
+
+    for(int j=0; j<62; j++)
+    {
+        SatID sat( j<32 ? SatID(j+1, SatelliteSystem::GPS)
+                        : SatID(j-31, SatelliteSystem::BDS) );
+
+        double u(2.0*PI*j/62.0*7.0 + 1.e-4*k);
+        double lan(2.0*PI*(j%6)/6.0);
+        Triple pos( 26560.e3*(std::cos(u)*std::cos(lan) -
+                              std::sin(u)*0.57*std::sin(lan)),
+                    26560.e3*(std::cos(u)*std::sin(lan) +
+                              std::sin(u)*0.57*std::cos(lan)),
+                    26560.e3*std::sin(u)*0.82 );
+
+        typeValueMap& tv(stvData[sat]);
+        tv[TypeID::satXECEF] = pos[0];
+        tv[TypeID::satYECEF] = pos[1];
+        tv[TypeID::satZECEF] = pos[2];
+        tv[TypeID::gravDelay] = 0.0;
+
+        // which satellites lack the types changes with the epoch
+        bool lacks( (j*37 + k) % 100 < 100.0*missing );
+        if(!lacks)
+        {
+            tv[TypeID::cdtSat] = 1.e-4*(j+1);
+            tv[TypeID::relativity] = 0.0;
+            tv[TypeID::elevation] = 10.0 + j;
+        }
+
+        double mw(0.86*j + 1.e-3*(k%7));
+        if(sat.system == SatelliteSystem::GPS)
+        {
+            tv[TypeID::MW12G] = mw;
+            if(!lacks) tv[TypeID::MW15G] = mw;
+        }
+        else
+        {
+            tv[TypeID::MW26C] = mw;
+            if(!lacks) tv[TypeID::MW27C] = mw;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int nEpochs(argc > 1 ? atoi(argv[1]) : 2000);
+    double missing(argc > 2 ? atof(argv[2]) : 0.5);
+
+    CommonTime t0 = GPSWeekSecond(2138, 0.0, TimeSystem::GPS).convertToCommonTime();
+    Triple rcvPos(-2267750.0, 5009154.0, 3221290.0);
+
+    std::vector<satTypeValueMap> epochs(nEpochs);
+    for(int k=0; k<nEpochs; k++)
+        simulate(k, missing, rcvPos, epochs[k]);
+
+    ComputeDerivative computeDerivative;
+    computeDerivative.setCoordinates(rcvPos);
+    computeDerivative.setMinElev(-90.0);
+
+    ComputeElevWeights computeWeights;
+
+    DetectCSMW markCSMW;
+    markCSMW.addType(SatelliteSystem::GPS, TypeID::MW12G);
+    markCSMW.addType(SatelliteSystem::GPS, TypeID::MW15G);
+    markCSMW.addType(SatelliteSystem::BDS, TypeID::MW26C);
+    markCSMW.addType(SatelliteSystem::BDS, TypeID::MW27C);
+
+    double tDeriv(0), tWeights(0), tCSMW(0);
+    size_t numSats(0);
+
+    satTypeValueMap stvData;
+    for(int k=0; k<nEpochs; k++)
+    {
+        CommonTime epoch(t0 + double(k));
+
+        stvData = epochs[k];
+        double c0(Counter::now());
+        computeDerivative.Process(epoch, stvData);
+        tDeriv += Counter::now() - c0;
+
+        stvData = epochs[k];
+        c0 = Counter::now();
+        computeWeights.Process(epoch, stvData);
+        tWeights += Counter::now() - c0;
+
+        stvData = epochs[k];
+        c0 = Counter::now();
+        markCSMW.Process(epoch, stvData);
+        tCSMW += Counter::now() - c0;
+
+        numSats += stvData.numSats();
+
+        EpochArena::local().reset();
+    }
+
+    // look-up of the elevation alone
+    double sumCatch(0.0), sumTry(0.0);
+    double c0(Counter::now());
+    for(int k=0; k<nEpochs; k++)
+    {
+        const satTypeValueMap& gData(epochs[k]);
+        for(satTypeValueMap::const_iterator it = gData.begin();
+            it != gData.end();
+            ++it)
+        {
+            try
+            {
+                sumCatch += (*it).second.getValue(TypeID::elevation);
+            }
+            catch(TypeIDNotFound& e)
+            {
+                continue;
+            }
+        }
+    }
+    double tCatch(Counter::now() - c0);
+
+    c0 = Counter::now();
+    for(int k=0; k<nEpochs; k++)
+    {
+        const satTypeValueMap& gData(epochs[k]);
+        for(satTypeValueMap::const_iterator it = gData.begin();
+            it != gData.end();
+            ++it)
+        {
+            const double* pElev( (*it).second.tryGet(TypeID::elevation) );
+            if(pElev == NULL) continue;
+            sumTry += *pElev;
+        }
+    }
+    double tTry(Counter::now() - c0);
+
+    double scale(1.e6/nEpochs);
+    cout << nEpochs << " epochs, " << epochs[0].numSats()
+         << " satellites, " << 100.0*missing
+         << "% lacking types; microsec per epoch" << endl
+         << fixed << setprecision(1)
+         << " ComputeDerivative  " << setw(9) << tDeriv*scale << endl
+         << " ComputeElevWeights " << setw(9) << tWeights*scale << endl
+         << " DetectCSMW         " << setw(9) << tCSMW*scale << endl
+         << " getValue/catch     " << setw(9) << tCatch*scale << endl
+         << " tryGet             " << setw(9) << tTry*scale << endl
+         << " satellites kept by DetectCSMW " << numSats
+         << ", check " << (sumCatch == sumTry ? "ok" : "FAILED") << endl;
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+/**
+ *  Function:
+ *  benchmark of the preprocessing of the observables, on simulated epochs
+ *  of GPS, GLONASS, Galileo and BDS satellites with some zero values and
+ *  some codes out of bounds. It times KeepSystems, FilterCode, ConvertObs
+ *  and RequiredObs one after the other against PreprocessObs, and checks
+ *  that both give the same data, satTypes and satShortTypes.
+ *
+ *  Usage: preprocess_bench [numberOfEpochs]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+#include "Counter.hpp"
+#include "EpochArena.hpp"
+#include "DataStructures.hpp"
+#include "Rx3ObsData.hpp"
+#include "ChooseOptimalTypes.hpp"
+#include "KeepSystems.hpp"
+#include "FilterCode.hpp"
+#include "ConvertObs.hpp"
+#include "RequiredObs.hpp"
+#include "PreprocessObs.hpp"
+
+using namespace std;
+using namespace timeSpace;
+using namespace gnssSpace;
+using namespace utilSpace;
+
+// observation types of the header of each system
+static SysTypesMap simulateHeader()
+{
+    const char* gpsTypes[] = { "C1CG", "L1CG", "D1CG", "S1CG",
+                               "C2WG", "L2WG", "D2WG", "S2WG",
+                               "C5QG", "L5QG", "D5QG", "S5QG" };
+    const char* gloTypes[] = { "C1CR", "L1CR", "D1CR", "S1CR",
+                               "C2CR", "L2CR", "D2CR", "S2CR" };
+    const char* galTypes[] = { "C1CE", "L1CE", "D1CE", "S1CE",
+                               "C5QE", "L5QE", "D5QE", "S5QE",
+                               "C7QE", "L7QE", "D7QE", "S7QE" };
+    const char* bdsTypes[] = { "C2IC", "L2IC", "D2IC", "S2IC",
+                               "C6IC", "L6IC", "D6IC", "S6IC",
+                               "C7IC", "L7IC", "D7IC", "S7IC" };
+
+    SysTypesMap mapObsTypes;
+    for(int i=0; i<12; i++) mapObsTypes["G"].push_back(TypeID(gpsTypes[i]));
+    for(int i=0; i<8;  i++) mapObsTypes["R"].push_back(TypeID(gloTypes[i]));
+    for(int i=0; i<12; i++) mapObsTypes["E"].push_back(TypeID(galTypes[i]));
+    for(int i=0; i<12; i++) mapObsTypes["C"].push_back(TypeID(bdsTypes[i]));
+
+    return mapObsTypes;
+}
+
+// one epoch, every type of the header for each satellite, some of them
+// zero and some codes out of bounds
+static void simulate( int k, SysTypesMap& mapObsTypes,
+                      satTypeValueMap& stvData )
+{
+    stvData.clear();
+
+    const char* sysChars = "GREC";
+    const int numSats[] = { 32, 24, 28, 45 };
+
+    for(int s=0; s<4; s++)
+    {
+        const TypeIDVec& types( mapObsTypes[string(1, sysChars[s])] );
+        char sysChar(sysChars[s]);
+
+        for(int j=0; j<numSats[s]; j++)
+        {
+            SatelliteSystem sys;
+            sys.fromChar(sysChar);
+            SatID sat(j+1, sys.system);
+
+            typeValueMap& tv(stvData[sat]);
+            for(size_t i=0; i<types.size(); i++)
+            {
+                int n( (j*31 + i*7 + k) % 97 );
+                double value( 2.2e7 + 1.e4*j + 10.0*i + 0.01*k );
+                if(n == 0)      value = 0.0;
+                else if(n == 1) value = 5.e7;
+                tv[types[i]] = value;
+            }
+        }
+    }
+}
+
+static bool sameData( const Rx3ObsData& a, const Rx3ObsData& b )
+{
+    if(a.stvData.size() != b.stvData.size()) return false;
+    for(satTypeValueMap::const_iterator ita = a.stvData.begin(),
+                                        itb = b.stvData.begin();
+        ita != a.stvData.end();
+        ++ita, ++itb)
+    {
+        if( !((*ita).first == (*itb).first) ) return false;
+        if( (*ita).second.size() != (*itb).second.size() ) return false;
+        for(typeValueMap::const_iterator ta = (*ita).second.begin(),
+                                         tb = (*itb).second.begin();
+            ta != (*ita).second.end();
+            ++ta, ++tb)
+        {
+            if( (*ta).first != (*tb).first ) return false;
+            if( (*ta).second != (*tb).second ) return false;
+        }
+    }
+
+    return ( a.satTypes == b.satTypes &&
+             a.satShortTypes == b.satShortTypes );
+}
+
+int main(int argc, char *argv[])
+{
+    int nEpochs(argc > 1 ? atoi(argv[1]) : 2000);
+
+    SysTypesMap mapObsTypes( simulateHeader() );
+
+    ChooseOptimalTypes chooseOptimalTypes;
+    SysTypesMap sysPrioriTypes = chooseOptimalTypes.get(mapObsTypes);
+
+    std::vector<satTypeValueMap> epochs(nEpochs);
+    for(int k=0; k<nEpochs; k++)
+        simulate(k, mapObsTypes, epochs[k]);
+
+    string system("GEC");
+
+    KeepSystems keepSystems(system);
+    FilterCode filterCode;
+    ConvertObs convertObs;
+    convertObs.setSysPrioriTypes(sysPrioriTypes);
+    RequiredObs reqObs;
+
+    PreprocessObs preprocessObs(system);
+    preprocessObs.setSysPrioriTypes(sysPrioriTypes);
+
+    SatelliteSystem::Systems reqSys[] = { SatelliteSystem::GPS,
+                                          SatelliteSystem::GPS,
+                                          SatelliteSystem::Galileo,
+                                          SatelliteSystem::Galileo,
+                                          SatelliteSystem::BDS,
+                                          SatelliteSystem::BDS };
+    TypeID reqTypes[] = { TypeID::C1G, TypeID::C2G, TypeID::C1E,
+                          TypeID::C5E, TypeID::C2C, TypeID::C6C };
+    for(int i=0; i<6; i++)
+    {
+        reqObs.addRequiredType(SatelliteSystem(reqSys[i]), reqTypes[i]);
+        preprocessObs.addRequiredType(SatelliteSystem(reqSys[i]), reqTypes[i]);
+    }
+
+    // satTypes and satShortTypes are kept from one epoch to the next, as
+    // when reading a file
+    Rx3ObsData chainData, fusedData;
+
+    double tChain(0.0), tFused(0.0);
+    size_t numSats(0);
+    bool same(true);
+    for(int k=0; k<nEpochs; k++)
+    {
+        chainData.stvData = epochs[k];
+        double c0(Counter::now());
+        keepSystems.Process(chainData);
+        filterCode.Process(mapObsTypes, chainData);
+        convertObs.Process(chainData);
+        reqObs.Process(chainData.stvData);
+        tChain += Counter::now() - c0;
+
+        fusedData.stvData = epochs[k];
+        c0 = Counter::now();
+        preprocessObs.Process(mapObsTypes, fusedData);
+        tFused += Counter::now() - c0;
+
+        numSats += fusedData.stvData.numSats();
+        if( !sameData(chainData, fusedData) ) same = false;
+
+        EpochArena::local().reset();
+    }
+
+    double scale(1.e6/nEpochs);
+    cout << nEpochs << " epochs, " << epochs[0].numSats()
+         << " satellites; microsec per epoch" << endl
+         << fixed << setprecision(1)
+         << " KeepSystems+FilterCode+ConvertObs+RequiredObs "
+         << setw(9) << tChain*scale << endl
+         << " PreprocessObs                                 "
+         << setw(9) << tFused*scale << endl
+         << " satellites kept " << numSats
+         << ", check " << (same ? "ok" : "FAILED") << endl;
+
+    return 0;
+}
@@ -16,6 +16,7 @@
 
 // File
 #include "ConfigReader.hpp"
+#include "EpochArena.hpp"
 #include "Rx3NavStore.hpp"
 #include "Rx3ObsData.hpp"
 #include "ChooseOptimalTypes.hpp"
@@ -32,6 +33,7 @@
 #include "PrintSols.hpp"
 #include "DumpRinex.hpp"
 #include "RequiredObs.hpp"
+#include "PreprocessObs.hpp"
 #include "LinearCombinations.hpp"
 #include "ComputeCombination.hpp"
 #include "ComputeElevWeights.hpp"
@@ -41,6 +43,8 @@
 #include "LsqRTK.hpp"
 #include "DeltaOp.hpp"
 #include "ComputePrefit.hpp"
+#include "EpochBinFile.hpp"
+#include "ProcessingPipeline.hpp"
 
 #define debug 0
 
@@ -48,6 +52,54 @@ using namespace std;
 using namespace gnssSpace;
 using namespace utilSpace;
 
+// print the float and fixed solutions of an epoch
+static void printRTKSols( std::ofstream& outStream,
+                          const CommonTime& currEpoch,
+                          const LsqRTK& lsqRTK,
+                          const Triple& rcvPosRover,
+                          const Triple& rcvPosBase )
+{
+    Triple dxTriple = lsqRTK.getDx();
+    Triple dxFixTriple = lsqRTK.getDxFixed();
+
+    if(abs(dxTriple[0])<10){
+        outStream<<
+                 "OSS"<<" "<<
+                 currEpoch<<" "<<
+                 dxTriple[0]<<" "<<
+                 dxTriple[1]<<" "<<
+                 dxTriple[2]<<" "<<endl;
+
+        dxTriple = dxTriple + rcvPosRover - rcvPosBase;
+
+        outStream<<
+                 "SSS"<<" "<<
+                 currEpoch<<" "<<
+                 dxTriple[0]<<" "<<
+                 dxTriple[1]<<" "<<
+                 dxTriple[2]<<" "<<endl;
+
+        dxFixTriple = dxFixTriple + rcvPosRover - rcvPosBase;
+
+        outStream<<
+                 "ISS"<<" "<<
+                 currEpoch<<" "<<
+                 dxFixTriple[0]<<" "<<
+                 dxFixTriple[1]<<" "<<
+                 dxFixTriple[2]<<" "<<
+                 lsqRTK.getIsFixed()<<" "<<endl;
+
+    }else{
+        outStream<<
+                 "ESS"<<" "<<
+                 currEpoch<<" "<<
+                 dxTriple[0]<<" "<<
+                 dxTriple[1]<<" "<<
+                 dxTriple[2]<<" "<<endl;
+
+    }
+}
+
 int main(int argc,char* argv[]) 
 {
     string helpInfo
@@ -64,6 +116,11 @@ int main(int argc,char* argv[])
     "optional options:\n"
     "  --help                        Prints this help \n"
     "  --outputFile <out_file>       output file name \n"
+    "  --dumpFile <bin_file>         write the rover data going into the solver \n"
+    "  --replayFile <bin_file>       read the data written with --dumpFile \n"
+    "                                and feed it to the solver; only the headers\n"
+    "                                of the obs files are read, and --navFile \n"
+    "                                is not needed \n"
     "\n"
     "Examples: "
     "   \n"
@@ -88,6 +145,8 @@ int main(int argc,char* argv[])
     OptionAttribute navAttribute(1, 1);
     OptionAttribute outAttribute(1, 0);
     OptionAttribute baseXYZAttribute(0, 0);
+    OptionAttribute dumpAttribute(1, 0);
+    OptionAttribute replayAttribute(1, 0);
     OptionAttribute helpAttribute(0, 0);
 
     /// define and insert
@@ -96,6 +155,8 @@ int main(int argc,char* argv[])
     optAttData["--baseXYZ"] = baseXYZAttribute;
     optAttData["--navFile"] = navAttribute;
     optAttData["--outputFile"] = outAttribute;
+    optAttData["--dumpFile"] = dumpAttribute;
+    optAttData["--replayFile"] = replayAttribute;
     optAttData["--help"] = helpAttribute;
 
     ///prase the options
@@ -106,6 +167,20 @@ int main(int argc,char* argv[])
     string roverObsFile;
     std::vector<string> navFileVec;
     string outputFile;
+    string dumpFile;
+    string replayFile;
+
+    ///--dumpFile
+    if (optValData.find("--dumpFile") != optValData.end())
+    {
+        dumpFile = optValData["--dumpFile"][0];
+    }
+
+    ///--replayFile
+    if (optValData.find("--replayFile") != optValData.end())
+    {
+        replayFile = optValData["--replayFile"][0];
+    }
 
     ///--baseObsFile
     if (optValData.find("--baseObsFile") != optValData.end())
@@ -133,7 +208,7 @@ int main(int argc,char* argv[])
     if (optValData.find("--navFile") != optValData.end())
     {
         navFileVec = optValData["--navFile"];
-    } else
+    } else if (replayFile.empty())
     {
         cerr << "--ephFile is required!" << endl;
         exit(-1);
@@ -298,6 +373,66 @@ int main(int argc,char* argv[])
     Triple rcvPosBase = rxHeaderBase.antennaPosition;
     rxDataBase.pHeader = &rxHeaderBase;
 
+    //===============================================================
+    // replay: the rover data written with --dumpFile go straight to
+    // the solver
+    //===============================================================
+    if (!replayFile.empty())
+    {
+        EpochBinReader epochReader;
+        try
+        {
+            epochReader.open(replayFile);
+        }
+        catch (Exception &e)
+        {
+            cerr << e << endl;
+            exit(-1);
+        }
+
+        std::ofstream outStream(outputFile.c_str(), ios::out);
+        if(!outStream.is_open())
+        {
+            cerr << "can't open sppOutFile!" << endl;
+            exit(-1);
+        }
+
+        LsqRTK lsqRTK;
+        lsqRTK.setSource(rxHeaderRover.markerName);
+
+        SourceID source;
+
+        while (true)
+        {
+            EpochArena::local().reset();
+
+            try
+            {
+                epochReader.read( rxDataRover.currEpoch, source,
+                                  rcvPosRover, rxDataRover.stvData );
+            }
+            catch (EndOfFile &e)
+            {
+                break;
+            }
+            catch (Exception &e)
+            {
+                cerr << e << endl;
+                exit(-1);
+            }
+
+            lsqRTK.Process(rxDataRover);
+
+            printRTKSols( outStream, rxDataRover.currEpoch, lsqRTK,
+                          rcvPosRover, rcvPosBase );
+        }
+
+        outStream.close();
+
+        cout << "end of replaying file:" << replayFile << endl;
+        return 0;
+    }
+
 
     //!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
     // the following classes are for rover and base station;
@@ -333,6 +468,19 @@ int main(int argc,char* argv[])
 //    reqObs.addRequiredType(SatelliteSystem::GLONASS, TypeID::C1R);
 //    reqObs.addRequiredType(SatelliteSystem::GLONASS, TypeID::C2R);
 
+    // KeepSystems, FilterCode, ConvertObs and RequiredObs in one pass,
+    // "preprocessObs" in the chain
+    PreprocessObs preprocessObs(system);
+    preprocessObs.setSysPrioriTypes(sysPrioriTypes);
+    preprocessObs.addRequiredType(SatelliteSystem::GPS,
+                                  reqObs.getRequiredType(SatelliteSystem::GPS));
+    preprocessObs.addRequiredType(SatelliteSystem::GLONASS,
+                                  reqObs.getRequiredType(SatelliteSystem::GLONASS));
+    preprocessObs.addRequiredType(SatelliteSystem::Galileo,
+                                  reqObs.getRequiredType(SatelliteSystem::Galileo));
+    preprocessObs.addRequiredType(SatelliteSystem::BDS,
+                                  reqObs.getRequiredType(SatelliteSystem::BDS));
+
     LinearCombinations linear;
 
     ComputeCombination computeIF;
@@ -456,6 +604,21 @@ int main(int argc,char* argv[])
     LsqRTK lsqRTK;
     lsqRTK.setSource(rxHeaderRover.markerName);
 
+    // rover data going into the solver, for --replayFile
+    EpochBinWriter epochWriter;
+    if (!dumpFile.empty())
+    {
+        try
+        {
+            epochWriter.open(dumpFile);
+        }
+        catch (Exception &e)
+        {
+            cerr << e << endl;
+            exit(-1);
+        }
+    }
+
     /////////// print spp solutions //////////
     std::ofstream outStream(outputFile.c_str(), ios::out);
     if(!outStream.is_open())
@@ -466,9 +629,52 @@ int main(int argc,char* argv[])
 
     PrintSols printSols(outStream);
 
+    // the processing chain, "preprocess" and "model" in spp.conf. The same
+    // chain is run for the rover and the base, so the stages take the
+    // receiver position from modelPos.
+    Triple modelPos;
+
+    ProcessingPipeline preprocess("preprocess");
+    preprocess.registerProcessor("keepSystems", keepSystems);
+    preprocess.registerStage("filterCode",
+        [&](Rx3ObsData& data){ filterCode.Process(data.pHeader->mapObsTypes, data); } );
+    preprocess.registerProcessor("convertObs", convertObs);
+    preprocess.registerProcessor("requiredObs", reqObs);
+    preprocess.registerProcessor("preprocessObs", preprocessObs);
+    preprocess.registerProcessor("computeIF", computeIF);
+
+    // the other stages are what preprocessObs does in one pass
+    preprocess.setDefaultChain("preprocessObs computeIF");
+
+    ProcessingPipeline model("model");
+    model.registerProcessor("computeSatPos", computeSatPos,
+        [&](){ computeSatPos.setRxPos(modelPos); } );
+    model.registerProcessor("computeDerivative", computeDerivative,
+        [&](){ computeDerivative.setCoordinates(modelPos); } );
+    model.registerStage("computeTrop",
+        [&](Rx3ObsData& data)
+        {
+            computeTrop.setAllParameters(data.currEpoch, modelPos);
+            computeTrop.Process(data);
+        } );
+
+    try
+    {
+        preprocess.assemble(confReader, "preprocess");
+        model.assemble(confReader, "model");
+    }
+    catch (Exception &e)
+    {
+        cerr << e << endl;
+        exit(-1);
+    }
+
     // now, let's process gnss data for curret station
     while (true)
     {
+        // memory of the temporaries of the previous epoch
+        EpochArena::local().reset();
+
         ///////////////////////////////////////
         // data processing for rover station
         ///////////////////////////////////////
@@ -488,12 +694,8 @@ int main(int argc,char* argv[])
         if(debug)
             rxDataRover.dump(cout, 1);
 
-        // keep only given system
-        keepSystems.Process(rxDataRover);
-        filterCode.Process(rxHeaderRover.mapObsTypes, rxDataRover);
-        convertObs.Process(rxDataRover);
-        reqObs.Process(rxDataRover);
-        computeIF.Process(rxDataRover);
+        // keep only given system, filter and convert the observables
+        preprocess.Process(rxDataRover);
 
         rxDataRover.stvData.removeSatID(SatID(SatelliteSystem::BDS,6));
 
@@ -516,14 +718,8 @@ int main(int argc,char* argv[])
             iter++;
 
             // 卫星位置的计算与接收机初始坐标无关, 可以把地球自传改正独立出来
-            computeSatPos.setRxPos(rcvPosRover);
-            computeSatPos.Process(rxDataRover);
-
-            computeDerivative.setCoordinates(rcvPosRover);
-            computeDerivative.Process(rxDataRover);
-
-            computeTrop.setAllParameters(currEpoch, rcvPosRover);
-            computeTrop.Process(rxDataRover);
+            modelPos = rcvPosRover;
+            model.Process(rxDataRover);
 
             sppPrefit.Process(rxDataRover);
 
@@ -576,26 +772,16 @@ int main(int argc,char* argv[])
             continue;
         }
 
-        // keep only given system
-        keepSystems.Process(rxDataBase);
-        filterCode.Process(rxHeaderBase.mapObsTypes, rxDataBase);
-        convertObs.Process(rxDataBase);
-        reqObs.Process(rxDataBase);
-        computeIF.Process(rxDataBase);
+        // keep only given system, filter and convert the observables
+        preprocess.Process(rxDataBase);
         if (rxDataBase.numSats() <= 6)
         {
             continue;
         }
 
-        // 卫星位置的计算与接收机初始坐标无关, 可以把地球自传改正独立出来
-        computeSatPos.setRxPos(rcvPosBase);
-        computeSatPos.Process(rxDataBase);
-        // partial
-        computeDerivative.setCoordinates(rcvPosBase);
-        computeDerivative.Process(rxDataBase);
-        // trop 
-        computeTrop.setAllParameters(currEpoch, rcvPosBase);
-        computeTrop.Process(rxDataBase);
+        // satellite positions, partials and trop at the base position
+        modelPos = rcvPosBase;
+        model.Process(rxDataBase);
         // prefit 
 //        sppPrefit.Process(rxDataBase);
 //        computeMW.Process(rxDataBase);
@@ -625,47 +811,15 @@ int main(int argc,char* argv[])
             continue;
         }
 
-        lsqRTK.Process(rxDataRover);
+        if (!dumpFile.empty())
+        {
+            epochWriter.write( currEpoch, SourceID(rxHeaderRover.markerName),
+                               rcvPosRover, rxDataRover.stvData );
+        }
 
-        Triple dxTriple = lsqRTK.getDx();
-        Triple dxFixTriple = lsqRTK.getDxFixed();
-
-        if(abs(dxTriple[0])<10){
-            outStream<<
-                     "OSS"<<" "<<
-                     currEpoch<<" "<<
-                     dxTriple[0]<<" "<<
-                     dxTriple[1]<<" "<<
-                     dxTriple[2]<<" "<<endl;
-
-            dxTriple = dxTriple + rcvPosRover - rcvPosBase;
-
-            outStream<<
-                     "SSS"<<" "<<
-                     currEpoch<<" "<<
-                     dxTriple[0]<<" "<<
-                     dxTriple[1]<<" "<<
-                     dxTriple[2]<<" "<<endl;
-
-            dxFixTriple = dxFixTriple + rcvPosRover - rcvPosBase;
-
-            outStream<<
-                     "ISS"<<" "<<
-                     currEpoch<<" "<<
-                     dxFixTriple[0]<<" "<<
-                     dxFixTriple[1]<<" "<<
-                     dxFixTriple[2]<<" "<<
-                     lsqRTK.getIsFixed()<<" "<<endl;
-
-        }else{
-            outStream<<
-                     "ESS"<<" "<<
-                     currEpoch<<" "<<
-                     dxTriple[0]<<" "<<
-                     dxTriple[1]<<" "<<
-                     dxTriple[2]<<" "<<endl;
+        lsqRTK.Process(rxDataRover);
 
-        }
+        printRTKSols(outStream, currEpoch, lsqRTK, rcvPosRover, rcvPosBase);
 
 
 
@@ -694,6 +848,10 @@ int main(int argc,char* argv[])
     rxStreamBase.close();
     outStream.close();
 
+    // where the time went
+    preprocess.printStats(cout);
+    model.printStats(cout);
+
     cout << "end of processing file:" << outputFile << endl;
     return 0;
 }
@@ -0,0 +1,223 @@
+/**
+ *  Function:
+ *  segmented run of the stateful stages (DetectCSMW, MarkArc, FilterSPP)
+ *  on simulated GPS epochs with cycle slips and data gaps. The session is
+ *  cut into segments processed in parallel, each one with some epochs of
+ *  warm-up, and the stitched results (position corrections of FilterSPP,
+ *  cycle slips found) are compared with those of a sequential run.
+ *
+ *  It also checks the snapshots: the session is run again in two halves,
+ *  the second one starting from the state the first one ended with, and
+ *  must give exactly the results of the sequential run.
+ *
+ *  Usage: segment_bench [numberOfEpochs] [numberOfSegments] [overlap]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+
+#include "Counter.hpp"
+#include "GPSWeekSecond.hpp"
+#include "Rx3ObsData.hpp"
+#include "DetectCSMW.hpp"
+#include "MarkArc.hpp"
+#include "FilterSPP.hpp"
+#include "SegmentedRun.hpp"
+
+using namespace std;
+using namespace timeSpace;
+using namespace gnssSpace;
+using namespace utilSpace;
+
+// uniform noise in [-1, 1], the same on every run
+static double noise(unsigned int& seed)
+{
+    seed = seed*1103515245u + 12345u;
+    return double((seed >> 8) & 0xffff)/32767.5 - 1.0;
+}
+
+// one epoch of 14 GPS satellites: prefits and partials for FilterSPP,
+// MW combination with slips for DetectCSMW, phase types for MarkArc
+static void simulate( int k, Rx3ObsData& data )
+{
+    const int numSats(14);
+    const double interval(30.0);
+    const double lambdaWL(0.861918);
+
+    data.currEpoch = GPSWeekSecond( 2200, 3600.0*24 + k*interval,
+                                    TimeSystem::GPS ).convertToCommonTime();
+    data.stvData.clear();
+    data.satShortTypes.clear();
+
+    unsigned int seed( 7919u*k + 1 );
+    double cdt( 100.0*noise(seed) );
+
+    for(int j=0; j<numSats; j++)
+    {
+        // a gap of 20 epochs for each satellite, at its own time
+        int phase( (k + 241*j) % 1440 );
+        if(phase < 20) continue;
+
+        SatID sat(j+1, SatelliteSystem::GPS);
+
+        double az( 2.0*PI*j/numSats + 1.e-4*k*interval );
+        double el( (20.0 + 50.0*std::abs(std::sin(0.3*j + 5.e-5*k*interval)))
+                   *DEG_TO_RAD );
+        double ux( std::cos(el)*std::cos(az) );
+        double uy( std::cos(el)*std::sin(az) );
+        double uz( std::sin(el) );
+
+        double iono( 2.0 + 1.5*std::sin(1.e-4*k*interval + j) );
+        double geom( -ux*1.0 - uy*(-2.0) - uz*0.5 );
+
+        typeValueMap& tv( data.stvData[sat] );
+        tv[TypeID::dX] = -ux;
+        tv[TypeID::dY] = -uy;
+        tv[TypeID::dZ] = -uz;
+        tv[TypeID::elevation] = el*RAD_TO_DEG;
+        tv[TypeID::prefitC1G] = geom + cdt + iono + 0.3*noise(seed);
+        tv[TypeID::prefitC2G] = geom + cdt + GAMMA_GPS_L1L2*iono
+                                + 0.3*noise(seed);
+
+        // a new ambiguity after each gap and every 500 epochs
+        int arc( (k + 241*j)/1440*3 + (k + 97*j)/500 );
+        tv[TypeID::MW12G] = lambdaWL*(arc%7 - 3 + 0.05*noise(seed));
+
+        data.satShortTypes[sat].push_back(TypeID::L1G);
+        data.satShortTypes[sat].push_back(TypeID::L2G);
+    }
+}
+
+// the stateful stages of the SPP chain
+class SppChain : public SegmentedRun::Chain
+{
+public:
+
+    SppChain()
+    {
+        detectCS.addType(SatelliteSystem::GPS, TypeID::MW12G);
+    }
+
+    virtual void process(Rx3ObsData& data, std::vector<double>& output)
+    {
+        detectCS.Process(data);
+        markArc.Process(data);
+        filterSPP.Process(data);
+
+        int numSlips(0);
+        for(satTypeValueMap::iterator it = data.stvData.begin();
+            it != data.stvData.end();
+            ++it)
+        {
+            const double* pFlag( (*it).second.tryGet(TypeID::CSFlagL1G) );
+            if(pFlag != NULL && *pFlag > 0.0) numSlips++;
+        }
+
+        Triple dx( filterSPP.getDx() );
+        output.push_back(dx[0]);
+        output.push_back(dx[1]);
+        output.push_back(dx[2]);
+        output.push_back(numSlips);
+    }
+
+    virtual void saveState(StateWriter& writer) const
+    {
+        detectCS.saveState(writer);
+        markArc.saveState(writer);
+        filterSPP.saveState(writer);
+    }
+
+    virtual void restoreState(StateReader& reader)
+        noexcept(false)
+    {
+        detectCS.restoreState(reader);
+        markArc.restoreState(reader);
+        filterSPP.restoreState(reader);
+    }
+
+private:
+
+    DetectCSMW detectCS;
+    MarkArc markArc;
+    FilterSPP filterSPP;
+};
+
+int main(int argc, char *argv[])
+{
+    int nEpochs(argc > 1 ? atoi(argv[1]) : 2880);
+    int nSegments(argc > 2 ? atoi(argv[2]) : 8);
+    int overlap(argc > 3 ? atoi(argv[3]) : 120);
+
+    std::vector<Rx3ObsData> epochs(nEpochs);
+    for(int k=0; k<nEpochs; k++)
+        simulate(k, epochs[k]);
+
+    SegmentedRun::EpochFunction loadEpoch =
+        [&](size_t i, Rx3ObsData& data)
+        {
+            data.currEpoch = epochs[i].currEpoch;
+            data.stvData = epochs[i].stvData;
+            data.satShortTypes = epochs[i].satShortTypes;
+        };
+
+    SegmentedRun segRun;
+    segRun.setChainFactory( []() { return new SppChain; } )
+          .setEpochs(nEpochs, loadEpoch)
+          .setSegments(nSegments)
+          .setOverlap(overlap)
+          .setTolerance(1.e-9);
+
+    double c0(Counter::now());
+    segRun.runSequential();
+    double c1(Counter::now());
+    segRun.run();
+    double c2(Counter::now());
+
+    cout << nEpochs << " epochs, " << nSegments << " segments, "
+         << overlap << " epochs of warm-up" << endl
+         << fixed << setprecision(3)
+         << " sequential " << (c1 - c0) << " s, segmented "
+         << (c2 - c1) << " s" << endl;
+
+    segRun.dumpReport(cout);
+
+    // the second half from the state at the end of the first one
+    int half(nEpochs/2);
+
+    SegmentedRun firstHalf;
+    firstHalf.setChainFactory( []() { return new SppChain; } )
+             .setEpochs(half, loadEpoch);
+    firstHalf.run();
+
+    SegmentedRun secondHalf;
+    secondHalf.setChainFactory( []() { return new SppChain; } )
+              .setEpochs( nEpochs - half,
+                          [&](size_t i, Rx3ObsData& data)
+                          { loadEpoch(half + i, data); } )
+              .setInitialState( firstHalf.getFinalState() );
+    secondHalf.run();
+
+    bool same(true);
+    for(int i=0; i<nEpochs-half; i++)
+    {
+        if( secondHalf.getOutput()[i] != segRun.getSequentialOutput()[half+i] )
+            same = false;
+    }
+
+    // and a restored state is saved again as it was
+    SppChain chain;
+    StateReader reader( firstHalf.getFinalState() );
+    chain.restoreState(reader);
+    StateWriter writer;
+    chain.saveState(writer);
+    same = same && reader.atEnd() &&
+           writer.getData() == firstHalf.getFinalState();
+
+    cout << " restart from a snapshot of "
+         << firstHalf.getFinalState().size() << " bytes: "
+         << (same ? "same results" : "FAILED") << endl;
+
+    return 0;
+}
@@ -0,0 +1,284 @@
+/**
+ *  Function:
+ *  test of SatSeriesStore: one day of simulated 30 s epochs of 32 GPS
+ *  satellites, with gaps, is appended with four columns (elevation,
+ *  residual, MW, arc), and
+ *
+ *   - the series read back must be within half the resolution of the
+ *     values appended, with NaN, infinite and too large values missing;
+ *   - the bytes per row of the store are printed;
+ *   - the store written and loaded back must give the same series, and
+ *     go on appending as the original one;
+ *   - files truncated, or with a chunk table or a number of rows which
+ *     don't match the columns, must be rejected with FFStreamError.
+ *
+ *  Usage: series_test [fileName]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+#include "GPSWeekSecond.hpp"
+#include "DataStructures.hpp"
+#include "SatSeriesStore.hpp"
+
+using namespace std;
+using namespace timeSpace;
+using namespace gnssSpace;
+using namespace utilSpace;
+
+static const int numSats(32);
+static const int numEpochs(2880);
+static const double interval(30.0);
+
+static const int numCols(4);
+static const TypeID::ValueType colTypes[numCols] =
+    { TypeID::elevation, TypeID::postfitC1G, TypeID::MW12G, TypeID::satArcL1G };
+static const double colRes[numCols] = { 1.e-3, 1.e-4, 1.e-3, 1.0 };
+
+static CommonTime epochTime(int k)
+{
+    return GPSWeekSecond( 2200, 3600.0*24 + k*interval,
+                          TimeSystem::GPS ).convertToCommonTime();
+}
+
+// simulated values of an epoch; the columns of 'ref' are those expected
+// back, NaN where missing
+static void simulate( int k, satTypeValueMap& stvData,
+                      std::map<SatID, std::vector<double> >& ref )
+{
+    const double nan( std::numeric_limits<double>::quiet_NaN() );
+
+    stvData.clear();
+    for(int j=1; j<=numSats; j++)
+    {
+        if((j + k/300)%5 == 0) continue;     // not in view
+
+        SatID sat(j, SatelliteSystem::GPS);
+        typeValueMap& tv( stvData[sat] );
+
+        double value[numCols];
+        value[0] = 5.0 + 80.0*std::abs(std::sin(0.001*k + j));
+        value[1] = 0.3*std::sin(0.1*k*j) + 0.01*j;
+        value[2] = 12.3 + 0.01*k;
+        value[3] = 1 + k/1000;
+
+        for(int c=0; c<numCols; c++)
+        {
+            tv[colTypes[c]] = value[c];
+        }
+
+        // missing, or values which can't be kept
+        if(k%7 == 0)   { tv.erase(TypeID::MW12G); value[2] = nan; }
+        if(k%97 == 0)  { tv[TypeID::MW12G] = nan; value[2] = nan; }
+        if(k%101 == 0) { tv[TypeID::postfitC1G] =
+                             std::numeric_limits<double>::infinity();
+                         value[1] = nan; }
+        if(k%103 == 0) { tv[TypeID::elevation] = -1.e300; value[0] = nan; }
+
+        std::vector<double>& r( ref[sat] );
+        r.insert(r.end(), value, value + numCols);
+    }
+}
+
+// overwrite 8 bytes of a file
+static void patch(const string& fileName, size_t offset, uint64_t value)
+{
+    fstream strm(fileName.c_str(), ios::in | ios::out | ios::binary);
+    strm.seekp(offset);
+    strm.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// copy the first 'size' bytes of a file
+static void truncate(const string& from, const string& to, size_t size)
+{
+    ifstream in(from.c_str(), ios::binary);
+    std::vector<char> bytes(size);
+    in.read(&bytes[0], size);
+    ofstream out(to.c_str(), ios::binary);
+    out.write(&bytes[0], size);
+}
+
+// whether loading the file is rejected with FFStreamError
+static bool rejected(const string& fileName, const string& what)
+{
+    SatSeriesStore store;
+    bool ok(false);
+    try
+    {
+        store.loadFile(fileName);
+    }
+    catch(FFStreamError& e)
+    {
+        ok = true;
+    }
+    cout << "  " << left << setw(40) << what << right
+         << (ok ? "rejected" : "NOT REJECTED") << endl;
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    string fileName( argc > 1 ? argv[1] : "series_test.col" );
+
+    SatSeriesStore store;
+    for(int c=0; c<numCols; c++)
+    {
+        store.addColumn(colTypes[c], colRes[c]);
+    }
+
+    std::map<SatID, std::vector<double> > ref;
+    satTypeValueMap stvData;
+    for(int k=0; k<numEpochs; k++)
+    {
+        simulate(k, stvData, ref);
+        store.append(epochTime(k), stvData);
+    }
+
+    bool ok(true);
+
+    // values back within half the resolution, and missing as expected
+    size_t rows(0);
+    double maxErr[numCols] = { 0.0, 0.0, 0.0, 0.0 };
+    bool missingOk(true);
+    std::vector<double> times, values;
+    for(std::map<SatID, std::vector<double> >::const_iterator it = ref.begin();
+        it != ref.end();
+        ++it)
+    {
+        const std::vector<double>& r( (*it).second );
+        size_t n( r.size()/numCols );
+        rows += n;
+        if(store.numRows((*it).first) != n) ok = false;
+
+        for(int c=0; c<numCols; c++)
+        {
+            store.getSeries((*it).first, colTypes[c], times, values);
+            for(size_t i=0; i<n; i++)
+            {
+                double expected( r[i*numCols + c] );
+                if(std::isnan(expected) != std::isnan(values[i]))
+                {
+                    missingOk = false;
+                }
+                else if(!std::isnan(expected))
+                {
+                    maxErr[c] = std::max( maxErr[c],
+                                          std::abs(values[i] - expected)
+                                          /colRes[c] );
+                }
+            }
+        }
+    }
+
+    bool roundOk(missingOk);
+    for(int c=0; c<numCols; c++)
+    {
+        if(maxErr[c] > 0.5 + 1.e-6) roundOk = false;
+    }
+    ok = ok && roundOk;
+
+    cout << "SatSeriesStore, " << numEpochs << " epochs of " << numSats
+         << " satellites, " << rows << " rows of time + " << numCols
+         << " columns" << endl;
+    cout << "  largest error (resolutions):";
+    for(int c=0; c<numCols; c++)
+    {
+        cout << " " << TypeID(colTypes[c]) << " " << fixed
+             << setprecision(3) << maxErr[c];
+    }
+    cout << "; missing values " << (missingOk ? "ok" : "WRONG") << endl;
+
+    store.writeFile(fileName);
+    ifstream size(fileName.c_str(), ios::binary | ios::ate);
+    size_t fileSize( size.tellg() );
+    cout << "  memory " << setprecision(1) << double(store.memoryUsed())/rows
+         << " bytes per row, file " << double(fileSize)/rows
+         << " bytes per row" << endl;
+
+    // the store loaded back, and appended to
+    SatSeriesStore loaded;
+    loaded.loadFile(fileName);
+
+    simulate(numEpochs, stvData, ref);
+    store.append(epochTime(numEpochs), stvData);
+    loaded.append(epochTime(numEpochs), stvData);
+
+    bool same( loaded.getSatIDSet() == store.getSatIDSet() );
+    std::vector<double> times2, values2;
+    for(std::map<SatID, std::vector<double> >::const_iterator it = ref.begin();
+        it != ref.end();
+        ++it)
+    {
+        for(int c=0; c<numCols; c++)
+        {
+            store.getSeries((*it).first, colTypes[c], times, values);
+            loaded.getSeries((*it).first, colTypes[c], times2, values2);
+            if(times != times2 || values.size() != values2.size())
+            {
+                same = false;
+                continue;
+            }
+            for(size_t i=0; i<values.size(); i++)
+            {
+                if( values[i] != values2[i] &&
+                    !(std::isnan(values[i]) && std::isnan(values2[i])) )
+                    same = false;
+            }
+        }
+    }
+    ok = ok && same;
+    cout << "  loaded back and appended to: "
+         << (same ? "same series" : "DIFFERENT") << endl;
+
+    // corrupt files, from one of a single satellite and column
+    SatSeriesStore small;
+    small.addColumn(TypeID::elevation, 1.e-3);
+    for(int k=0; k<300; k++)
+    {
+        satTypeValueMap one;
+        one[SatID(1, SatelliteSystem::GPS)][TypeID::elevation] = 10.0 + k;
+        small.append(epochTime(k), one);
+    }
+    string smallName( fileName + ".small" ), badName( fileName + ".bad" );
+    small.writeFile(smallName);
+    ifstream smallStrm(smallName.c_str(), ios::binary | ios::ate);
+    size_t smallSize( smallStrm.tellg() );
+
+    // header (48 bytes), the column, then the satellite: system (1),
+    // PRN (2), rows (8), and its time column: number of chunks (4) and
+    // where they start (8 each)
+    size_t colBytes( 2 + 8 + 2 + TypeID(TypeID::elevation).asString().size() );
+    size_t rowsAt( 48 + colBytes + 2 + 1 + 2 );
+    size_t chunksAt( rowsAt + 8 + 4 );
+
+    cout << "  corrupt files:" << endl;
+
+    truncate(smallName, badName, smallSize/2);
+    ok = rejected(badName, "truncated") && ok;
+
+    truncate(smallName, badName, smallSize);
+    patch(badName, rowsAt, 600);
+    ok = rejected(badName, "more rows than chunks") && ok;
+
+    truncate(smallName, badName, smallSize);
+    patch(badName, rowsAt, 301);
+    ok = rejected(badName, "one row more than the bytes") && ok;
+
+    truncate(smallName, badName, smallSize);
+    patch(badName, chunksAt + 8, 1u << 30);
+    ok = rejected(badName, "chunk past the end of the column") && ok;
+
+    std::remove(smallName.c_str());
+    std::remove(badName.c_str());
+
+    cout << (ok ? "ok" : "FAILED") << endl;
+
+    return ok ? 0 : 1;
+}
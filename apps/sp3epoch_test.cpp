@@ -0,0 +1,170 @@
+/**
+ *  Function:
+ *  test of SP3EpochStore: a simulated SP3EphStore (orbits and clocks
+ *  every 15 min) is tabulated at the epochs of 30 s and of 1 s
+ *  observations, and the satellites are looked up at the transmit times
+ *  of each epoch, as ComputeSatPos does.
+ *
+ *  The lookups must agree with SP3EphStore::getXvt() to below a
+ *  millimeter, and must be the same, bit for bit, whatever their order:
+ *  the epoch expanded from is the nearest one, not the one of the
+ *  request before.
+ *
+ *  Usage: sp3epoch_test [hoursOf1sEpochs]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "Counter.hpp"
+#include "GPSWeekSecond.hpp"
+#include "SP3EphStore.hpp"
+#include "SP3EpochStore.hpp"
+
+using namespace std;
+using namespace timeSpace;
+using namespace gnssSpace;
+using namespace utilSpace;
+
+static const int numSats(8);
+
+// offsets (s) of the transmit times of an epoch
+static const double offsets[2] = { -0.067, -0.135 };
+
+static CommonTime startTime()
+{
+    return GPSWeekSecond(2200, 0.0, TimeSystem::GPS).convertToCommonTime();
+}
+
+// circular orbit (km) of satellite j at t seconds, on 4 planes
+static Triple orbit(int j, double t)
+{
+    const double a(26560.0), n(std::sqrt(398600.4418/(a*a*a))), inc(0.96);
+    const double we(7.2921151467e-5);
+    double u(n*t + 0.7*j), lon(1.5708*(j%4) - we*t);
+    double x(a*std::cos(u)), y(a*std::sin(u)*std::cos(inc));
+    return Triple( x*std::cos(lon) - y*std::sin(lon),
+                   x*std::sin(lon) + y*std::cos(lon),
+                   a*std::sin(u)*std::sin(inc) );
+}
+
+// clock bias (microsec) of satellite j at t seconds
+static double clockBias(int j, double t)
+{
+    return 10.0*(j+1) + 1.e-5*t + 1.e-3*std::sin(t/7200.0 + j);
+}
+
+// one day of 15 min orbits and clocks
+static void simulateSP3(SP3EphStore& sp3Store)
+{
+    CommonTime t0( startTime() );
+    for(int j=0; j<numSats; j++)
+    {
+        SatID sat(j+1, SatelliteSystem::GPS);
+        for(int k=0; k<97; k++)
+        {
+            CommonTime t(t0 + 900.0*k);
+            sp3Store.addPositionData(sat, t, orbit(j, 900.0*k), Triple(0,0,0));
+            sp3Store.addClockBias(sat, t, clockBias(j, 900.0*k));
+        }
+    }
+}
+
+// Look up all satellites at the transmit times of the epochs, in the
+// order of the epochs, or backwards; return the time taken
+static double lookup( XvtStore<SatID>& store,
+                      const vector<CommonTime>& epochs,
+                      bool backwards,
+                      vector<Xvt>& xvts )
+{
+    int nEpoch(epochs.size());
+    xvts.resize(size_t(nEpoch)*numSats*2);
+
+    double t0( Counter::now() );
+    for(int i=0; i<nEpoch; i++)
+    {
+        int k( backwards ? nEpoch-1-i : i );
+        for(int j=0; j<numSats; j++)
+        {
+            SatID sat(j+1, SatelliteSystem::GPS);
+            for(int m=0; m<2; m++)
+            {
+                xvts[(size_t(k)*numSats + j)*2 + m]
+                    = store.getXvt(sat, epochs[k] + offsets[m]);
+            }
+        }
+    }
+    return Counter::now() - t0;
+}
+
+// Check the table against the ephemeris at the given epochs
+static bool check( SP3EphStore& sp3Store, double interval, int numEpochs )
+{
+    vector<CommonTime> epochs;
+    for(int k=0; k<numEpochs; k++)
+    {
+        epochs.push_back( startTime() + 7200.0 + interval*k );
+    }
+
+    SP3EpochStore epochStore;
+    double t0( Counter::now() );
+    epochStore.Prepare(sp3Store, epochs);
+    double tPrepare( Counter::now() - t0 );
+
+    vector<Xvt> direct, forward, backward;
+    double tDirect( lookup(sp3Store, epochs, false, direct) );
+    double tTable( lookup(epochStore, epochs, false, forward) );
+    lookup(epochStore, epochs, true, backward);
+
+    double maxPos(0.0), maxVel(0.0), maxClk(0.0);
+    bool same(true);
+    for(size_t i=0; i<direct.size(); i++)
+    {
+        for(int c=0; c<3; c++)
+        {
+            maxPos = std::max( maxPos,
+                               std::abs(direct[i].x[c] - forward[i].x[c]) );
+            maxVel = std::max( maxVel,
+                               std::abs(direct[i].v[c] - forward[i].v[c]) );
+            if(forward[i].x[c] != backward[i].x[c]) same = false;
+        }
+        maxClk = std::max( maxClk,
+                           std::abs(direct[i].clkbias - forward[i].clkbias) );
+        if(forward[i].clkbias != backward[i].clkbias) same = false;
+    }
+    maxClk *= 299792458.0;
+
+    bool ok( same && maxPos < 1.e-3 && maxClk < 1.e-3 );
+
+    cout.unsetf(ios::floatfield);
+    cout << setw(5) << interval << " s  " << setw(6) << numEpochs
+         << " epochs:  prepare " << fixed << setprecision(4) << tPrepare
+         << " s, lookups " << tDirect << " s direct, " << tTable
+         << " s table" << endl;
+    cout << "     max diff: position " << scientific << setprecision(2)
+         << maxPos << " m, velocity " << maxVel << " m/s, clock "
+         << maxClk << " m; same in both orders: " << (same ? "yes" : "NO")
+         << (ok ? "" : "   FAILED") << endl;
+
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    double hours(argc > 1 ? atof(argv[1]) : 2.0);
+
+    SP3EphStore sp3Store;
+    simulateSP3(sp3Store);
+
+    cout << "SP3EpochStore against SP3EphStore, " << numSats
+         << " satellites" << endl;
+
+    bool ok( check(sp3Store, 30.0, 480) );
+    ok = check(sp3Store, 1.0, int(hours*3600)) && ok;
+
+    return ok ? 0 : 1;
+}
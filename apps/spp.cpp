@@ -10,12 +10,15 @@
 // System
 #include <iostream>
 #include <string>
+#include <sstream>
+#include <deque>
 
 // 命令行参数解析
 #include "OptionUtil.hpp"
 
 // File
 #include "ConfigReader.hpp"
+#include "EpochArena.hpp"
 #include "Rx3NavStore.hpp"
 #include "Rx3ObsData.hpp"
 #include "ChooseOptimalTypes.hpp"
@@ -32,9 +35,14 @@
 #include "PrintSols.hpp"
 #include "DumpRinex.hpp"
 #include "RequiredObs.hpp"
+#include "PreprocessObs.hpp"
 #include "LinearCombinations.hpp"
 #include "ComputeCombination.hpp"
 #include "LsqSPP.hpp"
+#include "SppEngine.hpp"
+#include "EpochBinFile.hpp"
+#include "ProcessingPipeline.hpp"
+#include "EpochExecutor.hpp"
 
 #define debug 0
 
@@ -42,6 +50,47 @@ using namespace std;
 using namespace gnssSpace;
 using namespace utilSpace;
 
+// the "preprocess" chain on its own copy of the processing objects, so
+// that each thread has one
+struct PreprocessChain
+{
+    KeepSystems keepSystems;
+    FilterCode filterCode;
+    ConvertObs convertObs;
+    RequiredObs reqObs;
+    PreprocessObs preprocessObs;
+    ComputeCombination computeIF;
+
+    ProcessingPipeline pipeline;
+
+    PreprocessChain( const KeepSystems& keep,
+                     const FilterCode& filter,
+                     const ConvertObs& convert,
+                     const RequiredObs& required,
+                     const PreprocessObs& preprocess,
+                     const ComputeCombination& combination )
+        : keepSystems(keep), filterCode(filter), convertObs(convert),
+          reqObs(required), preprocessObs(preprocess),
+          computeIF(combination), pipeline("preprocess")
+    {
+        pipeline.registerProcessor("keepSystems", keepSystems);
+        pipeline.registerStage("filterCode",
+            [this](Rx3ObsData& data){ filterCode.Process(data.pHeader->mapObsTypes, data); } );
+        pipeline.registerProcessor("convertObs", convertObs);
+        pipeline.registerProcessor("requiredObs", reqObs);
+        pipeline.registerProcessor("preprocessObs", preprocessObs);
+        pipeline.registerProcessor("computeIF", computeIF);
+
+        // the other stages are what preprocessObs does in one pass
+        pipeline.setDefaultChain("preprocessObs computeIF");
+    }
+
+private:
+
+    // the stages refer to the members
+    PreprocessChain(const PreprocessChain&);
+};
+
 int main(int argc,char* argv[]) 
 {
     string helpInfo
@@ -56,6 +105,10 @@ int main(int argc,char* argv[])
     "optional options:\n"
     "  --help                        Prints this help \n"
     "  --outputFile <out_file>       output file name \n"
+    "  --dumpFile <bin_file>         write the data going into the solver \n"
+    "  --replayFile <bin_file>       read the data written with --dumpFile \n"
+    "                                and feed it to the solver; --obsFile and\n"
+    "                                --navFile are then not needed \n"
     "\n"
     "Examples: "
     "   \n"
@@ -74,12 +127,16 @@ int main(int argc,char* argv[])
     OptionAttribute obsAttribute(1, 0);
     OptionAttribute navAttribute(1, 1);
     OptionAttribute outAttribute(1, 0);
+    OptionAttribute dumpAttribute(1, 0);
+    OptionAttribute replayAttribute(1, 0);
     OptionAttribute helpAttribute(0, 0);
 
     /// define and insert
     optAttData["--obsFile"] = obsAttribute;
     optAttData["--navFile"] = navAttribute;
     optAttData["--outputFile"] = outAttribute;
+    optAttData["--dumpFile"] = dumpAttribute;
+    optAttData["--replayFile"] = replayAttribute;
     optAttData["--help"] = helpAttribute;
 
     ///prase the options
@@ -89,13 +146,27 @@ int main(int argc,char* argv[])
     string obsFile;
     std::vector<string> navFileVec;
     string outputFile;
+    string dumpFile;
+    string replayFile;
+
+    ///--dumpFile
+    if (optValData.find("--dumpFile") != optValData.end())
+    {
+        dumpFile = optValData["--dumpFile"][0];
+    }
+
+    ///--replayFile
+    if (optValData.find("--replayFile") != optValData.end())
+    {
+        replayFile = optValData["--replayFile"][0];
+    }
 
     ///--obsFile
     if (optValData.find("--obsFile") != optValData.end())
     {
         obsFile = optValData["--obsFile"][0];
     }
-    else
+    else if (replayFile.empty())
     {
         cerr << "--obsFile is required!" << endl;
         exit(-1);
@@ -105,7 +176,7 @@ int main(int argc,char* argv[])
     if (optValData.find("--navFile") != optValData.end())
     {
         navFileVec = optValData["--navFile"];
-    } else
+    } else if (replayFile.empty())
     {
         cerr << "--ephFile is required!" << endl;
         exit(-1);
@@ -167,6 +238,96 @@ int main(int argc,char* argv[])
         cout << "end_sod" << end_sod << endl;
     }
 
+    //===============================================================
+    // replay: the data written with --dumpFile go straight to the solver
+    //===============================================================
+    if (!replayFile.empty())
+    {
+        EpochBinReader epochReader;
+        try
+        {
+            epochReader.open(replayFile);
+        }
+        catch (Exception &e)
+        {
+            cerr << e << endl;
+            exit(-1);
+        }
+
+        std::string sppOutFile;
+        sppOutFile = outputFile + ".filter.spp.out";
+
+        std::ofstream sppOutStream(sppOutFile.c_str(), ios::out);
+        if(!sppOutStream.is_open())
+        {
+            cerr << "can't open sppOutFile!" << endl;
+            exit(-1);
+        }
+
+        PrintSols printSppSols(sppOutStream);
+        printSppSols.printHeader();
+
+        LsqSPP lsqSPP;
+        Rx3ObsData rxData;
+        SourceID source;
+        Triple rcvPos;
+
+        // every iteration of an epoch was written, the solution is the
+        // one of the last
+        CommonTime solEpoch;
+        Triple solPos;
+        int solNumSats(0);
+        bool haveSol(false);
+
+        while (true)
+        {
+            EpochArena::local().reset();
+
+            try
+            {
+                epochReader.read(rxData.currEpoch, source, rcvPos, rxData.stvData);
+            }
+            catch (EndOfFile &e)
+            {
+                break;
+            }
+            catch (Exception &e)
+            {
+                cerr << e << endl;
+                exit(-1);
+            }
+
+            if (haveSol && rxData.currEpoch != solEpoch)
+            {
+                printSppSols.printRecord(solEpoch, solNumSats, solPos);
+            }
+
+            try
+            {
+                lsqSPP.setSource(source.sourceName);
+                lsqSPP.Process(rxData);
+            }
+            catch (Exception &e)
+            {
+                cerr << e << endl;
+                exit(-1);
+            }
+
+            solEpoch = rxData.currEpoch;
+            solPos = rcvPos + lsqSPP.getDx();
+            solNumSats = rxData.numSats();
+            haveSol = true;
+        }
+
+        if (haveSol)
+        {
+            printSppSols.printRecord(solEpoch, solNumSats, solPos);
+        }
+
+        cout << "end of replaying file:" << replayFile << endl;
+        return 0;
+    }
+
     ///>now, read nav files
     Rx3NavStore navStore;
 
@@ -192,7 +353,6 @@ int main(int argc,char* argv[])
 
     /// now, let's read data for current satation
     Rx3ObsHeader rxHeader;
-    Rx3ObsData rxData;
 
     std::fstream rxStream(obsFile.c_str(), ios::in);
     if (!rxStream)
@@ -249,9 +409,6 @@ int main(int argc,char* argv[])
         cout << "lastEpoch:" << lastEpoch << endl;
     }
 
-    // set the header pointer to rxData for data reading.
-    rxData.pHeader = &rxHeader;
-
     // keep satellite system for positioning
     KeepSystems keepSystems(system);
 
@@ -272,16 +429,57 @@ int main(int argc,char* argv[])
     ConvertObs convertObs;
     convertObs.setSysPrioriTypes(sysPrioriTypes);
 
+    // required types, "requiredTypes" in spp.conf, the system of each one
+    // given by its name
+    string requiredTypes("C1G C2G C1E C5E C2C C6C C1R C2R");
+    try
+    {
+        requiredTypes = confReader.getValue("requiredTypes");
+    }
+    catch (ConfigurationException &e)
+    {
+        // not configured, keep the default ones
+    }
+
     RequiredObs reqObs;
-    reqObs.addRequiredType(SatelliteSystem::GPS,     TypeID::C1G);
-    reqObs.addRequiredType(SatelliteSystem::GPS,     TypeID::C2G);
-    reqObs.addRequiredType(SatelliteSystem::Galileo, TypeID::C1E);
-    reqObs.addRequiredType(SatelliteSystem::Galileo, TypeID::C5E);
+    try
+    {
+        istringstream typeStrm(requiredTypes);
+        string typeName;
+        while (typeStrm >> typeName)
+        {
+            TypeID type(typeName);
 
-    reqObs.addRequiredType(SatelliteSystem::BDS,     TypeID::C2C);
-    reqObs.addRequiredType(SatelliteSystem::BDS,     TypeID::C6C);
-    reqObs.addRequiredType(SatelliteSystem::GLONASS, TypeID::C1R);
-    reqObs.addRequiredType(SatelliteSystem::GLONASS, TypeID::C2R);
+            char sysChar(systemCharOf(type));
+            if (sysChar == 0)
+            {
+                InvalidType e("requiredTypes: " + typeName + " is of no system");
+                THROW(e);
+            }
+
+            SatelliteSystem sys;
+            sys.fromChar(sysChar);
+            reqObs.addRequiredType(sys, type);
+        }
+    }
+    catch (Exception &e)
+    {
+        cerr << e << endl;
+        exit(-1);
+    }
+
+    // KeepSystems, FilterCode, ConvertObs and RequiredObs in one pass,
+    // "preprocessObs" in the chain
+    PreprocessObs preprocessObs(system);
+    preprocessObs.setSysPrioriTypes(sysPrioriTypes);
+    preprocessObs.addRequiredType(SatelliteSystem::GPS,
+                                  reqObs.getRequiredType(SatelliteSystem::GPS));
+    preprocessObs.addRequiredType(SatelliteSystem::GLONASS,
+                                  reqObs.getRequiredType(SatelliteSystem::GLONASS));
+    preprocessObs.addRequiredType(SatelliteSystem::Galileo,
+                                  reqObs.getRequiredType(SatelliteSystem::Galileo));
+    preprocessObs.addRequiredType(SatelliteSystem::BDS,
+                                  reqObs.getRequiredType(SatelliteSystem::BDS));
 
     LinearCombinations linear;
 
@@ -351,6 +549,20 @@ int main(int argc,char* argv[])
     ComputeTropModel computeTrop;
     computeTrop.setTropModel(neillTM);
 
+    // "tropoCache" in spp.conf: keep the parameters of the tropospheric
+    // model from one iteration and epoch to the next
+    bool tropoCache(false);
+    try
+    {
+        tropoCache = confReader.getValueAsBoolean("tropoCache");
+    }
+    catch (ConfigurationException &e)
+    {
+        // not configured, computed at each call
+    }
+    computeTrop.setCache(tropoCache);
+    computeTrop.setStation(rxHeader.markerName);
+
     if (debug)
     {
         cout << "after define:ComputeTropModel" << endl;
@@ -359,6 +571,38 @@ int main(int argc,char* argv[])
     LsqSPP lsqSPP;
     lsqSPP.setSource(rxHeader.markerName);
 
+    // "sppEngine" in spp.conf: solve the epochs with SppEngine, in place
+    // of the "model" chain and LsqSPP (the iterations are not dumped)
+    bool useEngine(false);
+    try
+    {
+        useEngine = confReader.getValueAsBoolean("sppEngine");
+    }
+    catch (ConfigurationException &e)
+    {
+        // not configured, the "model" chain
+    }
+
+    SppEngine sppEngine(navStore);
+    sppEngine.setTropModel(neillTM)
+             .setTropCache(tropoCache)
+             .setApriori(rcvPos);
+
+    // data going into the solver, for --replayFile
+    EpochBinWriter epochWriter;
+    if (!dumpFile.empty())
+    {
+        try
+        {
+            epochWriter.open(dumpFile);
+        }
+        catch (Exception &e)
+        {
+            cerr << e << endl;
+            exit(-1);
+        }
+    }
+
     /////////// print spp solutions //////////
     std::string sppOutFile;
     sppOutFile = outputFile + ".filter.spp.out";
@@ -375,14 +619,65 @@ int main(int argc,char* argv[])
     PrintSols printSppSols(sppOutStream);
     printSppSols.printHeader();
 
-    // now, let's process gnss data for curret station
-    bool firstTime(true);
-    while (true)
+    // threads for the "preprocess" chain, "threads" in spp.conf
+    int numThreads(1);
+    try
     {
-        try
+        numThreads = confReader.getValueAsInt("threads");
+    }
+    catch (ConfigurationException &e)
+    {
+        // not configured, a single thread
+    }
+    if (numThreads < 1)
+    {
+        numThreads = 1;
+    }
+
+    // the processing chain, "preprocess" and "model" in spp.conf.
+    // "preprocess" only needs the data of the epoch: each thread runs it
+    // on its own copy of the objects, on several epochs at a time.
+    // "model" and the solver need the solution of the epoch before, and
+    // see the epochs in order.
+    std::deque<PreprocessChain> preprocess;
+    for (int i = 0; i < numThreads; i++)
+    {
+        preprocess.emplace_back( keepSystems, filterCode, convertObs,
+                                 reqObs, preprocessObs, computeIF );
+    }
+
+    ProcessingPipeline model("model");
+    model.registerProcessor("computeSatPos", computeSatPos,
+        [&](){ computeSatPos.setRxPos(rcvPos); } );
+    model.registerProcessor("computeDerivative", computeDerivative,
+        [&](){ computeDerivative.setCoordinates(rcvPos); } );
+    model.registerProcessor("computeTrop", computeTrop,
+        [&](){ computeTrop.setAllParameters(firstEpoch, rcvPos); } );
+    model.registerProcessor("prefit", sppPrefit);
+
+    try
+    {
+        for (int i = 0; i < numThreads; i++)
+        {
+            preprocess[i].pipeline.assemble(confReader, "preprocess");
+        }
+        model.assemble(confReader, "model");
+    }
+    catch (Exception &e)
+    {
+        cerr << e << endl;
+        exit(-1);
+    }
+
+    EpochExecutor executor;
+
+    // read data, skipping the records with flag >1
+    // see details in Rx3ObsData or rinex3.04.pdf
+    executor.setReader( [&](Rx3ObsData& rxData)
+    {
+        rxData.pHeader = &rxHeader;
+        while (true)
         {
-            double clock1(Counter::now());
-            // read data
             try
             {
                 rxStream >> rxData;
@@ -390,7 +685,7 @@ int main(int argc,char* argv[])
             catch (EndOfFile &e)
             {
                 cout << "end of file" << endl;
-                break;
+                return false;
             }
 
             if(debug)
@@ -399,162 +694,168 @@ int main(int argc,char* argv[])
                 rxData.dump(cout, 1);
             }
 
-            /// write solution to files
-            CommonTime currEpoch = rxData.currEpoch;
-
-            /// skip record with flag >1
-            /// see details in Rx3ObsData or rinex3.04.pdf
-            if (rxData.epochFlag > 1)
+            if (rxData.epochFlag <= 1)
             {
-                continue;
+                return true;
             }
+        }
+    } );
 
-            if (debug)
+    // keep the systems, filter the codes, convert and check the
+    // observables, and compute the if combinations
+    for (int i = 0; i < numThreads; i++)
+    {
+        ProcessingPipeline* pPreprocess(&preprocess[i].pipeline);
+        executor.addWorker( [pPreprocess](Rx3ObsData& rxData)
+        {
+            pPreprocess->Process(rxData);
+        } );
+    }
+
+    // now, let's process gnss data for curret station
+    bool firstTime(true);
+    executor.setSequential( [&](Rx3ObsData& rxData)
+    {
+        /// write solution to files
+        CommonTime currEpoch = rxData.currEpoch;
+
+        if (debug)
+        {
+            cout << "after preprocess" << endl;
+            rxData.dump(cout, 1);
+        }
+
+        if (rxData.numSats() <= 6)
+        {
+            return;
+        }
+
+        if (useEngine)
+        {
+            try
             {
-                cout << "after obsStrm" << endl;
-                rxData.dump(cout, 1);
+                sppEngine.Process(rxData);
             }
+            catch (SVNumException &e)
+            {
+                return;
+            }
+
+            rcvPos = sppEngine.getRxPos();
+            printSppSols.printRecord(currEpoch, rxData.numSats(), rcvPos);
+            return;
+        }
+
+        //////////////////////////////////////////
+        ///  计算接收机位置初始位置并改正各类系统误差
+        //////////////////////////////////////////
+
+        int iter(0);
+        while (true)
+        {
+            iter++;
 
-            // keep only given system
-            keepSystems.Process(rxData);
             if (debug)
             {
-                cout << "after keepSystems" << endl;
-                rxData.dump(cout, 1);
+                cout << "rcvPos" << endl;
+                cout << rcvPos << endl;
             }
 
-            // filter out outliers
-            filterCode.Process(rxHeader.mapObsTypes, rxData);
+            // satellite positions, derivatives, troposphere and
+            // prefit residuals at the current rcvPos
+            model.Process(rxData);
             if (debug)
             {
-                cout << "after filterCode" << endl;
+                cout << "after model" << endl;
                 rxData.dump(cout, 1);
+                computeSatPos.printTimeUsed(cout);
             }
 
-            convertObs.Process(rxData);
-            if (debug)
+            if (!dumpFile.empty())
             {
-                cout << "after convertObs" << endl;
-                rxData.dump(cout, 1);
+                epochWriter.write( currEpoch, SourceID(rxHeader.markerName),
+                                   rcvPos, rxData.stvData );
             }
 
-            // required obs
-            reqObs.Process(rxData);
+            // compute spp soulution using LSQ
+            lsqSPP.Process(rxData);
 
-            // now, compute if combinations
-            computeIF.Process(rxData);
+            // get dx
+            Triple dxTriple = lsqSPP.getDx();
+            double dxMag = dxTriple.mag();
 
-            if (rxData.numSats() <= 6)
+            // update the receiver solution
+            if(debug)
             {
-                continue;
+                cout << "iter:" << iter << endl;
+                cout << YDSTime(currEpoch) << " dxTriple:" << dxTriple << endl;
+                cout << "dxMag:" << dxMag << endl;
             }
 
-            //////////////////////////////////////////
-            ///  计算接收机位置初始位置并改正各类系统误差
-            //////////////////////////////////////////
+            rcvPos = rcvPos + dxTriple;
 
-            int iter(0);
-            while (true)
+            if(debug)
             {
-                iter++;
-
-                if (debug)
-                {
-                    cout << "rcvPos" << endl;
-                    cout << rcvPos << endl;
-                }
-
-                // 卫星位置的计算与接收机初始坐标无关,
-                // 可以把地球自传改正独立出来
-                computeSatPos.setRxPos(rcvPos);
-                computeSatPos.Process(rxData);
-
-                if (debug)
-                {
-                    cout << "after computeSatPos" << endl;
-                    rxData.dump(cout, 1);
-                    computeSatPos.printTimeUsed(cout);
-                }
-
-                computeDerivative.setCoordinates(rcvPos);
-                computeDerivative.Process(rxData);
-
-                if (debug)
-                {
-                    cout << "after computeDerivative" << endl;
-                    rxData.dump(cout, 1);
-                }
-
-                if (debug)
-                    cout << "firstEpoch:" << firstEpoch << endl;
-
-                computeTrop.setAllParameters(firstEpoch, rcvPos);
-                computeTrop.Process(rxData);
-                if (debug)
-                {
-                    cout << "after computeTrop" << endl;
-                    rxData.dump(cout, 1);
-                }
-
-                // 计算第一次prefit
-                sppPrefit.Process(rxData);
-
-                // compute spp soulution using LSQ
-                lsqSPP.Process(rxData);
-
-                // get dx
-                Triple dxTriple = lsqSPP.getDx();
-                double dxMag = dxTriple.mag();
-
-                // update the receiver solution
-                if(debug)
-                {
-                    cout << "iter:" << iter << endl;
-                    cout << YDSTime(currEpoch) << " dxTriple:" << dxTriple << endl;
-                    cout << "dxMag:" << dxMag << endl;
-                }
-
-                rcvPos = rcvPos + dxTriple;
-
-                if(debug)
-                {
-                    cout << "update rcvPos:" << rcvPos << endl;
-                }
-
-                // convergence threshold
-                if(dxMag < 0.01)
-                {
-                    break;
-                }
-
-                if(iter>5)
-                {
-                    break;
-                }
+                cout << "update rcvPos:" << rcvPos << endl;
             }
 
+            // convergence threshold
+            if(dxMag < 0.01)
+            {
+                break;
+            }
 
-            // here is the spp solutions
-            printSppSols.printRecord(currEpoch, rxData.numSats(), rcvPos);
-
-            // 必须放在最后，如果有任何异常，比如卫星号小于４颗，
-            // 则不能到这里，那么还需要保留firstTime
-            // reset firstTime
-            if(firstTime)
+            if(iter>5)
             {
-                firstTime = false;
+                break;
             }
         }
-        catch (Exception &e)
+
+
+        // here is the spp solutions
+        printSppSols.printRecord(currEpoch, rxData.numSats(), rcvPos);
+
+        // 必须放在最后，如果有任何异常，比如卫星号小于４颗，
+        // 则不能到这里，那么还需要保留firstTime
+        // reset firstTime
+        if(firstTime)
         {
-            cerr << e << endl;
-            exit(-1);
+            firstTime = false;
         }
+    } );
+
+    try
+    {
+        executor.run();
+    }
+    catch (Exception &e)
+    {
+        cerr << e << endl;
+        exit(-1);
     }
 
     // close streams
     rxStream.close();
 
+    // where the time went, over all the threads
+    for (int i = 1; i < numThreads; i++)
+    {
+        preprocess[0].pipeline.addStats(preprocess[i].pipeline);
+    }
+    preprocess[0].pipeline.printStats(cout);
+    if (useEngine)
+    {
+        sppEngine.dumpStats(cout);
+    }
+    else
+    {
+        model.printStats(cout);
+        if (tropoCache)
+        {
+            computeTrop.dumpCacheStats(cout);
+        }
+    }
+
     cout << "end of processing file:" << outputFile << endl;
     return 0;
 }
@@ -0,0 +1,341 @@
+/**
+ *  Function:
+ *  benchmark of SppEngine against the SPP loop of spp (ComputeSatPos,
+ *  ComputeDerivative, ComputeTropModel, prefit ComputeCombination and
+ *  LsqSPP at each iteration), with simulated GPS stations. Both start
+ *  each epoch from the solution of the one before; the solutions must
+ *  agree within a millimeter. The iterations per epoch and the time of
+ *  both are printed.
+ *
+ *  SppEngine is run again with the troposphere cache on, and its
+ *  solutions must stay within a centimeter.
+ *
+ *  Usage: spp_engine_bench [numberOfStations]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <map>
+
+#include "Counter.hpp"
+#include "GPSWeekSecond.hpp"
+#include "Rx3NavStore.hpp"
+#include "Rx3ObsData.hpp"
+#include "LinearCombinations.hpp"
+#include "ComputeCombination.hpp"
+#include "ComputeSatPos.hpp"
+#include "ComputeDerivative.hpp"
+#include "ComputeTropModel.hpp"
+#include "TropModel.hpp"
+#include "LsqSPP.hpp"
+#include "SppEngine.hpp"
+
+using namespace std;
+using namespace timeSpace;
+using namespace gnssSpace;
+using namespace utilSpace;
+
+static const int numSats(24);
+static const double interval(30.0);
+
+// GPS time of epoch k
+static CommonTime epochTime(int k)
+{
+    return GPSWeekSecond( 2200, 3600.0*24 + k*interval,
+                          TimeSystem::GPS ).convertToCommonTime();
+}
+
+// uniform noise in [-1, 1], the same on every run
+static double noise(unsigned int& seed)
+{
+    seed = seed*1103515245u + 12345u;
+    return double((seed >> 8) & 0xffff)/32767.5 - 1.0;
+}
+
+// 24 satellites on 6 planes, an ephemeris every 2 hours
+static void simulateNav(Rx3NavStore& navStore)
+{
+    for(int j=0; j<numSats; j++)
+    {
+        SatID sat(j+1, SatelliteSystem::GPS);
+        int plane(j/4), slot(j%4);
+
+        for(int h=0; h<=6; h+=2)
+        {
+            GPSEphemeris eph;
+            eph.satID = sat;
+            eph.ctToe = GPSWeekSecond( 2200, 3600.0*(24 + h),
+                                       TimeSystem::GPS ).convertToCommonTime();
+            eph.ctToc = eph.ctToe;
+            eph.Toe = eph.Toc = 3600.0*(24 + h);
+            eph.GPSWeek = 2200;
+
+            eph.sqrt_A = 5153.7;
+            eph.ecc = 0.005 + 0.001*slot;
+            eph.i0 = 55.0*DEG_TO_RAD;
+            eph.OMEGA_0 = plane*60.0*DEG_TO_RAD;
+            eph.OMEGA_DOT = -8.0e-9;
+            eph.omega = 0.1*j;
+            eph.M0 = (slot*90.0 + plane*15.0)*DEG_TO_RAD
+                     + 1.4585e-4*3600.0*h;
+            eph.Delta_n = eph.IDOT = 0.0;
+            eph.Cuc = eph.Cus = eph.Crc = eph.Crs = eph.Cic = eph.Cis = 0.0;
+
+            eph.af0 = 1.e-5*(j%7 - 3);
+            eph.af1 = 1.e-12*(j%3 - 1);
+            eph.af2 = 0.0;
+            eph.TGD = 0.0;
+
+            navStore.gpsEphData[sat][eph.ctToe] = eph;
+        }
+        navStore.satTable.push_back(sat);
+    }
+}
+
+// position of station i
+static Triple stationPos(int i)
+{
+    double lat( (-60.0 + 120.0*((i*37)%17)/16.0)*DEG_TO_RAD );
+    double lon( (i*97 % 360)*DEG_TO_RAD );
+    double r(6378137.0 - 21385.0*std::sin(lat)*std::sin(lat) + 100.0*(i%5));
+    return Triple( r*std::cos(lat)*std::cos(lon),
+                   r*std::cos(lat)*std::sin(lon),
+                   r*std::sin(lat) );
+}
+
+// number of epochs of station i: the stations are of different lengths
+static int stationEpochs(int i)
+{
+    return 120 + 40*(i%5);
+}
+
+// C1G and C2G of the visible satellites at epoch k for station i
+static void simulateObs( Rx3NavStore& navStore, int i, int k,
+                         Rx3ObsData& data )
+{
+    Triple rx( stationPos(i) );
+    double rxMag( rx.mag() );
+
+    data.currEpoch = epochTime(k);
+    data.stvData.clear();
+
+    unsigned int seed( 7919u*k + 104729u*i + 1 );
+    double cdt( 3000.0*noise(seed) );
+
+    for(int j=0; j<numSats; j++)
+    {
+        SatID sat(j+1, SatelliteSystem::GPS);
+
+        double tau(0.075), rho(0.0);
+        Xvt xvt;
+        Triple sv;
+        for(int iter=0; iter<3; iter++)
+        {
+            CommonTime tt(data.currEpoch);
+            tt -= tau;
+            xvt = navStore.getXvt(sat, tt);
+
+            double wt( OMEGA_EARTH*tau );
+            sv = Triple( xvt.x[0]*std::cos(wt) + xvt.x[1]*std::sin(wt),
+                        -xvt.x[0]*std::sin(wt) + xvt.x[1]*std::cos(wt),
+                         xvt.x[2] );
+            rho = (sv - rx).mag();
+            tau = rho/C_MPS;
+        }
+
+        double sinEl( (sv - rx).dot(rx)/(rho*rxMag) );
+        if(sinEl < std::sin(10.0*DEG_TO_RAD)) continue;
+
+        double tropo( 2.4/sinEl );
+        double iono( (2.0 + 0.1*(j%5))/sinEl );
+        double clk( C_MPS*(xvt.clkbias + xvt.relcorr) );
+
+        typeValueMap& tv( data.stvData[sat] );
+        tv[TypeID::C1G] = rho + cdt - clk + tropo + iono + 0.3*noise(seed);
+        tv[TypeID::C2G] = rho + cdt - clk + tropo + GAMMA_GPS_L1L2*iono
+                          + 0.3*noise(seed);
+    }
+}
+
+// the SPP loop of spp, one solution per epoch
+static double runChain( Rx3NavStore& navStore,
+                        const LinearCombinations& linear, int i,
+                        std::vector<Triple>& solutions,
+                        std::map<int, int>& iterStats )
+{
+    ComputeCombination computeIF;
+    computeIF.addLinear(SatelliteSystem::GPS, linear.pc12CombOfGPS);
+
+    gnssLinearCombination c1PrefitOfGPS = linear.c1PrefitOfGPS;
+    gnssLinearCombination c2PrefitOfGPS = linear.c2PrefitOfGPS;
+    c1PrefitOfGPS.addOptionalType(TypeID::gravDelay);
+    c2PrefitOfGPS.addOptionalType(TypeID::gravDelay);
+
+    ComputeCombination sppPrefit;
+    sppPrefit.addLinear(SatelliteSystem::GPS, c1PrefitOfGPS);
+    sppPrefit.addLinear(SatelliteSystem::GPS, c2PrefitOfGPS);
+
+    ComputeSatPos computeSatPos(navStore);
+    ComputeDerivative computeDerivative;
+
+    NeillTropModel neillTM;
+    ComputeTropModel computeTrop;
+    computeTrop.setTropModel(neillTM);
+
+    LsqSPP lsqSPP;
+
+    Triple rcvPos( stationPos(i) + Triple(100.0, -100.0, 50.0) );
+
+    Rx3ObsData rxData;
+    int nEpochs( stationEpochs(i) );
+    solutions.assign(nEpochs, Triple());
+
+    double seconds(0.0);
+    for(int k=0; k<nEpochs; k++)
+    {
+        simulateObs(navStore, i, k, rxData);
+
+        double begin( Counter::now() );
+
+        computeIF.Process(rxData);
+        if(rxData.numSats() <= 6) continue;
+
+        int iter(0);
+        while(iter < 6)
+        {
+            computeSatPos.setRxPos(rcvPos);
+            computeSatPos.Process(rxData);
+            computeDerivative.setCoordinates(rcvPos);
+            computeDerivative.Process(rxData);
+            computeTrop.setAllParameters(rxData.currEpoch, rcvPos);
+            computeTrop.Process(rxData);
+            sppPrefit.Process(rxData);
+
+            lsqSPP.Process(rxData);
+
+            Triple dx( lsqSPP.getDx() );
+            rcvPos = rcvPos + dx;
+            iter++;
+            if(dx.mag() < 0.01) break;
+        }
+
+        seconds += Counter::now() - begin;
+
+        solutions[k] = rcvPos;
+        iterStats[iter]++;
+    }
+
+    return seconds;
+}
+
+// the same epochs with SppEngine
+static double runEngine( Rx3NavStore& navStore,
+                         const LinearCombinations& linear, int i,
+                         std::vector<Triple>& solutions,
+                         SppEngine& engine )
+{
+    ComputeCombination computeIF;
+    computeIF.addLinear(SatelliteSystem::GPS, linear.pc12CombOfGPS);
+
+    NeillTropModel neillTM;
+    engine.setTropModel(neillTM)
+          .setApriori( stationPos(i) + Triple(100.0, -100.0, 50.0) );
+
+    Rx3ObsData rxData;
+    int nEpochs( stationEpochs(i) );
+    solutions.assign(nEpochs, Triple());
+
+    double seconds(0.0);
+    for(int k=0; k<nEpochs; k++)
+    {
+        simulateObs(navStore, i, k, rxData);
+
+        double begin( Counter::now() );
+
+        computeIF.Process(rxData);
+        if(rxData.numSats() <= 6) continue;
+
+        engine.Process(rxData);
+
+        seconds += Counter::now() - begin;
+
+        solutions[k] = engine.getRxPos();
+    }
+
+    return seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    int nStations(argc > 1 ? atoi(argv[1]) : 4);
+
+    Rx3NavStore navStore;
+    simulateNav(navStore);
+
+    const LinearCombinations linear;
+
+    SppEngine engine(navStore);
+    std::map<int, int> chainStats;
+
+    SppEngine cachedEngine(navStore);
+    cachedEngine.setTropCache(true);
+
+    double chainSeconds(0.0), engineSeconds(0.0), cachedSeconds(0.0);
+    double maxDiff(0.0), maxErr(0.0), maxCachedDiff(0.0);
+    int numSols(0);
+
+    for(int i=0; i<nStations; i++)
+    {
+        std::vector<Triple> chainSols, engineSols, cachedSols;
+        chainSeconds += runChain(navStore, linear, i, chainSols, chainStats);
+        engineSeconds += runEngine(navStore, linear, i, engineSols, engine);
+        cachedSeconds += runEngine( navStore, linear, i, cachedSols,
+                                    cachedEngine );
+
+        for(size_t k=0; k<chainSols.size(); k++)
+        {
+            // epochs without solution are left at zero
+            if(chainSols[k].mag() == 0.0) continue;
+            numSols++;
+            maxDiff = std::max(maxDiff, (engineSols[k] - chainSols[k]).mag());
+            maxErr = std::max(maxErr, (engineSols[k] - stationPos(i)).mag());
+            maxCachedDiff = std::max( maxCachedDiff,
+                                      (cachedSols[k] - chainSols[k]).mag() );
+        }
+    }
+
+    cout << " SPP loop" << endl;
+    cout << " iterations    epochs" << endl;
+    for(std::map<int, int>::const_iterator it = chainStats.begin();
+        it != chainStats.end();
+        ++it)
+    {
+        cout << setw(11) << (*it).first << setw(10) << (*it).second << endl;
+    }
+
+    cout << " SppEngine" << endl;
+    engine.dumpStats(cout);
+
+    cout << " SppEngine, troposphere cache" << endl;
+    cachedEngine.dumpStats(cout);
+
+    cout << " " << nStations << " stations, " << numSols << " solutions"
+         << endl
+         << " SPP loop  " << fixed << setprecision(3) << chainSeconds
+         << " s, " << setprecision(1) << 1.e6*chainSeconds/numSols
+         << " us/epoch" << endl
+         << " SppEngine " << setprecision(3) << engineSeconds
+         << " s, " << setprecision(1) << 1.e6*engineSeconds/numSols
+         << " us/epoch" << endl
+         << " SppEngine, troposphere cache " << setprecision(3)
+         << cachedSeconds << " s, " << setprecision(1)
+         << 1.e6*cachedSeconds/numSols << " us/epoch" << endl
+         << " largest difference " << scientific << setprecision(2)
+         << maxDiff << " m (" << maxCachedDiff << " m with the cache),"
+         << " largest position error " << fixed << maxErr << " m" << endl;
+
+    return ( numSols > 0 && maxDiff < 1.e-3 && maxCachedDiff < 0.01 &&
+             maxErr < 20.0 ) ? 0 : 1;
+}
@@ -37,7 +37,7 @@ namespace gnssSpace
    // according to PRANGE(2017), the priority order of the observed signals with a high 
    // availability are preferred (except GPS C1C)
 
-   stringCharStringMap ChooseOptimalTypes::priorityCodes = ChooseOptimalTypes::init();
+   const stringCharStringMap ChooseOptimalTypes::priorityCodes = ChooseOptimalTypes::init();
    
    // initialize
    stringCharStringMap ChooseOptimalTypes::init()
@@ -119,7 +119,15 @@ namespace gnssSpace
 
                 string sysStr = (*sysTypeIter).first;
 
-                std::map<char, std::string> bandCodes = priorityCodes[sysStr];
+                // a system without priority codes has no optimal types
+                stringCharStringMap::const_iterator pc( priorityCodes.find(sysStr) );
+                if(pc == priorityCodes.end())
+                {
+                    sysPrioriTypes[sysStr] = prioriTypes;
+                    continue;
+                }
+
+                const std::map<char, std::string>& bandCodes( (*pc).second );
                 for(auto bc: bandCodes)
                 {
                    char band = bc.first;
@@ -131,7 +139,7 @@ namespace gnssSpace
                    {
                        for(int j=0; j<codes.size(); j++)
                        {
-                           char typeStr[4] ={0};  
+                           char typeStr[5] ={0};
                            typeStr[0] = otStr[i];
                            typeStr[1] = band;
                            typeStr[2] = codes[j];
@@ -70,7 +70,8 @@ namespace gnssSpace
       /// eg. priorityCodes["G"]['1']="WCSLXPYMN"
       /// The only exception is there is no pseudorange (C) on GPS L1/L2 N (codeless)
       /// These tracking code characters are ORDERED, basically 'best' to 'worst'
-      static stringCharStringMap priorityCodes;
+      /// It is shared by all the objects, and threads: only read it with find()
+      static const stringCharStringMap priorityCodes;
 
       static stringCharStringMap init();
 
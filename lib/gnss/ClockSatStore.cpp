@@ -39,6 +39,8 @@ namespace gnssSpace
    ClockRecord ClockSatStore::getValue(const SatID& sat, const CommonTime& ttag)
       const noexcept(false)
    {
+      if(fixedGetValue) return (this->*fixedGetValue)(sat, ttag);
+
       try {
          checkTimeSystem(ttag.getTimeSystem());
 
@@ -199,6 +201,166 @@ namespace gnssSpace
       catch(InvalidRequest& e) { RETHROW(e); }
    }
 
+   // sum of w[i]*y[i], i=0,N-1
+   template <int N>
+   static inline double weightedSum(const double *w, const double *y)
+   {
+      double sum(0);
+      for(int i=0; i<N; i++) sum += w[i]*y[i];
+      return sum;
+   }
+
+   // getValue() for interpolation of fixed order N; the same as the general
+   // code in getValue(), but with the data window in arrays on the stack and
+   // one set of Lagrange weights for bias, drift and acceleration.
+   template <int N>
+   ClockRecord ClockSatStore::getFixedOrderValue(const SatID& sat,
+                                                 const CommonTime& ttag)
+      const noexcept(false)
+   {
+      try {
+         checkTimeSystem(ttag.getTimeSystem());
+
+         ClockRecord rec;
+         DataTableIterator it1, it2, kt;        // cf. TabularSatStore.hpp
+
+         bool isExact(getTableInterval(sat, ttag, N/2, it1, it2, haveClockDrift));
+         if(isExact && haveClockDrift) {
+            rec = it1->second;
+            return rec;
+         }
+
+         // pull data out of the data table
+         const int Nlow(N/2-1), Nhi(N/2);
+         int n, Nmatch(N/2);
+         CommonTime ttag0(it1->first);
+
+         double times[N],biases[N],drifts[N],accels[N];
+         double sig_biases[N],sig_drifts[N],sig_accels[N];
+
+         kt = it1;
+         for(n=0; n<N; n++, ++kt) {
+            // find index of matching time tag
+            if(isExact && ABS(kt->first-ttag) < 1.e-8) Nmatch = n;
+            times[n] = kt->first - ttag0;          // sec
+            biases[n] = kt->second.bias;           // sec
+            drifts[n] = kt->second.drift;          // sec/sec
+            accels[n] = kt->second.accel;          // sec/sec^2
+            sig_biases[n] = kt->second.sig_bias;
+            sig_drifts[n] = kt->second.sig_drift;
+            sig_accels[n] = kt->second.sig_accel;
+         }
+
+         // interpolate
+         rec.accel = rec.sig_accel = 0.0;              // defaults
+         double dt(ttag-ttag0), slope;
+
+         // Lagrange weights and their derivatives
+         double L[N],Lp[N];
+         if(interpType == 2) FixedLagrangeWeights<N>(times,dt,L,Lp);
+
+         if(haveClockDrift) {
+            if(interpType == 2) {
+               // Lagrange interpolation
+               rec.bias = weightedSum<N>(L,biases);                        // sec
+               rec.drift = weightedSum<N>(L,drifts);                       // sec/sec
+            }
+            else {
+               // linear interpolation
+               slope = (biases[Nhi]-biases[Nlow]) /
+                                   (times[Nhi]-times[Nlow]);               // sec/sec
+               rec.bias = biases[Nlow] + slope*(dt-times[Nlow]);           // sec
+               slope = (drifts[Nhi]-drifts[Nlow])/(times[Nhi]-times[Nlow]);
+               rec.drift = drifts[Nlow] + slope*(dt-times[Nlow]);          // sec/sec
+            }
+
+            // sigmas
+            if(isExact)
+               rec.sig_bias = sig_biases[Nmatch];
+            else
+               rec.sig_bias = RSS(sig_biases[Nhi],sig_biases[Nlow]);
+            rec.sig_drift = RSS(sig_drifts[Nhi],sig_drifts[Nlow]);
+         }
+         else
+         {                              // must interpolate biases to get drift
+            if(interpType == 2) {
+               // Lagrange interpolation
+               rec.bias = weightedSum<N>(L,biases);
+               rec.drift = weightedSum<N>(Lp,biases);
+            }
+            else {
+               // linear interpolation
+               rec.drift = (biases[Nhi]-biases[Nlow]) /
+                                   (times[Nhi]-times[Nlow]);            // sec/sec^2
+               rec.bias = biases[Nlow] + (dt-times[Nlow])*rec.drift;    // sec/sec
+            }
+
+            // sigmas
+            if(isExact)
+               rec.sig_bias = sig_biases[Nmatch];
+            else
+               rec.sig_bias = RSS(sig_biases[Nhi],sig_biases[Nlow]);
+            rec.sig_drift = rec.sig_bias/(times[Nhi]-times[Nlow]);
+         }
+
+         if(haveClockAccel) {
+            if(interpType == 2) {
+               // Lagrange interpolation
+               rec.accel = weightedSum<N>(L,accels);                    // sec/sec^2
+            }
+            else {
+               // linear interpolation
+               slope = (drifts[Nhi]-drifts[Nlow]) /
+                                   (times[Nhi]-times[Nlow]);            // sec/sec^2
+               rec.accel = accels[Nlow] + slope*(dt-times[Nlow]);       // sec/sec^2
+            }
+
+            // sigma
+            if(isExact)
+               rec.sig_accel = sig_accels[Nmatch];
+            else
+               rec.sig_accel = RSS(sig_accels[Nhi],sig_accels[Nlow]);
+         }
+         else if(haveClockDrift) {              // must interpolate drift to get accel
+            if(interpType == 2) {
+               // Lagrange interpolation
+               rec.accel = weightedSum<N>(Lp,drifts);
+            }
+            else {
+               // linear interpolation                                  // sec/sec^2
+               rec.accel = (drifts[Nhi]-drifts[Nlow]) / (times[Nhi]-times[Nlow]);
+            }
+
+            // sigmas  TD is there a better way?
+            rec.sig_accel = rec.sig_drift/(times[Nhi]-times[Nlow]);
+         }
+         // else zero
+
+         return rec;
+      }
+      catch(InvalidRequest& e) { RETHROW(e); }
+   }
+
+   // Choose fixedGetValue for the current interpType and interpOrder
+   void ClockSatStore::selectInterpolationKernel(void) throw()
+   {
+      // linear interpolation uses the two points around the time
+      if(interpType != 2) {
+         fixedGetValue = &ClockSatStore::getFixedOrderValue<2>;
+         return;
+      }
+
+      switch(interpOrder) {
+         case  2: fixedGetValue = &ClockSatStore::getFixedOrderValue<2>;  break;
+         case  4: fixedGetValue = &ClockSatStore::getFixedOrderValue<4>;  break;
+         case  6: fixedGetValue = &ClockSatStore::getFixedOrderValue<6>;  break;
+         case  8: fixedGetValue = &ClockSatStore::getFixedOrderValue<8>;  break;
+         case 10: fixedGetValue = &ClockSatStore::getFixedOrderValue<10>; break;
+         case 12: fixedGetValue = &ClockSatStore::getFixedOrderValue<12>; break;
+         default: fixedGetValue = NULL;
+      }
+   }
+
    // Return the clock bias for the given satellite at the given time
    // @param[in] sat the SatID of the satellite of interest
    // @param[in] ttag the time (CommonTime) of interest
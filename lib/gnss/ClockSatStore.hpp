@@ -80,6 +80,21 @@ namespace gnssSpace
       /// Flag to reject bad clock data; default true
       bool rejectBadClockFlag;
 
+      /// Interpolation kernel of fixed order for getValue(), chosen in
+      /// setInterpolationOrder(); NULL if there is none for interpOrder,
+      /// then the general (run-time order) code is used.
+      ClockRecord (ClockSatStore::*fixedGetValue)(const SatID& sat,
+                                                  const CommonTime& ttag)
+         const;
+
+      /// getValue() for interpolation of fixed order N (N/2 points on each side)
+      template <int N>
+      ClockRecord getFixedOrderValue(const SatID& sat, const CommonTime& ttag)
+         const noexcept(false);
+
+      /// Choose fixedGetValue for the current interpType and interpOrder
+      void selectInterpolationKernel(void) throw();
+
    // member functions
    public:
 
@@ -93,6 +108,7 @@ namespace gnssSpace
          interpOrder = 2*Nhalf;
          haveClockBias = true;
          haveClockDrift = havePosition = haveVelocity = false;
+         selectInterpolationKernel();
       }
 
       /// Destructor
@@ -186,11 +202,13 @@ namespace gnssSpace
          { return interpOrder; }
 
       /// Set the interpolation order; this routine forces the order to be even.
+      /// Orders 2 to 12 use interpolation kernels of fixed order.
       void setInterpolationOrder(unsigned int order) throw()
       {
          if(interpType == 2) Nhalf = (order+1)/2;
          else                Nhalf = 1;
          interpOrder = 2*Nhalf;
+         selectInterpolationKernel();
       }
 
       /// Set the flag; if true then bad position values are rejected when
@@ -0,0 +1,197 @@
+/// @file ClockTable.cpp
+/// Contiguous table of high-rate satellite clocks on a regular time grid,
+/// with a fast linear or quadratic evaluator.
+
+#include <cmath>
+#include <limits>
+
+#include "ClockTable.hpp"
+
+using namespace std;
+using namespace utilSpace;
+using namespace coordSpace;
+using namespace timeSpace;
+using namespace mathSpace;
+
+namespace gnssSpace
+{
+   // Copy the data of a clock store into the table.
+   void ClockTable::build(const ClockSatStore& store) noexcept(false)
+   {
+      clear();
+
+      std::vector<SatID> satList(store.getSatList());
+      if(satList.empty()) {
+         InvalidRequest e("ClockTable: the clock store is empty");
+         THROW(e);
+      }
+
+      // the grid has the smallest nominal time step of the satellites
+      double dt(0.0);
+      for(size_t j=0; j<satList.size(); j++) {
+         double s(store.nomTimeStep(satList[j]));
+         if(s > 0.0 && (dt == 0.0 || s < dt)) dt = s;
+      }
+      if(dt <= 0.0) {
+         InvalidRequest e("ClockTable: no time step in the clock store");
+         THROW(e);
+      }
+
+      CommonTime tBegin(store.getInitialTime());
+      const size_t nSat(satList.size());
+      const int nEpoch(int((store.getFinalTime() - tBegin)/dt + 0.5) + 1);
+      const double NaN(std::numeric_limits<double>::quiet_NaN());
+
+      std::vector<double> b(nEpoch*nSat, NaN), d;
+      if(store.hasClockDrift()) d.assign(nEpoch*nSat, NaN);
+
+      for(size_t j=0; j<nSat; j++) {
+         const ClockSatStore::DataTable& table(store.getDataTable(satList[j]));
+         ClockSatStore::DataTable::const_iterator it;
+         for(it=table.begin(); it!=table.end(); ++it) {
+            double x((it->first - tBegin)/dt);
+            int k(int(x + 0.5));
+            if(std::abs(x - k) > 1.e-6 || k >= nEpoch) {
+               InvalidRequest e("ClockTable: clock data of " + satList[j].toString()
+                                + " are not on a regular grid");
+               THROW(e);
+            }
+            b[k*nSat + j] = it->second.bias;
+            if(!d.empty()) d[k*nSat + j] = it->second.drift;
+         }
+      }
+
+      // all good, keep it
+      sats = satList;
+      for(size_t j=0; j<nSat; j++) satIndex[sats[j]] = j;
+      t0 = tBegin;
+      step = dt;
+      nEpochs = nEpoch;
+      haveDrift = !d.empty();
+      bias.swap(b);
+      drift.swap(d);
+   }
+
+   // Remove all data
+   void ClockTable::clear(void) throw()
+   {
+      step = 0.0;
+      nEpochs = 0;
+      haveDrift = false;
+      sats.clear();
+      satIndex.clear();
+      bias.clear();
+      drift.clear();
+   }
+
+   // Find the interpolation points of ttag, and their weights.
+   bool ClockTable::weights(const CommonTime& ttag, int& k,
+                            double w[3], double wd[3]) const throw()
+   {
+      if(nEpochs < nPoints) return false;
+
+      double x;
+      try { x = (ttag - t0)/step; }
+      catch(InvalidRequest& e) { return false; }       // wrong time system
+
+      if(!(x >= 0.0) || x > nEpochs-1) return false;
+
+      if(nPoints == 2) {
+         // the interval (k,k+1] around x, as in ClockSatStore
+         k = int(std::ceil(x)) - 1;
+         if(k < 0) k = 0;
+         double f(x - k);
+         w[0] = 1.0 - f;  w[1] = f;  w[2] = 0.0;
+         wd[0] = -1.0/step;  wd[1] = 1.0/step;  wd[2] = 0.0;
+      }
+      else {
+         // three points centered on the nearest epoch
+         int c(int(x + 0.5));
+         if(c < 1) c = 1;
+         if(c > nEpochs-2) c = nEpochs-2;
+         k = c - 1;
+         double u(x - c);
+         w[0] = 0.5*u*(u-1.0);  w[1] = 1.0 - u*u;  w[2] = 0.5*u*(u+1.0);
+         wd[0] = (u-0.5)/step;  wd[1] = -2.0*u/step;  wd[2] = (u+0.5)/step;
+      }
+
+      return true;
+   }
+
+   // Interpolate one column of the table
+   bool ClockTable::interpolate(int col, int k, const double w[3],
+                                const double wd[3], double& b, double& d)
+      const throw()
+   {
+      const size_t nSat(sats.size());
+      const size_t ndx(k*nSat + col);
+
+      // NaN, i.e. missing values, fail all comparisons
+      double b0(bias[ndx]), b1(bias[ndx+nSat]);
+      double b2(nPoints == 3 ? bias[ndx+2*nSat] : 0.0);
+      if(!(b0 == b0 && b1 == b1 && b2 == b2)) return false;
+
+      b = w[0]*b0 + w[1]*b1 + w[2]*b2;
+      d = wd[0]*b0 + wd[1]*b1 + wd[2]*b2;
+
+      if(haveDrift) {
+         double d0(drift[ndx]), d1(drift[ndx+nSat]);
+         double d2(nPoints == 3 ? drift[ndx+2*nSat] : 0.0);
+         if(d0 == d0 && d1 == d1 && d2 == d2)
+            d = w[0]*d0 + w[1]*d1 + w[2]*d2;
+      }
+
+      return true;
+   }
+
+   // Compute the clock bias and drift of one satellite.
+   bool ClockTable::getValue(const SatID& sat, const CommonTime& ttag,
+                             double& b, double& d) const throw()
+   {
+      std::map<SatID, int>::const_iterator it(satIndex.find(sat));
+      if(it == satIndex.end()) return false;
+
+      int k;
+      double w[3], wd[3];
+      if(!weights(ttag, k, w, wd)) return false;
+
+      return interpolate(it->second, k, w, wd, b, d);
+   }
+
+   // Compute the clock bias and drift of all satellites at one time.
+   int ClockTable::getValues(const CommonTime& ttag, std::vector<double>& biases,
+                             std::vector<double>& drifts, std::vector<char>& ok)
+      const throw()
+   {
+      const int nSat(sats.size());
+      biases.assign(nSat, 0.0);
+      drifts.assign(nSat, 0.0);
+      ok.assign(nSat, 0);
+
+      int k;
+      double w[3], wd[3];
+      if(!weights(ttag, k, w, wd)) return 0;
+
+      int n(0);
+      for(int j=0; j<nSat; j++)
+         if(interpolate(j, k, w, wd, biases[j], drifts[j])) { ok[j] = 1; n++; }
+
+      return n;
+   }
+
+   // Dump information about the table to an ostream.
+   void ClockTable::dump(std::ostream& os) const throw()
+   {
+      os << "Dump of ClockTable:" << std::endl;
+      if(!isValid()) {
+         os << " empty" << std::endl;
+         return;
+      }
+      os << " " << sats.size() << " satellites, " << nEpochs << " epochs of "
+         << step << " s from " << t0 << std::endl;
+      os << " " << (nPoints == 3 ? "Quadratic" : "Linear") << " interpolation, "
+         << (haveDrift ? "with" : "without") << " drift data" << std::endl;
+      os << "End dump of ClockTable." << std::endl;
+   }
+
+}  // End of namespace gnssSpace
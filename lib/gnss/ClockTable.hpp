@@ -0,0 +1,134 @@
+/// @file ClockTable.hpp
+/// Contiguous table of high-rate satellite clocks (e.g. 5 s or 30 s RINEX
+/// clocks) on a regular time grid, with a fast linear or quadratic evaluator.
+
+#ifndef CLOCK_TABLE_INCLUDE
+#define CLOCK_TABLE_INCLUDE
+
+#include <map>
+#include <vector>
+#include <iostream>
+
+#include "Exception.hpp"
+#include "SatID.hpp"
+#include "CommonTime.hpp"
+#include "ClockSatStore.hpp"
+
+using namespace utilSpace;
+using namespace coordSpace;
+using namespace timeSpace;
+using namespace mathSpace;
+namespace gnssSpace
+{
+
+   /** @addtogroup ephemstore */
+   //@{
+
+   /// Table of clock bias (and drift, if present) of several satellites on one
+   /// regular time grid, copied from a ClockSatStore. The values are stored
+   /// epoch by epoch, with one column per satellite, and missing values are
+   /// NaN. A value at time t is found from the index (t-t0)/step, without any
+   /// search, and interpolated linearly (2 points) or quadratically (3 points).
+   /// There are no gap or interval checks beyond the grid itself: if one of
+   /// the points is missing the value is not computed, and the caller should
+   /// use the ClockSatStore instead.
+   /// Units are those of the ClockSatStore.
+   class ClockTable
+   {
+   public:
+
+      /// Default constructor; linear interpolation
+      ClockTable() throw() : nPoints(2), step(0.0), nEpochs(0), haveDrift(false)
+      {}
+
+      /// Copy the data of a clock store into the table.
+      /// @param[in] store the clock store
+      /// @throw InvalidRequest if the store is empty, or the data are not on
+      ///    one regular time grid
+      void build(const ClockSatStore& store) noexcept(false);
+
+      /// Remove all data
+      void clear(void) throw();
+
+      /// true if the table has data
+      bool isValid(void) const throw()
+      { return (nEpochs > 1); }
+
+      /// Set the number of points of the interpolation: 2 (linear, default)
+      /// or 3 (quadratic)
+      void setInterpolationPoints(int n) throw()
+      { nPoints = (n == 3 ? 3 : 2); }
+
+      /// Get the number of points of the interpolation
+      int getInterpolationPoints(void) const throw()
+      { return nPoints; }
+
+      /// Time step of the grid (seconds)
+      double getTimeStep(void) const throw()
+      { return step; }
+
+      /// Satellites of the table, in the order of the columns
+      const std::vector<SatID>& getSatList(void) const throw()
+      { return sats; }
+
+      /// Compute the clock bias and drift of one satellite.
+      /// @param[in] sat the satellite of interest
+      /// @param[in] ttag the time of interest
+      /// @param[out] bias clock bias
+      /// @param[out] drift clock drift
+      /// @return false if the value can not be computed from the table
+      bool getValue(const SatID& sat, const CommonTime& ttag,
+                    double& bias, double& drift) const throw();
+
+      /// Compute the clock bias and drift of all satellites of the table
+      /// (in the order of getSatList()) at one time.
+      /// @param[in] ttag the time of interest
+      /// @param[out] biases clock biases
+      /// @param[out] drifts clock drifts
+      /// @param[out] ok 1 if the value of the satellite was computed, else 0
+      /// @return the number of satellites with values
+      int getValues(const CommonTime& ttag, std::vector<double>& biases,
+                    std::vector<double>& drifts, std::vector<char>& ok)
+         const throw();
+
+      /// Dump information about the table to an ostream.
+      void dump(std::ostream& os = std::cout) const throw();
+
+   private:
+
+      /// Find the interpolation points of ttag: the index of the first point
+      /// and the weights of bias (w) and of its derivative (wd, 1/s).
+      /// @return false if ttag is outside the grid
+      bool weights(const CommonTime& ttag, int& k, double w[3], double wd[3])
+         const throw();
+
+      /// Interpolate one column of the table
+      /// @return false if one of the points is missing
+      bool interpolate(int col, int k, const double w[3], const double wd[3],
+                       double& bias, double& drift) const throw();
+
+      /// number of points of the interpolation, 2 or 3
+      int nPoints;
+
+      /// first epoch, time step (s) and number of epochs of the grid
+      CommonTime t0;
+      double step;
+      int nEpochs;
+
+      /// true if the store had drift data, then drifts are interpolated too
+      bool haveDrift;
+
+      /// satellites, and their columns
+      std::vector<SatID> sats;
+      std::map<SatID, int> satIndex;
+
+      /// bias and drift, at epoch*sats.size() + column
+      std::vector<double> bias, drift;
+
+   }; // end class ClockTable
+
+   //@}
+
+}  // End of namespace gnssSpace
+
+#endif // CLOCK_TABLE_INCLUDE
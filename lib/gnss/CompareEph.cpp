@@ -0,0 +1,297 @@
+/// @file CompareEph.cpp
+/// Compare the orbits and clocks of two ephemeris stores, and summarize the
+/// differences in radial, along-track, cross-track and clock.
+
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+
+#include "CompareEph.hpp"
+#include "constants.hpp"
+
+using namespace std;
+
+#define debug 0
+
+using namespace utilSpace;
+using namespace coordSpace;
+using namespace timeSpace;
+using namespace mathSpace;
+namespace gnssSpace
+{
+    DiffStats::DiffStats(const double &limit) throw()
+        : outlierLimit(limit), n(0), nOutliers(0),
+          sum(0.0), sumSq(0.0), maxAbsValue(0.0)
+    {
+        std::fill(hist, hist + numBins, 0);
+    }
+
+    // Add a value
+    void DiffStats::add(const double &x) throw()
+    {
+        double a(std::abs(x));
+        if (outlierLimit > 0.0 && a > outlierLimit)
+        {
+            nOutliers++;
+            return;
+        }
+
+        n++;
+        sum += x;
+        sumSq += x * x;
+        if (a > maxAbsValue) maxAbsValue = a;
+
+        // bin 0 is for values below 10^minDecade, the last one for the overflow
+        int bin(0);
+        if (a > 0.0)
+        {
+            double b((std::log10(a) - minDecade) * binsPerDecade);
+            bin = (b < 0.0 ? 0 : std::min(int(b) + 1, numBins - 1));
+        }
+        hist[bin]++;
+    }
+
+    // Add the values of another object
+    void DiffStats::merge(const DiffStats &right) throw()
+    {
+        n += right.n;
+        nOutliers += right.nOutliers;
+        sum += right.sum;
+        sumSq += right.sumSq;
+        maxAbsValue = std::max(maxAbsValue, right.maxAbsValue);
+        for (int i = 0; i < numBins; i++)
+            hist[i] += right.hist[i];
+    }
+
+    double DiffStats::mean(void) const throw()
+    {
+        return (n > 0 ? sum / n : 0.0);
+    }
+
+    double DiffStats::rms(void) const throw()
+    {
+        return (n > 0 ? std::sqrt(sumSq / n) : 0.0);
+    }
+
+    double DiffStats::stdDev(void) const throw()
+    {
+        if (n < 2) return 0.0;
+        double var((sumSq - sum * sum / n) / (n - 1));
+        return (var > 0.0 ? std::sqrt(var) : 0.0);
+    }
+
+    // Percentile of the absolute values, interpolated (logarithmically)
+    // inside the bin of the histogram
+    double DiffStats::percentile(const double &p) const throw()
+    {
+        if (n == 0) return 0.0;
+
+        double target(p / 100.0 * n), cum(0.0);
+        for (int i = 0; i < numBins; i++)
+        {
+            if (hist[i] == 0 || cum + hist[i] < target)
+            {
+                cum += hist[i];
+                continue;
+            }
+
+            double frac((target - cum) / hist[i]);
+            if (i == numBins - 1) return maxAbsValue;
+
+            double hi(std::pow(10.0, minDecade + double(i) / binsPerDecade));
+            if (i == 0) return std::min(frac * hi, maxAbsValue);
+
+            double lo(std::pow(10.0, minDecade + double(i - 1) / binsPerDecade));
+            return std::min(lo * std::pow(hi / lo, frac), maxAbsValue);
+        }
+
+        return maxAbsValue;
+    }
+
+    // Compute the differences and their statistics.
+    void CompareEph::Process(const std::vector<SatID> &sats,
+                             const CommonTime &begin,
+                             const CommonTime &end,
+                             const double &interval)
+        noexcept(false)
+    {
+        if (interval <= 0.0 || end < begin)
+        {
+            InvalidRequest e("CompareEph: invalid time span or interval");
+            THROW(e);
+        }
+
+        numEpochs = int((end - begin) / interval + 1.e-6) + 1;
+        const int nSat(sats.size());
+
+        // differences radial, along, cross, clock (m) of every
+        // (satellite,epoch), at (sat*numEpochs + epoch)*4
+        std::vector<double> diff(size_t(nSat) * numEpochs * 4, 0.0);
+        std::vector<char> valid(size_t(nSat) * numEpochs, 0);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int j = 0; j < nSat; j++)
+        {
+            for (int k = 0; k < numEpochs; k++)
+            {
+                CommonTime t(begin + k * interval);
+
+                Xvt test, ref;
+                try
+                {
+                    test = pTestStore->getXvt(sats[j], t);
+                    ref = pRefStore->getXvt(sats[j], t);
+                }
+                catch (Exception &e)
+                {
+                    continue;
+                }
+
+                // a store which does not know the system returns zeros
+                if (test.x.mag() == 0.0 || ref.x.mag() == 0.0) continue;
+
+                // radial, along-track and cross-track unit vectors, with
+                // the inertial velocity of the reference orbit
+                Triple vi(ref.v[0] - OMEGA_EARTH * ref.x[1],
+                          ref.v[1] + OMEGA_EARTH * ref.x[0],
+                          ref.v[2]);
+                Triple eR(ref.x.unitVector());
+                Triple eC(ref.x.cross(vi).unitVector());
+                Triple eA(eC.cross(eR));
+
+                Triple dx(test.x - ref.x);
+
+                double *d(&diff[(size_t(j) * numEpochs + k) * 4]);
+                d[0] = dx.dot(eR);
+                d[1] = dx.dot(eA);
+                d[2] = dx.dot(eC);
+                d[3] = (test.clkbias - ref.clkbias) * C_MPS;
+                valid[size_t(j) * numEpochs + k] = 1;
+            }
+        }
+
+        // median clock difference of each system at each epoch; the median
+        // is not pulled away by a few bad clocks
+        std::vector<double> clockRef(size_t(nSat) * numEpochs, 0.0);
+        std::map<SatelliteSystem, std::vector<int> > sysSats;
+        for (int j = 0; j < nSat; j++)
+            sysSats[SatelliteSystem(sats[j].system)].push_back(j);
+
+        for (int k = 0; k < numEpochs; k++)
+        {
+            for (std::map<SatelliteSystem, std::vector<int> >::const_iterator
+                 it = sysSats.begin(); it != sysSats.end(); ++it)
+            {
+                std::vector<double> clocks;
+                for (size_t i = 0; i < it->second.size(); i++)
+                {
+                    int j(it->second[i]);
+                    if (valid[size_t(j) * numEpochs + k])
+                        clocks.push_back(diff[(size_t(j) * numEpochs + k) * 4 + 3]);
+                }
+                if (clocks.empty()) continue;
+
+                std::nth_element(clocks.begin(),
+                                 clocks.begin() + clocks.size() / 2,
+                                 clocks.end());
+                double median(clocks[clocks.size() / 2]);
+
+                for (size_t i = 0; i < it->second.size(); i++)
+                    clockRef[size_t(it->second[i]) * numEpochs + k] = median;
+            }
+        }
+
+        // statistics of each satellite
+        std::vector<SatStats> stats(nSat, SatStats(orbitLimit, clockLimit));
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int j = 0; j < nSat; j++)
+        {
+            for (int k = 0; k < numEpochs; k++)
+            {
+                size_t ndx(size_t(j) * numEpochs + k);
+                if (!valid[ndx]) continue;
+
+                const double *d(&diff[ndx * 4]);
+                stats[j].radial.add(d[0]);
+                stats[j].along.add(d[1]);
+                stats[j].cross.add(d[2]);
+                stats[j].orbit.add(std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]));
+                stats[j].clock.add(d[3]);
+                stats[j].clockRel.add(d[3] - clockRef[ndx]);
+            }
+        }
+
+        satStats.clear();
+        systemStats.clear();
+        for (int j = 0; j < nSat; j++)
+        {
+            if (stats[j].orbit.size() + stats[j].orbit.numOutliers() == 0)
+                continue;
+
+            satStats.insert(std::make_pair(sats[j], stats[j]));
+
+            SatelliteSystem sys(sats[j].system);
+            std::map<SatelliteSystem, SatStats>::iterator it = systemStats.find(sys);
+            if (it == systemStats.end())
+                it = systemStats.insert(
+                        std::make_pair(sys, SatStats(orbitLimit, clockLimit))).first;
+
+            it->second.radial.merge(stats[j].radial);
+            it->second.along.merge(stats[j].along);
+            it->second.cross.merge(stats[j].cross);
+            it->second.orbit.merge(stats[j].orbit);
+            it->second.clock.merge(stats[j].clock);
+            it->second.clockRel.merge(stats[j].clockRel);
+        }
+    }
+
+    // write one line of the summary
+    static void printStats(std::ostream &os, const std::string &name,
+                           const CompareEph::SatStats &s)
+    {
+        os << std::left << std::setw(8) << name << std::right
+           << std::setw(7) << s.orbit.size()
+           << std::fixed << std::setprecision(3)
+           << std::setw(8) << s.radial.rms()
+           << std::setw(8) << s.along.rms()
+           << std::setw(8) << s.cross.rms()
+           << std::setw(8) << s.orbit.rms()
+           << std::setw(8) << s.orbit.percentile(95.0)
+           << std::setw(9) << s.orbit.maxAbs()
+           << std::setw(10) << s.clock.mean()
+           << std::setw(8) << s.clockRel.stdDev()
+           << std::setw(8) << s.clockRel.rms()
+           << std::setw(8) << s.clockRel.percentile(95.0)
+           << std::setw(6) << s.orbit.numOutliers()
+           << std::setw(6) << s.clockRel.numOutliers()
+           << std::endl;
+    }
+
+    // Write one line of statistics per satellite and per system
+    void CompareEph::printSummary(std::ostream &os) const
+    {
+        os << "# CompareEph: " << numEpochs << " epochs, "
+           << satStats.size() << " satellites; test - reference, in meters"
+           << std::endl;
+        os << "# orbit outlier limit " << orbitLimit
+           << ", clock outlier limit " << clockLimit << std::endl;
+        os << "# sat          n  radial   along   cross  3D_rms  3D_p95   3D_max"
+           << "  clk_mean clk_std clk_rms clk_p95 outO  outC" << std::endl;
+        os << "# clk_std, clk_rms, clk_p95: epoch median of the system removed"
+           << std::endl;
+
+        for (std::map<SatID, SatStats>::const_iterator it = satStats.begin();
+             it != satStats.end(); ++it)
+            printStats(os, it->first.toString(), it->second);
+
+        for (std::map<SatelliteSystem, SatStats>::const_iterator
+             it = systemStats.begin(); it != systemStats.end(); ++it)
+            printStats(os, it->first.toString(), it->second);
+    }
+
+}  // End of namespace gnssSpace
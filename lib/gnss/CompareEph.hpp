@@ -0,0 +1,190 @@
+/** @file CompareEph.hpp
+ * Compare the orbits and clocks of two ephemeris stores, usually the
+ * broadcast (Rx3NavStore) and the precise (SP3EphStore) ones, for all
+ * satellites and epochs of a time span, and summarize the differences
+ * in radial, along-track, cross-track and clock with streaming
+ * statistics. */
+
+#ifndef CompareEph_INCLUDE
+#define CompareEph_INCLUDE
+
+#include <map>
+#include <vector>
+#include <iostream>
+
+#include "Exception.hpp"
+#include "SatID.hpp"
+#include "CommonTime.hpp"
+#include "XvtStore.hpp"
+
+using namespace utilSpace;
+using namespace coordSpace;
+using namespace timeSpace;
+using namespace mathSpace;
+
+namespace gnssSpace
+{
+    /** Streaming statistics of a series of differences. Mean, rms and
+     * extremes are exact. The percentiles of the absolute values come
+     * from a logarithmic histogram (20 bins per decade, 1e-4 to 1e5), so
+     * they are good to a few percent. Values larger than the outlier
+     * limit are counted, and are left out of all other statistics.
+     * Objects of the same limit may be merged, e.g. the satellites of
+     * one system. */
+    class DiffStats
+    {
+    public:
+
+         /// Constructor, with the outlier limit (0 = no limit)
+        DiffStats(const double& limit = 0.0) throw();
+
+         /// Add a value
+        void add(const double& x) throw();
+
+         /// Add the values of another object
+        void merge(const DiffStats& right) throw();
+
+         /// Number of values, outliers not included
+        size_t size(void) const throw()
+        { return n; }
+
+         /// Number of outliers
+        size_t numOutliers(void) const throw()
+        { return nOutliers; }
+
+         /// Mean, zero if empty
+        double mean(void) const throw();
+
+         /// Root mean square, zero if empty
+        double rms(void) const throw();
+
+         /// Standard deviation about the mean, zero if less than 2 values
+        double stdDev(void) const throw();
+
+         /// Largest absolute value
+        double maxAbs(void) const throw()
+        { return maxAbsValue; }
+
+         /// Percentile (0 <= p <= 100) of the absolute values
+        double percentile(const double& p) const throw();
+
+    private:
+
+        static const int binsPerDecade = 20;
+        static const int minDecade = -4;
+        static const int numBins = 9*binsPerDecade + 2;  // with under/overflow
+
+        double outlierLimit;
+        size_t n, nOutliers;
+        double sum, sumSq, maxAbsValue;
+        size_t hist[numBins];
+
+    }; // End of class 'DiffStats'
+
+
+    /** Compare the orbits and clocks of two ephemeris stores.
+     *
+     * The differences (test - reference) are computed for all given
+     * satellites at the epochs begin, begin+interval, ... end, in
+     * parallel over the satellites when USE_OPENMP is defined; both
+     * stores must therefore allow concurrent calls of getXvt(). Epochs
+     * where either store can not give the satellite are skipped.
+     *
+     * The orbit differences are projected on the radial, along-track
+     * and cross-track directions of the reference orbit. The clock
+     * differences are given as they are, and also with the median over
+     * the satellites of each system removed at every epoch; the latter
+     * takes out the different datums of the clocks.
+     *
+     * No antenna offsets are applied: broadcast orbits refer to the
+     * antenna phase center and precise ones to the center of mass, so
+     * the radial difference has a bias of up to a few decimeters.
+     *
+     * A typical way to use this class follows:
+     *
+     * @code
+     *    CompareEph compareEph(navStore, sp3Store);
+     *    compareEph.Process(sp3Store.getSatList(), sp3Store.getInitialTime(),
+     *                       sp3Store.getFinalTime(), 300.0);
+     *    compareEph.printSummary(cout);
+     * @endcode */
+    class CompareEph
+    {
+    public:
+
+         /// Statistics of the differences of one satellite or system (m)
+        struct SatStats
+        {
+            SatStats(const double& orbitLimit = 0.0,
+                     const double& clockLimit = 0.0)
+                : radial(orbitLimit), along(orbitLimit), cross(orbitLimit),
+                  orbit(orbitLimit), clock(0.0), clockRel(clockLimit)
+            {}
+
+            DiffStats radial;      ///< radial
+            DiffStats along;       ///< along-track
+            DiffStats cross;       ///< cross-track
+            DiffStats orbit;       ///< 3D orbit
+            DiffStats clock;       ///< clock, without outlier limit
+            DiffStats clockRel;    ///< clock, epoch median of the system removed
+        };
+
+         /** Constructor
+          * @param testStore the ephemeris to be checked, e.g. broadcast
+          * @param refStore the reference ephemeris, e.g. precise */
+        CompareEph(XvtStore<SatID>& testStore, XvtStore<SatID>& refStore)
+            : pTestStore(&testStore), pRefStore(&refStore),
+              orbitLimit(50.0), clockLimit(100.0), numEpochs(0)
+        {}
+
+         /// Set the outlier limits for orbit and clock differences (m)
+        void setOutlierLimits(const double& orbit, const double& clock)
+        { orbitLimit = orbit; clockLimit = clock; }
+
+         /** Compute the differences and their statistics.
+          * @param sats the satellites to compare
+          * @param begin first epoch
+          * @param end last epoch
+          * @param interval time step (s) */
+        void Process(const std::vector<SatID>& sats,
+                     const CommonTime& begin,
+                     const CommonTime& end,
+                     const double& interval)
+            noexcept(false);
+
+         /// Statistics for each satellite
+        const std::map<SatID, SatStats>& getSatStats(void) const
+        { return satStats; }
+
+         /// Statistics for each system
+        const std::map<SatelliteSystem, SatStats>& getSystemStats(void) const
+        { return systemStats; }
+
+         /// Number of epochs of the last Process()
+        int getNumEpochs(void) const
+        { return numEpochs; }
+
+         /// Write one line of statistics per satellite and per system
+        void printSummary(std::ostream& os) const;
+
+    private:
+
+         /// Ephemeris to be checked, and the reference
+        XvtStore<SatID>* pTestStore;
+        XvtStore<SatID>* pRefStore;
+
+         /// Outlier limits (m)
+        double orbitLimit;
+        double clockLimit;
+
+         /// Number of epochs of the last Process()
+        int numEpochs;
+
+        std::map<SatID, SatStats> satStats;
+        std::map<SatelliteSystem, SatStats> systemStats;
+
+    }; // End of class 'CompareEph'
+
+}  // End of namespace gnssSpace
+
+#endif // CompareEph_INCLUDE
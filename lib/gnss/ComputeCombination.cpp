@@ -35,8 +35,7 @@ namespace gnssSpace
 
         try
         {
-            SatIDSet satRejectedSet;
-            LinearCombList linearList;
+            EpochSatIDSet satRejectedSet;
 
             // Loop through all the satellites
             for(satTypeValueMap::iterator it = gData.begin();
@@ -44,7 +43,10 @@ namespace gnssSpace
                 ++it)
             {
 
-                linearList = systemCombs[(*it).first.system];
+                auto sc = systemCombs.find((*it).first.system);
+                if(sc == systemCombs.end()) continue;
+
+                const LinearCombList& linearList( sc->second );
 
                 // Loop through all the defined linear combinations
                 for(auto pos = linearList.begin(); pos != linearList.end(); ++pos)
@@ -70,9 +72,10 @@ namespace gnssSpace
 
 
                         // if found 
-                        if( (*it).second.find(type) != (*it).second.end() )
+                        const double* pValue( (*it).second.tryGet(type) );
+                        if( pValue != NULL )
                         {
-                           temp = (*it).second[type];
+                           temp = *pValue;
                         }
                         else // not found
                         {
@@ -139,4 +142,103 @@ namespace gnssSpace
     }  // End of method 'ComputeCombination::Process()'
 
 
+
+      /* Same as above, for the data in a satTypeValueTable. The columns of
+       * the terms of each combination are looked up once per epoch.
+       *
+       * @param time      Epoch corresponding to the data.
+       * @param gData     Data object holding the data.
+       */
+    satTypeValueTable& ComputeCombination::Process( const CommonTime& time,
+                                                    satTypeValueTable& gData )
+        noexcept(false)
+    {
+
+        try
+        {
+            // columns of the terms (-1 if absent), coefficients, and if the
+            // terms are optional, for all combinations of all systems
+            EpochMap<SatelliteSystem, EpochVector<int> > sysFirst;
+            EpochVector<int> header, first;
+            EpochVector<int> cols;
+            EpochVector<double> coefs;
+            EpochVector<char> optional;
+
+            for(auto sc = systemCombs.begin(); sc != systemCombs.end(); ++sc)
+            {
+                EpochVector<int>& combs( sysFirst[sc->first] );
+                for(auto pos = sc->second.begin(); pos != sc->second.end(); ++pos)
+                {
+                    combs.push_back(header.size());
+                    header.push_back(gData.addType(pos->header));
+                    first.push_back(cols.size());
+                    for(typeValueMap::const_iterator iter = pos->body.begin();
+                        iter != pos->body.end();
+                        ++iter)
+                    {
+                        cols.push_back(gData.typeIndex(iter->first));
+                        coefs.push_back(iter->second);
+                        optional.push_back( pos->optionalTypes.find(iter->first)
+                                            != pos->optionalTypes.end() );
+                    }
+                }
+            }
+            first.push_back(cols.size());
+
+            // Loop through all the satellites
+            for(int row = 0; row < gData.numRows(); row++)
+            {
+                if( !gData.isActive(row) ) continue;
+
+                auto sf = sysFirst.find(gData.getSat(row).system);
+                if(sf == sysFirst.end()) continue;
+
+                bool rejected(false);
+                for(size_t k = 0; k < sf->second.size(); k++)
+                {
+                    int comb( sf->second[k] );
+                    double result(0.0);
+                    bool valid(true);
+
+                    for(int i = first[comb]; i < first[comb+1]; i++)
+                    {
+                        if( cols[i] >= 0 && gData.hasValue(row, cols[i]) )
+                        {
+                            result += coefs[i] * gData.value(row, cols[i]);
+                        }
+                        else if( !optional[i] )
+                        {
+                            valid = false;
+                            break;
+                        }
+                    }
+
+                    // Store the result in the proper place
+                    if( valid )
+                    {
+                        gData.setValue(row, header[comb], result);
+                    }
+                    else
+                    {
+                        rejected = true;
+                    }
+                }
+
+                // Remove satellites with missing data
+                if(rejected) gData.removeRow(row);
+            }
+
+            return gData;
+
+        }
+        catch(Exception& u)
+        {
+            // Throw an exception if something unexpected happens
+            ProcessingException e( getClassName() + ":" + u.what() );
+            THROW(e);
+        }
+
+    }  // End of method 'ComputeCombination::Process()'
+
+
 } // End of namespace gnssSpace
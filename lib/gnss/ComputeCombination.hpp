@@ -11,6 +11,7 @@
 #define ComputeCombination_HPP
 
 #include "Rx3ObsData.hpp"
+#include "SatTypeValueTable.hpp"
 
 
 namespace gnssSpace
@@ -122,6 +123,12 @@ namespace gnssSpace
             noexcept(false);
 
 
+         /// Same as above, for the data in a satTypeValueTable.
+        virtual satTypeValueTable& Process( const CommonTime& time,
+                                            satTypeValueTable& gData )
+            noexcept(false);
+
+
         virtual void Process(Rx3ObsData& rxData)
             noexcept(false)
         { 
@@ -134,7 +141,7 @@ namespace gnssSpace
             systemCombs = sysCombs;
         };
 
-        void addLinear(const SatelliteSystem& sys, LinearCombList& list)
+        void addLinear(const SatelliteSystem& sys, const LinearCombList& list)
         {
             for(auto it=list.begin();it!=list.end(); it++)
             {
@@ -142,7 +149,7 @@ namespace gnssSpace
             }
         };
 
-        void addLinear(const SatelliteSystem& sys, gnssLinearCombination& comb)
+        void addLinear(const SatelliteSystem& sys, const gnssLinearCombination& comb)
         {
             systemCombs[sys].push_back(comb);
         };
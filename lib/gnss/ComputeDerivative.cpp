@@ -46,9 +46,32 @@ namespace gnssSpace
     }  // End of 'ComputeDerivative::ComputeDerivative()'
 
 
+      // Make room for the geometry of n satellites
+    void ComputeDerivative::resizeGeometry(int n)
+    {
+        if( svX.size() < size_t(n) )
+        {
+            svX.resize(n);
+            svY.resize(n);
+            svZ.resize(n);
+            rhoVec.resize(n);
+            dXVec.resize(n);
+            dYVec.resize(n);
+            dZVec.resize(n);
+            elevVec.resize(n);
+            azimVec.resize(n);
+            validVec.resize(n);
+        }
+    }
+
+
       /* Return a satTypeValueMap object, adding the new data generated when
        * calling a modeling object.
        *
+       * The satellite positions are gathered into arrays, the geometry of
+       * all of them is computed by SatGeometry, and the results are
+       * written back in a last pass over the satellites.
+       *
        * @param time      Epoch.
        * @param gData     Data object holding the data.
        */
@@ -59,83 +82,78 @@ namespace gnssSpace
 
         try
         {
-            SatIDSet satRejectedSet;
-            TypeID defaultObs;
+            EpochSatIDSet satRejectedSet;
 
-            // Loop through all the satellites
+            int numSats( gData.size() );
+            resizeGeometry(numSats);
+
+            // frame of the receiver, once for all the satellites
+            geometry.setReceiver(nominalPos);
+
+            // gather the satellite positions
+            int i(0);
             for(satTypeValueMap::iterator it = gData.begin();
                 it != gData.end();
-                ++it)
+                ++it, ++i)
             {
-                SatID sat = (*it).first;
-
-                Triple svPos;
-                svPos[0] = (*it).second[TypeID::satXECEF];
-                svPos[1] = (*it).second[TypeID::satYECEF];
-                svPos[2] = (*it).second[TypeID::satZECEF];
+                svX[i] = (*it).second[TypeID::satXECEF];
+                svY[i] = (*it).second[TypeID::satYECEF];
+                svZ[i] = (*it).second[TypeID::satZECEF];
 
                 if(debug)
                 {
-                    cout << getClassName() << " sat:" << sat << svPos << endl;
+                    cout << getClassName() << " sat:" << (*it).first
+                         << " " << svX[i] << " " << svY[i] << " " << svZ[i]
+                         << endl;
                 }
+            }
 
-                // rho
-                double rho(0.0);
-                rho = RSS(svPos[0] - nominalPos.X(), 
-                          svPos[1] - nominalPos.Y(), 
-                          svPos[2] - nominalPos.Z());
-
-                // partials
-                Triple cosines;
-                cosines[0] = (nominalPos.X() - svPos[0]) / rho;
-                cosines[1] = (nominalPos.Y() - svPos[1]) / rho;
-                cosines[2] = (nominalPos.Z() - svPos[2]) / rho;
+            if(numSats > 0)
+            {
+                geometry.compute( numSats, &svX[0], &svY[0], &svZ[0],
+                                  &rhoVec[0], &dXVec[0], &dYVec[0], &dZVec[0],
+                                  &elevVec[0], &azimVec[0], &validVec[0] );
+            }
 
-                // elevation, azimuth
-                double elevation(0.0), azimuth(0.0);
+            // Loop through all the satellites
+            i = 0;
+            for(satTypeValueMap::iterator it = gData.begin();
+                it != gData.end();
+                ++it, ++i)
+            {
+                const SatID& sat( (*it).first );
 
-                try
-                {
-                    elevation = nominalPos.elevationGeodetic(svPos);
-                    azimuth = nominalPos.azimuth(svPos);
-                }
-                catch(Exception& e)
+                // elevation or azimuth could not be computed
+                if( !validVec[i] )
                 {
-                    satRejectedSet.insert((*it).first);
+                    satRejectedSet.insert(sat);
                     continue;
                 }
 
                 // Let's test if satellite has enough elevation over horizon
-                if ( elevation < minElev )
+                if ( elevVec[i] < minElev )
                 {
                     // Mark this satellite if it doesn't have enough elevation
-                    satRejectedSet.insert( (*it).first );
+                    satRejectedSet.insert(sat);
                     continue;
                 }
 
-                // now, let's compute the prefitC for spp
-                double relativity, cdtSat;
-
-                try
+                // extract values from gnssRinex
+                // if not found, remove this satellite. shjzhang
+                if( (*it).second.tryGet(TypeID::relativity) == NULL ||
+                    (*it).second.tryGet(TypeID::cdtSat) == NULL )
                 {
-                    // extract values from gnssRinex using operator()
-                    // if not found, remove this satellite. shjzhang
-                    relativity = (*it).second(TypeID::relativity);
-                    cdtSat     = (*it).second(TypeID::cdtSat);
-                }
-                catch(Exception& e)
-                {
-                    satRejectedSet.insert((*it).first);
+                    satRejectedSet.insert(sat);
                     continue;
                 }
 
                 // rho
-                (*it).second[TypeID::rho] = rho;
+                (*it).second[TypeID::rho] = rhoVec[i];
 
                 // Let's insert partials for station position at receive time
-                (*it).second[TypeID::dX] = cosines[0];
-                (*it).second[TypeID::dY] = cosines[1];
-                (*it).second[TypeID::dZ] = cosines[2];
+                (*it).second[TypeID::dX] = dXVec[i];
+                (*it).second[TypeID::dY] = dYVec[i];
+                (*it).second[TypeID::dZ] = dZVec[i];
                 (*it).second[TypeID::cdt] = 1.0;
 
                 if(sat.system == SatelliteSystem::GPS)
@@ -155,8 +173,8 @@ namespace gnssSpace
                     (*it).second[TypeID::dcdtGLO] = 1.0;
                 }
 
-                (*it).second[TypeID::elevation] = elevation;
-                (*it).second[TypeID::azimuth] = azimuth;
+                (*it).second[TypeID::elevation] = elevVec[i];
+                (*it).second[TypeID::azimuth] = azimVec[i];
 
             } // End of loop for(satTypeValueMap = gData.begin()...
 
@@ -179,6 +197,126 @@ namespace gnssSpace
 
     }  // End of method 'ComputeDerivative::Process()'
 
+
+      /* Same as above, for the data in a satTypeValueTable; the columns
+       * of the satellite positions are given as they are to SatGeometry,
+       * then the satellites are visited by row.
+       *
+       * @param time      Epoch.
+       * @param gData     Data object holding the data.
+       */
+    satTypeValueTable& ComputeDerivative::Process( const CommonTime& time,
+                                                   satTypeValueTable& gData )
+            noexcept(false)
+    {
+        try
+        {
+            const int satX( gData.typeIndex(TypeID::satXECEF) );
+            const int satY( gData.typeIndex(TypeID::satYECEF) );
+            const int satZ( gData.typeIndex(TypeID::satZECEF) );
+            const int relCol( gData.typeIndex(TypeID::relativity) );
+            const int cdtSatCol( gData.typeIndex(TypeID::cdtSat) );
+
+            // satellite position, relativity and clock are needed
+            if( satX < 0 || satY < 0 || satZ < 0 ||
+                relCol < 0 || cdtSatCol < 0 )
+            {
+                for(int row = 0; row < gData.numRows(); row++)
+                {
+                    if( gData.isActive(row) ) gData.removeRow(row);
+                }
+                return gData;
+            }
+
+            const int rhoCol( gData.addType(TypeID::rho) );
+            const int dXCol( gData.addType(TypeID::dX) );
+            const int dYCol( gData.addType(TypeID::dY) );
+            const int dZCol( gData.addType(TypeID::dZ) );
+            const int cdtCol( gData.addType(TypeID::cdt) );
+            const int elevCol( gData.addType(TypeID::elevation) );
+            const int azimCol( gData.addType(TypeID::azimuth) );
+
+            // all the rows at once; the ones without position are
+            // discarded below
+            int numRows( gData.numRows() );
+            resizeGeometry(numRows);
+
+            geometry.setReceiver(nominalPos);
+
+            if(numRows > 0)
+            {
+                geometry.compute( numRows, gData.column(satX),
+                                  gData.column(satY), gData.column(satZ),
+                                  &rhoVec[0], &dXVec[0], &dYVec[0], &dZVec[0],
+                                  &elevVec[0], &azimVec[0], &validVec[0] );
+            }
+
+            // Loop through all the satellites
+            for(int row = 0; row < numRows; row++)
+            {
+                if( !gData.isActive(row) ) continue;
+
+                if( !gData.hasValue(row, satX) ||
+                    !gData.hasValue(row, satY) ||
+                    !gData.hasValue(row, satZ) ||
+                    !gData.hasValue(row, relCol) ||
+                    !gData.hasValue(row, cdtSatCol) )
+                {
+                    gData.removeRow(row);
+                    continue;
+                }
+
+                // elevation or azimuth could not be computed, or the
+                // satellite is too low
+                if( !validVec[row] || elevVec[row] < minElev )
+                {
+                    gData.removeRow(row);
+                    continue;
+                }
+
+                gData.setValue(row, rhoCol, rhoVec[row]);
+
+                // Let's insert partials for station position at receive time
+                gData.setValue(row, dXCol, dXVec[row]);
+                gData.setValue(row, dYCol, dYVec[row]);
+                gData.setValue(row, dZCol, dZVec[row]);
+                gData.setValue(row, cdtCol, 1.0);
+
+                const SatID& sat( gData.getSat(row) );
+                if(sat.system == SatelliteSystem::GPS)
+                {
+                    gData.setValue(row, gData.addType(TypeID::dcdtGPS), 1.0);
+                }
+                else if(sat.system == SatelliteSystem::Galileo)
+                {
+                    gData.setValue(row, gData.addType(TypeID::dcdtGAL), 1.0);
+                }
+                else if(sat.system == SatelliteSystem::BDS)
+                {
+                    gData.setValue(row, gData.addType(TypeID::dcdtBDS), 1.0);
+                }
+                else if(sat.system == SatelliteSystem::GLONASS)
+                {
+                    gData.setValue(row, gData.addType(TypeID::dcdtGLO), 1.0);
+                }
+
+                gData.setValue(row, elevCol, elevVec[row]);
+                gData.setValue(row, azimCol, azimVec[row]);
+
+            } // End of loop for(row = 0...
+
+            return gData;
+
+        }   // End of try...
+        catch(Exception& u)
+        {
+            // Throw an exception if something unexpected happens
+            ProcessingException e( getClassName() + ":" + u.what() );
+            THROW(e);
+        }
+
+    }  // End of method 'ComputeDerivative::Process()'
+
 using namespace utilSpace;
 using namespace coordSpace;
 using namespace timeSpace;
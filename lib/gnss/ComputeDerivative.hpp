@@ -13,6 +13,8 @@
 #include "Position.hpp"
 #include "DataStructures.hpp"
 #include "Rx3ObsData.hpp"
+#include "SatTypeValueTable.hpp"
+#include "SatGeometry.hpp"
 
 using namespace utilSpace;
 using namespace coordSpace;
@@ -49,6 +51,11 @@ namespace gnssSpace
                                   satTypeValueMap& gData )
             noexcept(false);
 
+        /// Same as above, for the data in a satTypeValueTable.
+        satTypeValueTable& Process( const CommonTime& time,
+                                    satTypeValueTable& gData )
+            noexcept(false);
+
         /** Return a satTypeValueMap object, adding the new data generated
          *  when calling a modeling object.
          */
@@ -95,6 +102,19 @@ namespace gnssSpace
          /// Station position
         Position nominalPos;
 
+         /// Geometry of the satellites, with the frame of nominalPos
+        SatGeometry geometry;
+
+         /// Satellite positions and geometry of the epoch, as arrays
+         /// kept from one epoch to the next
+        std::vector<double> svX, svY, svZ;
+        std::vector<double> rhoVec, dXVec, dYVec, dZVec;
+        std::vector<double> elevVec, azimVec;
+        std::vector<char> validVec;
+
+         /// Make room for the geometry of n satellites
+        void resizeGeometry(int n);
+
     }; // End of class 'ComputeDerivative'
 
       //@}
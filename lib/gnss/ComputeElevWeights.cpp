@@ -46,7 +46,7 @@ namespace gnssSpace
 
         try
         {
-            SatIDSet satRejectedSet;
+            EpochSatIDSet satRejectedSet;
 
             // Loop through all the satellites
             for(satTypeValueMap::iterator it = gData.begin();
@@ -55,18 +55,15 @@ namespace gnssSpace
             {
                 SatID sat( it->first );
 
-                double elev( 0.0 );
-
-                try
-                {
-                    elev = gData.getValue( sat, TypeID::elevation );
-                }
-                catch(...)
+                const double* pElev( it->second.tryGet(TypeID::elevation) );
+                if( pElev == NULL )
                 {
                     satRejectedSet.insert( sat );
                     continue;
                 }
 
+                double elev( *pElev );
+
                 double weight;
 
                 // Compute the weight according to elevation
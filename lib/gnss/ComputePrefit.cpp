@@ -22,22 +22,38 @@ satTypeValueMap ComputePrefit::Process(const CommonTime& time,
 
 
             SatID sat = (*it).first;
-            double remainder = -(*it).second[TypeID::rho]+(*it).second[TypeID::cdtSat]-(*it).second[TypeID::tropoSlant]-(*it).second[TypeID::relativity]-(*it).second[TypeID::gravDelay];
+            // read each value on its own: operator[] inserts the missing
+            // ones, which may move the values of a flat typeValueMap
+            typeValueMap& tv( (*it).second );
+            double rho( tv[TypeID::rho] );
+            double cdtSat( tv[TypeID::cdtSat] );
+            double tropoSlant( tv[TypeID::tropoSlant] );
+            double relativity( tv[TypeID::relativity] );
+            double gravDelay( tv[TypeID::gravDelay] );
+            double remainder = -rho+cdtSat-tropoSlant-relativity-gravDelay;
 
 
             if(sat.system == SatelliteSystem::GPS){
-                (*it).second[TypeID::prefitC1G]=(*it).second[TypeID::C1G]+remainder;
-                (*it).second[TypeID::prefitC2G]=(*it).second[TypeID::C2G]+remainder;
-                (*it).second[TypeID::prefitL1G]=(*it).second[TypeID::L1G]+remainder;
-                (*it).second[TypeID::prefitL2G]=(*it).second[TypeID::L2G]+remainder;
+                double C1G( tv[TypeID::C1G] );
+                tv[TypeID::prefitC1G]=C1G+remainder;
+                double C2G( tv[TypeID::C2G] );
+                tv[TypeID::prefitC2G]=C2G+remainder;
+                double L1G( tv[TypeID::L1G] );
+                tv[TypeID::prefitL1G]=L1G+remainder;
+                double L2G( tv[TypeID::L2G] );
+                tv[TypeID::prefitL2G]=L2G+remainder;
 
 
 
             } else if(sat.system == SatelliteSystem::BDS){
-                (*it).second[TypeID::prefitC2C]=(*it).second[TypeID::C2C]+remainder;
-                (*it).second[TypeID::prefitC6C]=(*it).second[TypeID::C6C]+remainder;
-                (*it).second[TypeID::prefitL2C]=(*it).second[TypeID::L2C]+remainder;
-                (*it).second[TypeID::prefitL6C]=(*it).second[TypeID::L6C]+remainder;
+                double C2C( tv[TypeID::C2C] );
+                tv[TypeID::prefitC2C]=C2C+remainder;
+                double C6C( tv[TypeID::C6C] );
+                tv[TypeID::prefitC6C]=C6C+remainder;
+                double L2C( tv[TypeID::L2C] );
+                tv[TypeID::prefitL2C]=L2C+remainder;
+                double L6C( tv[TypeID::L6C] );
+                tv[TypeID::prefitL6C]=L6C+remainder;
             }
 
 
@@ -49,7 +49,7 @@ namespace gnssSpace
 
         try
         {
-            SatIDSet satRejectedSet;
+            EpochSatIDSet satRejectedSet;
 
             // Loop through all the satellites
             for(satTypeValueMap::iterator it = gData.begin();
@@ -113,11 +113,8 @@ namespace gnssSpace
 */
 
                    // code obs
-                   try
-                   {
-                       obs = (*it).second(codeType);
-                   }
-                   catch(TypeIDNotFound& e)
+                   const double* pObs( (*it).second.tryGet(codeType) );
+                   if(pObs == NULL)
                    {
                        // remove this satellite
                        satRejectedSet.insert(sat);
@@ -125,6 +122,7 @@ namespace gnssSpace
                        // the next satellite
                        continue;
                    }
+                   obs = *pObs;
 
                    // now, compute svPosVel
                    try
@@ -33,9 +33,15 @@ namespace gnssSpace
        * A typical way to use this class follows:
        *
        * @code
-       * 
+       *    ComputeSatPos computeSatPos(navStore);
+       *    computeSatPos.setRxPos(rxPos);
+       *    computeSatPos.Process(epoch, satShortTypes, stvData);
        * @endcode
        *
+       * With precise ephemeris, the orbits and clocks may be computed for
+       * all epochs of the observation file beforehand with SP3EpochStore,
+       * which is then given to the constructor instead of the SP3EphStore.
+       *
        *
        */
     class ComputeSatPos                         
@@ -83,6 +89,7 @@ namespace gnssSpace
             noexcept(false)
         {
             Process(rRin.currEpoch, rRin.satShortTypes, rRin.stvData);
+            return rRin;
         };
 
 
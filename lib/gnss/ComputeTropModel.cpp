@@ -14,6 +14,9 @@
 //============================================================================
 
 
+#include <cmath>
+#include <iomanip>
+
 #include "Exception.hpp"
 #include "ComputeTropModel.hpp"
 
@@ -29,6 +32,92 @@ namespace gnssSpace
     { return "ComputeTropModel"; }
 
 
+    bool ComputeTropModel::CacheKey::operator<(const CacheKey& right) const
+    {
+        if(day != right.day) return day < right.day;
+        if(timeBucket != right.timeBucket) return timeBucket < right.timeBucket;
+        if(x != right.x) return x < right.x;
+        if(y != right.y) return y < right.y;
+        if(z != right.z) return z < right.z;
+        return station < right.station;
+    }
+
+
+      /* Set the time and receiver position of the model, from the cache
+       * when another call fell in the same buckets.
+       *
+       * The time buckets don't cross the days, so that the models using
+       * the day of year (Neill) get the right one.
+       *
+       * @param time      Epoch.
+       * @param rxPos     Receiver position.
+       */
+    ComputeTropModel& ComputeTropModel::setAllParameters( const CommonTime& time,
+                                                          const Position& rxPos )
+        noexcept(false)
+    {
+        if(pTropModel == NULL)
+        {
+            InvalidRequest ir(getClassName() + "pTropModel is NULL");
+            THROW(ir);
+        }
+
+        if( !useCache || cacheSeconds <= 0.0 || cacheMeters <= 0.0 )
+        {
+            (*pTropModel).setAllParameters(time, rxPos);
+            return (*this);
+        }
+
+        long day, sod;
+        double fsod;
+        time.get(day, sod, fsod);
+
+        CacheKey key;
+        key.station = station;
+        key.day = day;
+        key.timeBucket = long( std::floor( (sod + fsod)/cacheSeconds ) );
+        key.x = long( std::floor( rxPos.X()/cacheMeters ) );
+        key.y = long( std::floor( rxPos.Y()/cacheMeters ) );
+        key.z = long( std::floor( rxPos.Z()/cacheMeters ) );
+
+        std::map<CacheKey, std::vector<double> >::const_iterator it(
+                                                            cache.find(key) );
+        if(it != cache.end())
+        {
+            (*pTropModel).restoreParameters(it->second);
+            cacheHits++;
+            return (*this);
+        }
+
+        (*pTropModel).setAllParameters(time, rxPos);
+        cacheMisses++;
+
+        std::vector<double> params;
+        if( (*pTropModel).isValid() && (*pTropModel).saveParameters(params) )
+        {
+            if(cache.size() >= maxCacheEntries) cache.clear();
+            cache[key] = params;
+        }
+
+        return (*this);
+
+    }  // End of method 'ComputeTropModel::setAllParameters()'
+
+
+      // Print the hits and misses of the cache
+    void ComputeTropModel::dumpCacheStats(std::ostream& s) const
+    {
+        unsigned long calls( cacheHits + cacheMisses );
+
+        s << getClassName() << " cache: " << calls << " calls, "
+          << cacheHits << " hits (" << fixed << setprecision(1)
+          << (calls > 0 ? 100.0*cacheHits/calls : 0.0) << "%), "
+          << cacheMisses << " misses, " << cache.size() << " entries"
+          << endl;
+
+    }  // End of method 'ComputeTropModel::dumpCacheStats()'
+
+
 
       /* Return a satTypeValueMap object, adding the new data generated when
        * calling a modeling object.
@@ -43,7 +132,7 @@ namespace gnssSpace
 
         try
         {
-            SatIDSet satRejectedSet;
+            EpochSatIDSet satRejectedSet;
 
             // Loop through all the satellites
             for(satTypeValueMap::iterator it = gData.begin();
@@ -63,7 +152,8 @@ namespace gnssSpace
                 }
 
                 // If satellite elevation is missing, remove satellite
-                if( (*it).second.find(TypeID::elevation) == (*it).second.end() )
+                const double* pElevation( (*it).second.tryGet(TypeID::elevation) );
+                if( pElevation == NULL )
                 {
                     satRejectedSet.insert( sat );
                     continue;
@@ -72,7 +162,7 @@ namespace gnssSpace
                 {
 
                     // Scalar to hold satellite elevation
-                    double elevation( (*it).second(TypeID::elevation) );
+                    double elevation( *pElevation );
                     double tropoCorr(0.0), dryZDelay(0.0), wetZDelay(0.0);
                     double dryMap(0.0), wetMap(0.0);
 
@@ -130,6 +220,99 @@ namespace gnssSpace
     } // End ComputeTropModel::Process()
 
 
+      /* Same as above, for the data in a satTypeValueTable.
+       *
+       * @param time      Epoch.
+       * @param gData     Data object holding the data.
+       */
+    satTypeValueTable& ComputeTropModel::Process( const CommonTime& time,
+                                                  satTypeValueTable& gData )
+        noexcept(false)
+    {
+
+        try
+        {
+            // First check if TropModel was set
+            if(pTropModel == NULL)
+            {
+                cerr << "no trop model found" << endl;
+                exit(-1);
+            }
+
+            const int elevCol( gData.typeIndex(TypeID::elevation) );
+
+            const int slantCol( gData.addType(TypeID::tropoSlant) );
+            const int dryCol( gData.addType(TypeID::dryTropo) );
+            const int wetCol( gData.addType(TypeID::wetTropo) );
+            const int dryMapCol( gData.addType(TypeID::dryMap) );
+            const int wetMapCol( gData.addType(TypeID::wetMap) );
+
+            // Loop through all the satellites
+            for(int row = 0; row < gData.numRows(); row++)
+            {
+                if( !gData.isActive(row) ) continue;
+
+                // If satellite elevation is missing, remove satellite
+                if( elevCol < 0 || !gData.hasValue(row, elevCol) )
+                {
+                    gData.removeRow(row);
+                    continue;
+                }
+
+                // Scalar to hold satellite elevation
+                double elevation( gData.value(row, elevCol) );
+                double tropoCorr(0.0), dryZDelay(0.0), wetZDelay(0.0);
+                double dryMap(0.0), wetMap(0.0);
+
+                try
+                {
+                    // Compute tropospheric slant correction
+                    tropoCorr = pTropModel->correction(elevation);
+                    dryZDelay = pTropModel->dry_zenith_delay();
+                    wetZDelay = pTropModel->wet_zenith_delay();
+                    dryMap = pTropModel->dry_mapping_function(elevation);
+                    wetMap = pTropModel->wet_mapping_function(elevation);
+
+                    // Check validity
+                    if( !(pTropModel->isValid()) )
+                    {
+                        tropoCorr = 0.0;
+                        dryZDelay = 0.0;
+                        wetZDelay = 0.0;
+                        dryMap    = 0.0;
+                        wetMap    = 0.0;
+                    }
+
+                }
+                catch(InvalidTropModel& e)
+                {
+                    // If some problem appears, then remove this satellite
+                    gData.removeRow(row);
+                    continue;
+                }
+
+                // Now we have to add the new values to the data structure
+                gData.setValue(row, slantCol, tropoCorr);
+                gData.setValue(row, dryCol, dryZDelay);
+                gData.setValue(row, wetCol, wetZDelay);
+                gData.setValue(row, dryMapCol, dryMap);
+                gData.setValue(row, wetMapCol, wetMap);
+
+            }  // End of loop 'for(row = 0...'
+
+            return gData;
+
+        }   // End of try...
+        catch(Exception& u)
+        {
+            // Throw an exception if something unexpected happens
+            ProcessingException e( getClassName() + ":" + u.what() );
+            THROW(e);
+        }
+
+    } // End ComputeTropModel::Process()
+
+
 using namespace utilSpace;
 using namespace coordSpace;
 using namespace timeSpace;
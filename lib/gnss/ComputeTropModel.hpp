@@ -13,8 +13,14 @@
 #ifndef COMPUTETROPMODEL_HPP
 #define COMPUTETROPMODEL_HPP
 
+#include <map>
+#include <vector>
+#include <string>
+#include <ostream>
+
 #include "TropModel.hpp"
 #include "Rx3ObsData.hpp"
+#include "SatTypeValueTable.hpp"
 
 using namespace utilSpace;
 
@@ -77,7 +83,11 @@ namespace gnssSpace
     public:
 
          /// Default constructor.
-        ComputeTropModel() : pTropModel(NULL) {};
+        ComputeTropModel()
+            : pTropModel(NULL), useCache(false),
+              cacheSeconds(3600.0), cacheMeters(10.0),
+              maxCacheEntries(10000), cacheHits(0), cacheMisses(0)
+        {};
 
 
          /** Explicit constructor.
@@ -86,7 +96,10 @@ namespace gnssSpace
           *
           */
         ComputeTropModel(TropModel& tropoModel)
-        { pTropModel = &tropoModel; };
+            : pTropModel(&tropoModel), useCache(false),
+              cacheSeconds(3600.0), cacheMeters(10.0),
+              maxCacheEntries(10000), cacheHits(0), cacheMisses(0)
+        {};
 
 
          /** Return a satTypeValueMap object, adding the new data generated
@@ -100,6 +113,12 @@ namespace gnssSpace
             noexcept(false);
 
 
+         /// Same as above, for the data in a satTypeValueTable.
+        virtual satTypeValueTable& Process( const CommonTime& time,
+                                            satTypeValueTable& gData )
+            noexcept(false);
+
+
         virtual void Process(Rx3ObsData& rRin)
             noexcept(false)
         {
@@ -119,22 +138,67 @@ namespace gnssSpace
          */
         virtual ComputeTropModel& setTropModel(TropModel& tropoModel)
         { 
-            pTropModel = &tropoModel; return (*this); 
+            pTropModel = &tropoModel; cache.clear(); return (*this); 
         };
 
+
+         /** Set the time and receiver position of the model.
+          *
+          * With the cache on, the parameters the model computes from them
+          * (weather, zenith delays, mapping function coefficients) are
+          * kept by station, time bucket and position bucket, and given
+          * back to the model instead of being computed again when another
+          * call falls in the same buckets, e.g. at the next iteration of
+          * an epoch or at the next epoch of a static receiver.
+          *
+          * @throw InvalidRequest if the model is not given
+          */
         virtual ComputeTropModel& setAllParameters( const CommonTime& time,
                                                     const Position& rxPos)
-        {
-            if(pTropModel!=NULL)
-            {
-                (*pTropModel).setAllParameters(time, rxPos);
-            }
-            else
-            {
-                InvalidRequest ir(getClassName() + "pTropModel is NULL");
-                THROW(ir);
-            }
-        };
+            noexcept(false);
+
+
+         /** Keep the parameters of the model between calls of
+          *  setAllParameters() (off by default). Models that can't give
+          *  their parameters back (see TropModel::saveParameters()) are
+          *  computed at each call anyway.
+          */
+        virtual ComputeTropModel& setCache(bool use)
+        { useCache = use; cache.clear(); return (*this); };
+
+         /** Size of the buckets of the cache: a time span within a day,
+          *  in seconds (3600 by default), and the side of a cube of ECEF
+          *  positions, in meters (10 by default). Within a bucket, the
+          *  parameters of its first call are used.
+          */
+        virtual ComputeTropModel& setCacheSteps( double seconds,
+                                                 double meters )
+        { cacheSeconds = seconds; cacheMeters = meters; cache.clear();
+          return (*this); };
+
+         /// Largest number of entries of the cache (10000 by default); it
+         /// is emptied when full
+        virtual ComputeTropModel& setMaxCacheEntries(size_t num)
+        { maxCacheEntries = num; return (*this); };
+
+         /// Station the next calls are for, part of the keys of the cache
+        virtual ComputeTropModel& setStation(const std::string& name)
+        { station = name; return (*this); };
+
+         /// Empty the cache, keeping the statistics
+        virtual void clearCache()
+        { cache.clear(); };
+
+         /// Calls of setAllParameters() served from the cache
+        virtual unsigned long getCacheHits() const
+        { return cacheHits; };
+
+         /// Calls of setAllParameters() that computed the model
+        virtual unsigned long getCacheMisses() const
+        { return cacheMisses; };
+
+         /// Print the hits and misses of the cache
+        virtual void dumpCacheStats(std::ostream& s) const;
 
 
          /// Return a string identifying this object.
@@ -147,12 +211,35 @@ namespace gnssSpace
 
     private:
 
+         /// Key of the cache: station, day and time bucket in the day,
+         /// and position bucket
+        struct CacheKey
+        {
+            std::string station;
+            long day;
+            long timeBucket;
+            long x, y, z;
+
+            bool operator<(const CacheKey& right) const;
+        };
+
         double tropo;
 
          /// Pointer to default TropModel object when working with GNSS
          /// data structures.
         TropModel *pTropModel;
 
+        bool useCache;
+        double cacheSeconds;
+        double cacheMeters;
+        size_t maxCacheEntries;
+        std::string station;
+
+        std::map<CacheKey, std::vector<double> > cache;
+
+        unsigned long cacheHits;
+        unsigned long cacheMisses;
+
 
     }; // End of class 'ComputeTropModel'
 
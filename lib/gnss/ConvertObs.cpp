@@ -37,7 +37,7 @@ namespace gnssSpace
     {
         try
         {
-            SatIDSet satRejectedSet;
+            EpochSatIDSet satRejectedSet;
 
             // Loop through all the satellites
             for(auto it = gData.begin(); it != gData.end(); ++it)
@@ -71,7 +71,10 @@ namespace gnssSpace
                     if( (*it).second.find(shortType) == (*it).second.end() &&
                         (*it).second.find( TypeID(longTypeStr) ) != (*it).second.end() )
                     {
-                        (*it).second[shortType] = (*it).second[TypeID(longTypeStr)];
+                        // read first: inserting shortType may move the
+                        // values of a flat typeValueMap
+                        double value( (*it).second[TypeID(longTypeStr)] );
+                        (*it).second[shortType] = value;
 
                         shortTypes.push_back(shortType);
                     }
@@ -610,6 +610,24 @@ namespace gnssSpace
     }  // End of method 'satTypeValueMap::removeSatID()'
 
 
+    // Modifies this object, removing these satellites.
+    // @param satSet Set (EpochSatIDSet) containing the satellites
+    //               to be removed.
+    satTypeValueMap& satTypeValueMap::removeSatID(const EpochSatIDSet& satSet)
+    {
+
+        for( EpochSatIDSet::const_iterator pos = satSet.begin();
+             pos != satSet.end();
+             ++pos )
+        {
+            (*this).erase(*pos);
+        }
+
+        return (*this);
+
+    }  // End of method 'satTypeValueMap::removeSatID()'
+
+
 
 
       /* Return the data value (double) corresponding to provided SatID
@@ -36,6 +36,7 @@
 #include <fstream>
 
 #include "StringUtils.hpp"
+#include "EpochArena.hpp"
 #include "CivilTime.hpp"
 #include "YDSTime.hpp"
 #include "constants.hpp"
@@ -44,6 +45,10 @@
 #include "SourceID.hpp"
 #include "MiscMath.hpp"
 
+#ifdef USE_FLAT_TYPEVALUEMAP
+#include "FlatTypeValueMap.hpp"
+#endif
+
 using namespace std;
 
 using namespace utilSpace;
@@ -92,10 +97,19 @@ namespace gnssSpace
 
        /// Set containing SatID objects.
     typedef std::set<SatID> SatIDSet;
+
+       /// Set of SatID for the temporaries of one epoch (EpochArena)
+    typedef EpochSet<SatID> EpochSatIDSet;
     typedef std::set<SourceID> SourceIDSet;
 
        /// Map holding TypeID with corresponding numeric value.
+       /// It is a std::map, or a sorted vector (FlatTypeValueMap) if
+       /// USE_FLAT_TYPEVALUEMAP is defined.
+#ifdef USE_FLAT_TYPEVALUEMAP
+    struct typeValueMap : FlatTypeValueMap
+#else
     struct typeValueMap : std::map<TypeID, double>
+#endif
     {
 
         /// Return the number of different types available.
@@ -153,6 +167,27 @@ namespace gnssSpace
             noexcept(false);
 
 
+         /** Return a pointer to the data value with corresponding type, or
+          *  NULL if there is no such value. Unlike getValue() and
+          *  operator(), it does not throw, so it is the one to use when a
+          *  missing value is a normal case.
+          *
+          * @param type Type of value to be looked for.
+          */
+        const double* tryGet(const TypeID& type) const
+        {
+            typeValueMap::const_iterator itObs( (*this).find(type) );
+            return ( itObs != (*this).end() ) ? &(*itObs).second : NULL;
+        }
+
+         /// Same as above, for a value that may be modified.
+        double* tryGet(const TypeID& type)
+        {
+            typeValueMap::iterator itObs( (*this).find(type) );
+            return ( itObs != (*this).end() ) ? &(*itObs).second : NULL;
+        }
+
+
          /// Convenience output method
         virtual std::ostream& dump( std::ostream& s,
                                     int mode = 0 ) const;
@@ -324,6 +359,11 @@ namespace gnssSpace
          ///               to be removed.
         satTypeValueMap& removeSatID(const SatIDSet& satSet);
 
+         /// Modifies this object, removing these satellites.
+         /// @param satSet Set (EpochSatIDSet) containing the satellites
+         ///               to be removed.
+        satTypeValueMap& removeSatID(const EpochSatIDSet& satSet);
+
          /// Modifies this object, removing this type of data.
          /// @param type Type of value to be removed.
         satTypeValueMap& removeTypeID(const TypeID& type);
@@ -345,6 +385,38 @@ namespace gnssSpace
         typeValueMap& operator()(const SatID& satellite) ;
 
 
+         /** Return a pointer to the typeValueMap with corresponding SatID,
+          *  or NULL if the satellite is not found. It does not throw.
+          *
+          * @param satellite     Satellite to be looked for.
+          */
+        const typeValueMap* tryGet(const SatID& satellite) const
+        {
+            satTypeValueMap::const_iterator itObs( (*this).find(satellite) );
+            return ( itObs != (*this).end() ) ? &(*itObs).second : NULL;
+        }
+
+         /// Same as above, for data that may be modified.
+        typeValueMap* tryGet(const SatID& satellite)
+        {
+            satTypeValueMap::iterator itObs( (*this).find(satellite) );
+            return ( itObs != (*this).end() ) ? &(*itObs).second : NULL;
+        }
+
+         /** Return a pointer to the data value with corresponding SatID and
+          *  TypeID, or NULL if there is no such value. It does not throw.
+          *
+          * @param satellite     Satellite to be looked for.
+          * @param type          Type to be looked for.
+          */
+        const double* tryGet( const SatID& satellite,
+                              const TypeID& type ) const
+        {
+            const typeValueMap* tvData( tryGet(satellite) );
+            return ( tvData != NULL ) ? tvData->tryGet(type) : NULL;
+        }
+
+
          /// Convenience output method
         virtual std::ostream& dump( std::ostream& s,
                                     int mode = 0 ) const;
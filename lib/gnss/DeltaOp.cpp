@@ -12,20 +12,20 @@ namespace gnssSpace{
     }
 
     void DeltaOp::Process(satTypeValueMap &rxDataRover, satTypeValueMap &rxDataBase) {
-        SatIDSet satRejectedSet;
-        list<TypeID> difflist;
+        EpochSatIDSet satRejectedSet;
 
 
         try {
             for (satTypeValueMap::iterator it = rxDataRover.begin();
                  it != rxDataRover.end();
                  ++it) {
-                if(rxDataBase.find(it->first)==rxDataBase.end()){
+                satTypeValueMap::iterator itBase = rxDataBase.find(it->first);
+                if(itBase==rxDataBase.end()){
                     satRejectedSet.insert(it->first);
                     continue;
                 }
 
-                difflist = systemDiffs[(*it).first.system];
+                const list<TypeID>& difflist = systemDiffs[(*it).first.system];
 
                 // Loop through all the defined linear combinations
                 for (auto pos = difflist.begin(); pos != difflist.end(); ++pos) {
@@ -34,9 +34,8 @@ namespace gnssSpace{
 
                     bool valid( true );
 
-                    result = it->second.getValue(pos->type)-rxDataBase[it->first].getValue(pos->type);
-                    string type = pos->asString()+"Diff";
-                    it->second[type] = result;
+                    result = it->second.getValue(pos->type)-itBase->second.getValue(pos->type);
+                    it->second[diffOf(*pos)] = result;
                 }
 
                 it->second[TypeID::N1]=1;
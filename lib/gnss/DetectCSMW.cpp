@@ -7,6 +7,8 @@
  */
 
 
+#include <stdint.h>
+
 #include "DetectCSMW.hpp"
 
 using namespace std;
@@ -56,7 +58,7 @@ namespace gnssSpace
         {
             double value(0.0);
 
-            SatIDSet satRejectedSet;
+            EpochSatIDSet satRejectedSet;
 
             // Loop through all the satellites
             for(satTypeValueMap::iterator it = gData.begin();
@@ -67,7 +69,7 @@ namespace gnssSpace
                 SatelliteSystem sys = sat.system;
 
                 // get mwType for current system
-                TypeIDSet mwTypeSet = sysTypeSet[sys];
+                const TypeIDSet& mwTypeSet( sysTypeSet[sys] );
 
                 for(auto typeIt=mwTypeSet.begin(); typeIt!=mwTypeSet.end(); typeIt++)
                 {
@@ -85,15 +87,13 @@ namespace gnssSpace
                     // get variance of MW-combinations
                     varianceMW = varOfMW(sys, mwType);
 
-                    try
-                    {
-                        // Try to extract the values
-                        value = (*it).second(mwType);
-                    }
-                    catch(...)
+                    // Try to extract the values
+                    const double* pValue( (*it).second.tryGet(mwType) );
+                    if( pValue == NULL )
                     {
                         continue;
                     }
+                    value = *pValue;
 
                     // If everything is OK, then get the new values inside the
                     // structure. This way of computing it allows concatenation of
@@ -169,9 +169,12 @@ namespace gnssSpace
         // Difference between current and former MW values
         double currentBias(0.0);
 
+        // Filter data of this satellite and type
+        filterData& fd( mwData(sat, mwType) );
+
         // Get the difference between current epoch and former epoch,
         // in seconds
-        currentDeltaT = (epoch - mwData[sat][mwType].formerEpoch);
+        currentDeltaT = (epoch - fd.formerEpoch);
 
         if(debug)
         {
@@ -181,10 +184,10 @@ namespace gnssSpace
         }
 
         // Store current epoch as former epoch
-        mwData[sat][mwType].formerEpoch = epoch;
+        fd.formerEpoch = epoch;
 
         // Difference between current value of MW and average value
-        currentBias = std::abs(mw - mwData[sat][mwType].meanMW);
+        currentBias = std::abs(mw - fd.meanMW);
 
         if(debug)
         {
@@ -192,7 +195,7 @@ namespace gnssSpace
         }
 
         // Increment window size
-        mwData[sat][mwType].windowSize++;
+        fd.windowSize++;
 
         /**
          * cycle-slip condition
@@ -200,7 +203,7 @@ namespace gnssSpace
          * 1. if data interrupt for a given time gap, then cyce slip should be set
          * 2. if current bias is greater than 1 cycle and greater than 4 sigma of mean mw.
          */
-        double sigLimit = 4 * std::sqrt( mwData[sat][mwType].varMW ) ;
+        double sigLimit = 4 * std::sqrt( fd.varMW ) ;
 
         if(debug)
         {
@@ -216,9 +219,9 @@ namespace gnssSpace
             // if cycle slip happened
 
             // reset the filter window size/meanMW/InitialVarofMW
-            mwData[sat][mwType].meanMW     = mw;
-            mwData[sat][mwType].varMW      = varianceMW;
-            mwData[sat][mwType].windowSize = 1;
+            fd.meanMW     = mw;
+            fd.varMW      = varianceMW;
+            fd.windowSize = 1;
 
             if(debug)
             {
@@ -230,19 +233,75 @@ namespace gnssSpace
 
 
         // MW bias from the mean value
-        double mwBias(mw - mwData[sat][mwType].meanMW);
-        double size( static_cast<double>(mwData[sat][mwType].windowSize) );
+        double mwBias(mw - fd.meanMW);
+        double size( static_cast<double>(fd.windowSize) );
 
         // Compute average
-        mwData[sat][mwType].meanMW += mwBias / size;
+        fd.meanMW += mwBias / size;
 
         // Compute variance
         // Var(i) = Var(i-1) + [ ( mw(i) - meanMW)^2/(i)- 1*Var(i-1) ]/(i);
-        mwData[sat][mwType].varMW  += ( mwBias*mwBias - mwData[sat][mwType].varMW ) / size;
+        fd.varMW  += ( mwBias*mwBias - fd.varMW ) / size;
 
         return 0.0;
 
     }  // End of method 'DetectCSMW::getDetection()'
 
 
+      // Write the MW windows of every satellite and type
+    void DetectCSMW::saveState(StateWriter& writer) const
+    {
+        writer.beginBlock(getClassName(), 1);
+
+        std::vector<TypeID> types( mwData.getTypes() );
+        writer.put( uint32_t(types.size()) );
+        for(size_t t=0; t<types.size(); t++)
+        {
+            std::vector<SatID> sats( mwData.getSats(types[t]) );
+
+            writer.putType(types[t]);
+            writer.put( uint32_t(sats.size()) );
+            for(size_t i=0; i<sats.size(); i++)
+            {
+                const filterData& fd( mwData.at(sats[i], types[t]) );
+
+                writer.putSat(sats[i]);
+                writer.putTime(fd.formerEpoch);
+                writer.put( int32_t(fd.windowSize) );
+                writer.put(fd.meanMW);
+                writer.put(fd.varMW);
+            }
+        }
+
+    }  // End of method 'DetectCSMW::saveState()'
+
+
+      // Restore a state written by saveState()
+    void DetectCSMW::restoreState(StateReader& reader)
+        noexcept(false)
+    {
+        reader.checkBlock(getClassName(), 1);
+
+        mwData.clear();
+
+        uint32_t numTypes( reader.get<uint32_t>() );
+        for(uint32_t t=0; t<numTypes; t++)
+        {
+            TypeID type( reader.getType() );
+
+            uint32_t numSats( reader.get<uint32_t>() );
+            for(uint32_t i=0; i<numSats; i++)
+            {
+                filterData& fd( mwData(reader.getSat(), type) );
+
+                fd.formerEpoch = reader.getTime();
+                fd.windowSize = reader.get<int32_t>();
+                fd.meanMW = reader.get<double>();
+                fd.varMW = reader.get<double>();
+            }
+        }
+
+    }  // End of method 'DetectCSMW::restoreState()'
+
+
 }  // End of namespace gnssSpace
@@ -24,6 +24,8 @@
 #include "DataStructures.hpp"
 #include "Rx3ObsData.hpp"
 #include "LinearCombinations.hpp"
+#include "SatIndex.hpp"
+#include "ProcessorState.hpp"
 
 using namespace utilSpace;
 using namespace timeSpace;
@@ -177,6 +179,22 @@ namespace gnssSpace
         };
 
 
+        /** Write the MW windows (mean, variance, size and last epoch) of
+         *  every satellite and type, to start another object from them
+         *  with restoreState().
+         */
+        virtual void saveState(StateWriter& writer) const;
+
+
+        /** Restore a state written by saveState(). The settings of this
+         *  object are kept.
+         *
+         * @throw InvalidRequest if the state is not one of DetectCSMW
+         */
+        virtual void restoreState(StateReader& reader)
+            noexcept(false);
+
+
         /// Return a string identifying this object.
         virtual std::string getClassName(void) const;
 
@@ -208,7 +226,7 @@ namespace gnssSpace
         {
             // Default constructor initializing the data in the structure
             filterData() : formerEpoch(CommonTime::BEGINNING_OF_TIME),
-                           windowSize(0), meanMW(0.0)
+                           windowSize(0), meanMW(0.0), varMW(0.0)
             {};
 
             CommonTime formerEpoch; ///< The previous epoch time stamp.
@@ -217,9 +235,9 @@ namespace gnssSpace
             double varMW;           ///< Accumulated std value of combination.
         };
 
-        typedef std::map<SatID, std::map<TypeID, filterData>> MWData;
+        typedef SatTypeStateArray<filterData> MWData;
 
-        /// Map holding the information regarding every satellite
+        /// Filter data of every satellite and type
         MWData mwData;
 
         /** Method that implements the Melbourne-Wubbena cycle slip
@@ -0,0 +1,328 @@
+/**
+ * @file EpochBinFile.cpp
+ * Binary files of processed epochs.
+ */
+
+#include <cstring>
+#include <stdint.h>
+
+#include "EpochBinFile.hpp"
+
+using namespace std;
+
+namespace gnssSpace
+{
+
+    const char EpochBinFormat::magic[8] = { 'G','B','X','E','P','O','C','H' };
+
+
+    namespace
+    {
+          // append a value to a record
+        template <class T>
+        void put(std::vector<char>& buffer, const T& value)
+        {
+            const char* p( reinterpret_cast<const char*>(&value) );
+            buffer.insert(buffer.end(), p, p + sizeof(T));
+        }
+
+          // take a value from a record, checking its end
+        template <class T>
+        T get(const char*& p, const char* end)
+            noexcept(false)
+        {
+            if(p + sizeof(T) > end)
+            {
+                FFStreamError e("EpochBinReader: truncated record");
+                THROW(e);
+            }
+
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            p += sizeof(T);
+            return value;
+        }
+    }
+
+
+      // Create the file and write its header
+    void EpochBinWriter::open(const std::string& fileName)
+        noexcept(false)
+    {
+        close();
+
+        strm.open(fileName.c_str(), ios::out | ios::binary);
+        if(!strm)
+        {
+            FileMissingException e("EpochBinWriter: can't create " + fileName);
+            THROW(e);
+        }
+
+        typeWritten.assign(TypeID::count, 0);
+
+        strm.write(EpochBinFormat::magic, sizeof(EpochBinFormat::magic));
+        uint32_t header[2] = { EpochBinFormat::version,
+                               EpochBinFormat::byteOrderMark };
+        strm.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    }  // End of method 'EpochBinWriter::open()'
+
+
+      // Write an epoch
+    void EpochBinWriter::write( const CommonTime& epoch,
+                                const SourceID& source,
+                                const Triple& rcvPos,
+                                const satTypeValueMap& stvData )
+        noexcept(false)
+    {
+        if(!strm.is_open())
+        {
+            InvalidRequest e("EpochBinWriter: file not open");
+            THROW(e);
+        }
+
+        // first, the types used for the first time
+        for(satTypeValueMap::const_iterator it = stvData.begin();
+            it != stvData.end();
+            ++it)
+        {
+            for(typeValueMap::const_iterator itType = (*it).second.begin();
+                itType != (*it).second.end();
+                ++itType)
+            {
+                const TypeID& type( (*itType).first );
+                if(typeWritten[type.type]) continue;
+
+                string name( type.asString() );
+                char tag('T');
+                uint32_t size( sizeof(uint16_t) + name.size() );
+                uint16_t code( type.type );
+                strm.write(&tag, 1);
+                strm.write(reinterpret_cast<const char*>(&size), sizeof(size));
+                strm.write(reinterpret_cast<const char*>(&code), sizeof(code));
+                strm.write(name.data(), name.size());
+
+                typeWritten[type.type] = 1;
+            }
+        }
+
+        // then the epoch
+        buffer.clear();
+
+        long day, msod;
+        double fsod;
+        TimeSystem timeSys;
+        epoch.getInternal(day, msod, fsod, timeSys);
+        put(buffer, int32_t(day));
+        put(buffer, int32_t(msod));
+        put(buffer, fsod);
+        put(buffer, int32_t(timeSys.getTimeSystem()));
+
+        string name( source.sourceName.substr(0, 255) );
+        put(buffer, uint8_t(name.size()));
+        buffer.insert(buffer.end(), name.begin(), name.end());
+
+        put(buffer, rcvPos[0]);
+        put(buffer, rcvPos[1]);
+        put(buffer, rcvPos[2]);
+
+        put(buffer, uint16_t(stvData.size()));
+        for(satTypeValueMap::const_iterator it = stvData.begin();
+            it != stvData.end();
+            ++it)
+        {
+            put(buffer, (*it).first.systemChar());
+            put(buffer, int16_t((*it).first.id));
+            put(buffer, uint16_t((*it).second.size()));
+
+            for(typeValueMap::const_iterator itType = (*it).second.begin();
+                itType != (*it).second.end();
+                ++itType)
+            {
+                put(buffer, uint16_t((*itType).first.type));
+                put(buffer, (*itType).second);
+            }
+        }
+
+        char tag('E');
+        uint32_t size( buffer.size() );
+        strm.write(&tag, 1);
+        strm.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        strm.write(buffer.data(), buffer.size());
+
+        if(!strm)
+        {
+            FFStreamError e("EpochBinWriter: error writing the file");
+            THROW(e);
+        }
+
+    }  // End of method 'EpochBinWriter::write()'
+
+
+      // Flush and close the file
+    void EpochBinWriter::close()
+    {
+        if(strm.is_open()) strm.close();
+    }
+
+
+      // Open the file and check its header
+    void EpochBinReader::open(const std::string& fileName)
+        noexcept(false)
+    {
+        if(strm.is_open()) strm.close();
+        strm.clear();
+
+        strm.open(fileName.c_str(), ios::in | ios::binary);
+        if(!strm)
+        {
+            FileMissingException e("EpochBinReader: can't open " + fileName);
+            THROW(e);
+        }
+
+        char magic[8];
+        uint32_t header[2];
+        strm.read(magic, sizeof(magic));
+        strm.read(reinterpret_cast<char*>(header), sizeof(header));
+        if( !strm ||
+            std::memcmp(magic, EpochBinFormat::magic, sizeof(magic)) != 0 )
+        {
+            FFStreamError e("EpochBinReader: not an epoch file: " + fileName);
+            THROW(e);
+        }
+
+        if(header[1] != EpochBinFormat::byteOrderMark)
+        {
+            FFStreamError e("EpochBinReader: byte order of " + fileName
+                            + " differs from this machine");
+            THROW(e);
+        }
+
+        fileVersion = header[0];
+        if(fileVersion > EpochBinFormat::version)
+        {
+            FFStreamError e("EpochBinReader: " + fileName
+                            + " has a newer format version");
+            THROW(e);
+        }
+
+        typeOfCode.clear();
+
+    }  // End of method 'EpochBinReader::open()'
+
+
+      // Read the next record, returning its tag. false at end of file.
+    bool EpochBinReader::readRecord(char& tag)
+        noexcept(false)
+    {
+        uint32_t size;
+        if( !strm.read(&tag, 1) ) return false;
+        if( !strm.read(reinterpret_cast<char*>(&size), sizeof(size)) )
+        {
+            FFStreamError e("EpochBinReader: truncated record");
+            THROW(e);
+        }
+
+        buffer.resize(size);
+        if( size > 0 && !strm.read(buffer.data(), size) )
+        {
+            FFStreamError e("EpochBinReader: truncated record");
+            THROW(e);
+        }
+
+        return true;
+
+    }  // End of method 'EpochBinReader::readRecord()'
+
+
+      // Read the next epoch
+    void EpochBinReader::read( CommonTime& epoch,
+                               SourceID& source,
+                               Triple& rcvPos,
+                               satTypeValueMap& stvData )
+        noexcept(false)
+    {
+        char tag;
+        while(true)
+        {
+            if( !readRecord(tag) )
+            {
+                EndOfFile e("EpochBinReader: end of file");
+                THROW(e);
+            }
+
+            if(tag == 'E') break;
+            if(tag != 'T') continue;
+
+            // a type: its name is looked for in this build
+            const char* p( buffer.data() );
+            const char* end( p + buffer.size() );
+            uint16_t code( get<uint16_t>(p, end) );
+            string name(p, end);
+
+            if(code >= typeOfCode.size()) typeOfCode.resize(code + 1);
+            try
+            {
+                typeOfCode[code] = TypeID(name);
+            }
+            catch(InvalidType& e)
+            {
+                typeOfCode[code] = TypeID::Unknown;
+            }
+        }
+
+        const char* p( buffer.data() );
+        const char* end( p + buffer.size() );
+
+        int32_t day( get<int32_t>(p, end) );
+        int32_t msod( get<int32_t>(p, end) );
+        double fsod( get<double>(p, end) );
+        int32_t timeSys( get<int32_t>(p, end) );
+        epoch.setInternal( day, msod, fsod,
+                           static_cast<TimeSystem::Systems>(timeSys) );
+
+        uint8_t nameSize( get<uint8_t>(p, end) );
+        if(p + nameSize > end)
+        {
+            FFStreamError e("EpochBinReader: truncated record");
+            THROW(e);
+        }
+        source.sourceName.assign(p, nameSize);
+        p += nameSize;
+
+        rcvPos[0] = get<double>(p, end);
+        rcvPos[1] = get<double>(p, end);
+        rcvPos[2] = get<double>(p, end);
+
+        stvData.clear();
+        uint16_t numSats( get<uint16_t>(p, end) );
+        for(int i=0; i<numSats; i++)
+        {
+            char sysChar( get<char>(p, end) );
+            int16_t prn( get<int16_t>(p, end) );
+            uint16_t numTypes( get<uint16_t>(p, end) );
+
+            SatelliteSystem sys;
+            sys.fromChar(sysChar);
+            typeValueMap& tvData( stvData[SatID(prn, sys.system)] );
+
+            for(int j=0; j<numTypes; j++)
+            {
+                uint16_t code( get<uint16_t>(p, end) );
+                double value( get<double>(p, end) );
+
+                if( code >= typeOfCode.size() )
+                {
+                    FFStreamError e("EpochBinReader: undefined type code");
+                    THROW(e);
+                }
+
+                if(typeOfCode[code].type == TypeID::Unknown) continue;
+
+                tvData[typeOfCode[code]] = value;
+            }
+        }
+
+    }  // End of method 'EpochBinReader::read()'
+
+}  // End of namespace gnssSpace
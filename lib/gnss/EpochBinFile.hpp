@@ -0,0 +1,215 @@
+/**
+ * @file EpochBinFile.hpp
+ * Binary files of processed epochs (epoch, source, nominal receiver
+ * position and satTypeValueMap), to replay them later into a solver
+ * without running the processing chain again.
+ */
+
+#ifndef EpochBinFile_HPP
+#define EpochBinFile_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "Triple.hpp"
+#include "SourceID.hpp"
+#include "DataStructures.hpp"
+
+using namespace utilSpace;
+using namespace timeSpace;
+using namespace mathSpace;
+
+namespace gnssSpace
+{
+
+      /** Layout of the files written by EpochBinWriter.
+       *
+       * The file starts with the magic "GBXEPOCH", the format version
+       * (uint32) and the byte order mark 0x01020304 (uint32); the values
+       * are in the byte order of the machine writing the file. Then come
+       * records, each one a tag (char), the size of its body (uint32) and
+       * the body:
+       *
+       *  - 'T', a type:  code (uint16), name of the TypeID (chars).
+       *  - 'E', an epoch: day (int32), millisecond of day (int32), fraction
+       *    of second (double), time system (int32), length of the source
+       *    name (uint8) and the name, receiver position (3 double), number
+       *    of satellites (uint16); for each satellite, its system char,
+       *    PRN (int16) and number of values (uint16), then code (uint16)
+       *    and value (double) of each one.
+       *
+       * Types are written by name the first time they are used, so the
+       * files stay valid when TypeID values change. Readers skip records
+       * with tags they don't know, and the values of types they don't know.
+       */
+    struct EpochBinFormat
+    {
+        static const char magic[8];
+
+         /// Version written, and the newest that can be read
+        static const unsigned int version = 1;
+
+        static const unsigned int byteOrderMark = 0x01020304;
+
+    };  // End of struct 'EpochBinFormat'
+
+
+      /** Write processed epochs to a binary file.
+       *
+       * A typical way to use this class follows, dumping the data going
+       * into the solver:
+       *
+       * @code
+       *   EpochBinWriter epochWriter("rover.bin");
+       *
+       *   while( rxStream >> rxData )
+       *   {
+       *      ...
+       *      epochWriter.write( rxData.currEpoch, source, rcvPos,
+       *                         rxData.stvData );
+       *      lsqSPP.Process(rxData);
+       *   }
+       * @endcode
+       */
+    class EpochBinWriter
+    {
+    public:
+
+         /// Default constructor, open() must be called before writing
+        EpochBinWriter()
+            : typeWritten(TypeID::count, 0)
+        {};
+
+         /// Constructor, opening the file
+        EpochBinWriter(const std::string& fileName)
+            noexcept(false)
+            : typeWritten(TypeID::count, 0)
+        { open(fileName); };
+
+         /// Create the file and write its header
+        virtual void open(const std::string& fileName)
+            noexcept(false);
+
+         /** Write an epoch.
+          *
+          * @param epoch      Epoch of the data.
+          * @param source     Station of the data.
+          * @param rcvPos     Nominal receiver position the data were
+          *                   computed with.
+          * @param stvData    Data of the satellites.
+          */
+        virtual void write( const CommonTime& epoch,
+                            const SourceID& source,
+                            const Triple& rcvPos,
+                            const satTypeValueMap& stvData )
+            noexcept(false);
+
+         /// Flush and close the file
+        virtual void close();
+
+         /// Destructor
+        virtual ~EpochBinWriter()
+        { close(); };
+
+    private:
+
+        std::ofstream strm;
+
+         /// types already written in a 'T' record
+        std::vector<char> typeWritten;
+
+         /// body of the record being written
+        std::vector<char> buffer;
+
+    };  // End of class 'EpochBinWriter'
+
+
+      /** Read the epochs written by EpochBinWriter.
+       *
+       * A whole record is read at once and decoded from memory, so
+       * replaying a file costs about as much as reading it.
+       *
+       * @code
+       *   EpochBinReader epochReader("rover.bin");
+       *
+       *   while(true)
+       *   {
+       *      try
+       *      {
+       *         epochReader.read( rxData.currEpoch, source, rcvPos,
+       *                           rxData.stvData );
+       *      }
+       *      catch(EndOfFile& e)
+       *      {
+       *         break;
+       *      }
+       *      lsqSPP.Process(rxData);
+       *   }
+       * @endcode
+       */
+    class EpochBinReader
+    {
+    public:
+
+         /// Default constructor, open() must be called before reading
+        EpochBinReader()
+            : fileVersion(0)
+        {};
+
+         /// Constructor, opening the file
+        EpochBinReader(const std::string& fileName)
+            noexcept(false)
+            : fileVersion(0)
+        { open(fileName); };
+
+         /** Open the file and check its header.
+          *
+          * @throw FileMissingException if it can't be opened
+          * @throw FFStreamError if it is not a file of this format, or is
+          *        written with another byte order or a newer version
+          */
+        virtual void open(const std::string& fileName)
+            noexcept(false);
+
+         /** Read the next epoch.
+          *
+          * @throw EndOfFile at the end of the file
+          * @throw FFStreamError if the file is corrupt
+          */
+        virtual void read( CommonTime& epoch,
+                           SourceID& source,
+                           Triple& rcvPos,
+                           satTypeValueMap& stvData )
+            noexcept(false);
+
+         /// Version of the file being read
+        virtual unsigned int getVersion() const
+        { return fileVersion; };
+
+         /// Destructor
+        virtual ~EpochBinReader() {};
+
+    private:
+
+         /// Read the next record, returning its tag. false at end of file.
+        bool readRecord(char& tag)
+            noexcept(false);
+
+        std::ifstream strm;
+
+        unsigned int fileVersion;
+
+         /// TypeID of each code of the file, Unknown if not known here
+        std::vector<TypeID> typeOfCode;
+
+         /// body of the record being read
+        std::vector<char> buffer;
+
+    };  // End of class 'EpochBinReader'
+
+}  // End of namespace gnssSpace
+
+#endif   // EpochBinFile_HPP
@@ -0,0 +1,255 @@
+/**
+ * @file EpochExecutor.cpp
+ * Processing of the epochs of a file on several threads: the stages that
+ * don't depend on the epochs before run in parallel, and the others see
+ * the epochs in order.
+ */
+
+#include <algorithm>
+#include <thread>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+#include "EpochArena.hpp"
+#include "EpochExecutor.hpp"
+
+using namespace std;
+
+namespace gnssSpace
+{
+
+      // Read the next epoch into a slot; false at the end of the data
+    bool EpochExecutor::readSlot(Slot& slot)
+    {
+        // a task left from an epoch run by another thread must not take
+        // the slot while it is filled
+        slot.claimed.store(true, std::memory_order_relaxed);
+        slot.done.store(false, std::memory_order_relaxed);
+        slot.error = std::exception_ptr();
+
+        // the workers only see the types of their epoch
+        slot.data.satTypes.clear();
+        slot.data.satShortTypes.clear();
+
+        bool read( reader(slot.data) );
+
+        if(read)
+        {
+            slot.claimed.store(false, std::memory_order_release);
+        }
+
+        return read;
+
+    }  // End of method 'EpochExecutor::readSlot()'
+
+
+      // Run a worker on the epoch of a slot, unless another thread has
+      // already taken it
+    void EpochExecutor::processSlot(Slot& slot, StageFunction& worker)
+    {
+        if(slot.claimed.exchange(true, std::memory_order_acq_rel))
+        {
+            return;
+        }
+
+        try
+        {
+            worker(slot.data);
+        }
+        catch(...)
+        {
+            slot.error = std::current_exception();
+        }
+
+        EpochArena::local().reset();
+
+        slot.done.store(true, std::memory_order_release);
+
+    }  // End of method 'EpochExecutor::processSlot()'
+
+
+      // Run a worker on the oldest epoch read which no thread has taken
+    bool EpochExecutor::processPending( std::vector<Slot>& slots,
+                                        size_t numRead,
+                                        StageFunction& worker )
+    {
+        for(size_t i=numEpochs; i<numRead; i++)
+        {
+            Slot& slot( slots[i % slots.size()] );
+            if( !slot.claimed.load(std::memory_order_relaxed) )
+            {
+                processSlot(slot, worker);
+                return true;
+            }
+        }
+
+        return false;
+
+    }  // End of method 'EpochExecutor::processPending()'
+
+
+      // Hand the epoch of a slot to the sequential stages
+    void EpochExecutor::consumeSlot(Slot& slot)
+    {
+        if(slot.error)
+        {
+            std::rethrow_exception(slot.error);
+        }
+
+        // the types of this epoch over the ones of the epochs before:
+        // satTypes are replaced, satShortTypes appended
+        for(std::map<SatID, TypeIDVec>::iterator it = slot.data.satTypes.begin();
+            it != slot.data.satTypes.end();
+            ++it)
+        {
+            lastSatTypes[(*it).first].swap((*it).second);
+        }
+
+        for(std::map<SatID, TypeIDVec>::iterator it = slot.data.satShortTypes.begin();
+            it != slot.data.satShortTypes.end();
+            ++it)
+        {
+            TypeIDVec& shortTypes( lastSatShortTypes[(*it).first] );
+            shortTypes.insert( shortTypes.end(),
+                               (*it).second.begin(), (*it).second.end() );
+        }
+
+        slot.data.satTypes.swap(lastSatTypes);
+        slot.data.satShortTypes.swap(lastSatShortTypes);
+
+        sequential(slot.data);
+
+        // keep them, with what the sequential stages did, for the next
+        slot.data.satTypes.swap(lastSatTypes);
+        slot.data.satShortTypes.swap(lastSatShortTypes);
+
+        EpochArena::local().reset();
+
+        numEpochs++;
+
+    }  // End of method 'EpochExecutor::consumeSlot()'
+
+
+      // Read and process all the epochs.
+    void EpochExecutor::run()
+        noexcept(false)
+    {
+        if( !reader || !sequential || workers.empty() )
+        {
+            InvalidRequest e( "EpochExecutor: the reader, the workers and "
+                              "the sequential stages must be given" );
+            THROW(e);
+        }
+
+        lastSatTypes.clear();
+        lastSatShortTypes.clear();
+        numEpochs = 0;
+
+        int numThreads( workers.size() );
+        size_t window( std::max(windowSize, numThreads) );
+        std::vector<Slot> slots(window);
+
+        size_t numRead(0);
+        bool endOfData(false);
+        std::exception_ptr readError, error;
+
+#ifdef USE_OPENMP
+#pragma omp parallel num_threads(numThreads)
+#pragma omp single
+#endif
+        {
+#ifdef USE_OPENMP
+            StageFunction& worker( workers[omp_get_thread_num()] );
+#else
+            StageFunction& worker( workers[0] );
+#endif
+
+            while(true)
+            {
+                // the epochs ready, in order, to the sequential stages
+                while( !error && numEpochs < numRead &&
+                       slots[numEpochs % window].done.load(std::memory_order_acquire) )
+                {
+                    try
+                    {
+                        consumeSlot(slots[numEpochs % window]);
+                    }
+                    catch(...)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+
+                if(error)
+                {
+                    // the epochs still running are waited for at the end
+                    // of the parallel region
+                    break;
+                }
+
+                if(endOfData)
+                {
+                    if(numEpochs == numRead)
+                    {
+                        error = readError;
+                        break;
+                    }
+                    if( !processPending(slots, numRead, worker) )
+                    {
+                        std::this_thread::yield();
+                    }
+                    continue;
+                }
+
+                // window full: wait for the oldest epoch. yield() is no
+                // task scheduling point, so this thread runs the epochs no
+                // other thread has taken yet, or only numThreads-1 workers
+                // would be busy
+                if(numRead - numEpochs == window)
+                {
+                    if( !processPending(slots, numRead, worker) )
+                    {
+                        std::this_thread::yield();
+                    }
+                    continue;
+                }
+
+                Slot* pSlot( &slots[numRead % window] );
+                try
+                {
+                    endOfData = !readSlot(*pSlot);
+                }
+                catch(...)
+                {
+                    readError = std::current_exception();
+                    endOfData = true;
+                }
+
+                if(endOfData)
+                {
+                    continue;
+                }
+
+                numRead++;
+
+#ifdef USE_OPENMP
+                // with a single thread the task runs here and now, as no
+                // other thread would take it
+#pragma omp task firstprivate(pSlot) if(numThreads > 1)
+                processSlot(*pSlot, workers[omp_get_thread_num()]);
+#else
+                processSlot(*pSlot, worker);
+#endif
+            }
+        }
+
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+
+    }  // End of method 'EpochExecutor::run()'
+
+}  // End of namespace gnssSpace
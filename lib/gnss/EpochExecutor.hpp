@@ -0,0 +1,197 @@
+/**
+ * @file EpochExecutor.hpp
+ * Processing of the epochs of a file on several threads: the stages that
+ * don't depend on the epochs before run in parallel, and the others see
+ * the epochs in order.
+ */
+
+#ifndef EpochExecutor_HPP
+#define EpochExecutor_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <exception>
+#include <functional>
+
+#include "Exception.hpp"
+#include "Rx3ObsData.hpp"
+
+using namespace utilSpace;
+
+namespace gnssSpace
+{
+
+      /** Epoch-level executor for post-processing.
+       *
+       * Three functions are given:
+       *
+       *  - the reader, which fills the data of the next epoch and returns
+       *    false at the end of the data. It runs on the calling thread.
+       *  - the workers, one per thread, which run the stages that only
+       *    need the data of the epoch (preprocessing, satellite positions,
+       *    troposphere, ...). Each worker must have its own processing
+       *    objects, as these keep buffers and tables between calls. They
+       *    run in parallel on a window of epochs.
+       *  - the sequential stages, which keep a state from one epoch to the
+       *    next (DetectCSMW, MarkArc, FilterSPP, the solvers, the output).
+       *    They run on the calling thread, with the epochs in the order
+       *    they were read: a finished epoch waits in the window until all
+       *    the epochs before it have gone through.
+       *
+       * Rx3ObsData keeps satTypes and satShortTypes from one epoch to the
+       * next, and ConvertObs and PreprocessObs append to satShortTypes.
+       * So the workers get empty ones, and before the sequential stages
+       * the types of the epoch are added, in order, to those of the epochs
+       * before: the sequential stages see what they would see with the
+       * whole chain on one thread. An exception of the reader or of a
+       * worker is thrown again when its epoch comes to the sequential
+       * stages, after all the epochs before it.
+       *
+       * While the calling thread waits, for a full window or for the last
+       * epochs, it runs the worker of its own thread on the epochs no
+       * other thread has taken yet, so that all the workers are busy.
+       *
+       * Without USE_OPENMP, or with a single worker, each epoch is read,
+       * processed and handed to the sequential stages in turn, through
+       * the same code.
+       *
+       * @code
+       *   std::vector<ProcessingPipeline*> preprocess;  // one per thread
+       *   ...
+       *   EpochExecutor executor;
+       *   executor.setReader( [&](Rx3ObsData& data)
+       *       {
+       *          data.pHeader = &rxHeader;
+       *          try { rxStream >> data; }
+       *          catch(EndOfFile& e) { return false; }
+       *          return true;
+       *       } );
+       *   for(int i=0; i<preprocess.size(); i++)
+       *   {
+       *      ProcessingPipeline* p(preprocess[i]);
+       *      executor.addWorker( [p](Rx3ObsData& data){ p->Process(data); } );
+       *   }
+       *   executor.setSequential( [&](Rx3ObsData& data)
+       *       {
+       *          model.Process(data);
+       *          lsqSPP.Process(data);
+       *          ...
+       *       } );
+       *   executor.run();
+       * @endcode
+       */
+    class EpochExecutor
+    {
+    public:
+
+         /// Read the next epoch; false at the end of the data
+        typedef std::function<bool(Rx3ObsData&)> ReadFunction;
+
+         /// What a stage does with the data of an epoch
+        typedef std::function<void(Rx3ObsData&)> StageFunction;
+
+
+         /// Default constructor, with a window of 64 epochs
+        EpochExecutor()
+            : windowSize(64), numEpochs(0)
+        {};
+
+
+         /// Function reading the epochs
+        virtual EpochExecutor& setReader(ReadFunction function)
+        { reader = function; return (*this); };
+
+         /// Add a worker, i.e., a thread, for the stages run in parallel
+        virtual EpochExecutor& addWorker(StageFunction function)
+        { workers.push_back(function); return (*this); };
+
+         /// Stages run with the epochs in order
+        virtual EpochExecutor& setSequential(StageFunction function)
+        { sequential = function; return (*this); };
+
+         /** Number of epochs read ahead of the sequential stages; at
+          *  least the number of workers is used.
+          */
+        virtual EpochExecutor& setWindow(int size)
+        { windowSize = size; return (*this); };
+
+
+         /// Number of threads, one per worker
+        virtual int getNumThreads() const
+        { return workers.size(); };
+
+         /// Number of epochs handed to the sequential stages in run()
+        virtual size_t getNumEpochs() const
+        { return numEpochs; };
+
+
+         /** Read and process all the epochs.
+          *
+          * @throw InvalidRequest if the reader, a worker or the
+          *        sequential stages are missing. Exceptions of these
+          *        functions are thrown again as they are.
+          */
+        virtual void run()
+            noexcept(false);
+
+
+         /// Destructor
+        virtual ~EpochExecutor() {};
+
+    private:
+
+         /// An epoch of the window
+        struct Slot
+        {
+            Slot()
+                : claimed(true), done(false)
+            {};
+
+            Rx3ObsData data;
+
+             /// taken by the thread which runs the worker on the epoch; set
+             /// by the reader too while it fills the slot
+            std::atomic<bool> claimed;
+
+             /// set by the worker when the epoch is ready
+            std::atomic<bool> done;
+
+             /// exception of the reader or the worker, if any
+            std::exception_ptr error;
+        };
+
+         /// Read the next epoch into a slot; false at the end of the data
+        bool readSlot(Slot& slot);
+
+         /// Run a worker on the epoch of a slot, unless another thread
+         /// has already taken it
+        void processSlot(Slot& slot, StageFunction& worker);
+
+         /// Run a worker on the oldest epoch read which no thread has
+         /// taken yet; false if there is none
+        bool processPending( std::vector<Slot>& slots,
+                             size_t numRead,
+                             StageFunction& worker );
+
+         /// Hand the epoch of a slot to the sequential stages
+        void consumeSlot(Slot& slot);
+
+        ReadFunction reader;
+        std::vector<StageFunction> workers;
+        StageFunction sequential;
+
+        int windowSize;
+        size_t numEpochs;
+
+         /// satTypes and satShortTypes up to the last epoch handed to
+         /// the sequential stages
+        std::map<SatID, TypeIDVec> lastSatTypes;
+        std::map<SatID, TypeIDVec> lastSatShortTypes;
+
+    };  // End of class 'EpochExecutor'
+
+}  // End of namespace gnssSpace
+
+#endif   // EpochExecutor_HPP
@@ -41,6 +41,7 @@
 #include "CommonTime.hpp"
 #include "EquSysForPoint.hpp"
 #include <iterator>
+#include <stdint.h>
 
 #define debug 0
 #define debugArc 0
@@ -54,10 +55,6 @@ namespace gnssSpace
 
 
 
-      // General white noise stochastic model
-   WhiteNoiseModel EquSysForPoint::whiteNoiseModel;
-
-
       /* Add a new equation to be managed.
        *
        * @param equation   Equation object to be added.
@@ -101,17 +98,19 @@ namespace gnssSpace
                                             satTypeValueMap& satData )
    {
 
-      // Prepare set of current unknowns and set of current equations
-      currentUnkSet = prepareEquations(source, satData);
+      // Prepare set of current equations, and the unknowns they have;
+      // the unknowns are a temporary of this call, in the EpochArena
+      EpochSet<Variable> currentUnks;
+      prepareEquations(source, satData, currentUnks);
+
+      // Setup indexs for vars, into 'currentUnkSet'
+      setUpIndex(currentUnks);
 
       // Compute phiMatrix and qMatrix
-      preparePhiQ(epoch);
+      preparePhiQ(epoch, satData);
 
       // Build prefit residuals vector
-      preparePrefitGeometryWeights();
-
-      // Setup indexs for vars
-      setUpIndex();
+      preparePrefitGeometryWeights(satData);
 
       // Let's start storing 'current' unknowns set from 'previous' epoch
       oldUnkSet = currentUnkSet;
@@ -126,51 +125,50 @@ namespace gnssSpace
 
 
       // Prepare set of current unknowns and set of current equations
-   VariableSet EquSysForPoint::prepareEquations(SourceID& source, satTypeValueMap& satData )
+   void EquSysForPoint::prepareEquations( SourceID& source,
+                                          satTypeValueMap& satData,
+                                          EpochSet<Variable>& currentUnks )
    {
 
       // Let's clear the current equations set
       currentEquSet.clear();
-
-      // Let's create 'currentUnks' set
-      VariableSet currentUnks;
+      currentUnks.clear();
 
       SourceID currentSource = source;
 
-      // Iterate the satellite and create the equations
-      for( auto sd: satData )
+      // Variables and coefficients of the equation being built; only the
+      // complete equations are then built in 'currentEquSet'
+      EpochVector< std::pair<Variable, Coefficient> > terms;
+
+      // Iterate the satellite and create the equations. The data of the
+      // satellites are not copied into the equations and variables: they
+      // are found again in 'satData' by preparePhiQ() and
+      // preparePrefitGeometryWeights()
+      for( auto& sd: satData )
       {
-          SatID currentSat( (sd.first));
-          typeValueMap tvData (sd.second) ;
+          const SatID& currentSat( sd.first );
+          typeValueMap& tvData( sd.second );
 
             // Visit each "Equation" in "equDescripSet"
-          for( auto equ: equDescripSet )
+          for( const Equation& equ: equDescripSet )
           {
-              // We need a copy of current Equation object description
-              Equation tempEquation( equ );
-
               // 判断卫星系统
-              if( tempEquation.getSystem() == currentSat.system )
+              if( equ.getSystem() == currentSat.system )
               {
-                  tempEquation.header.equationSource = currentSource;
-                  tempEquation.header.equationSat = currentSat;
-                  tempEquation.header.typeValueData = tvData;
-
-                  Variable varIndep = tempEquation.getIndependentTerm();
-                  TypeID obsType = varIndep.getType();
+                  TypeID obsType = equ.header.indTerm.getType();
 
                   if(tvData.find(obsType)!=tvData.end())
                   {
-                        // Remove all the variables from this equation
-                     tempEquation.clear();
+                     terms.clear();
+
                      bool found(true);
-                     for( auto vc : equ.body )
+                     for( const auto& vc : equ.body )
                      {
                            // We will work with a copy of current Variable
                         Variable var( vc.first );
                         TypeID varType(var.getType());
 
-                        Coefficient coef( vc.second);
+                        const Coefficient& coef( vc.second );
                         if( !coef.isConst )
                         {
                             if(tvData.find(coef.coeffType) == tvData.end())
@@ -203,8 +201,7 @@ namespace gnssSpace
                         if( var.getArcIndexed() )
                         {
                             // 模糊度参数, BL1G
-                            int length = varType.asString().length();
-                            TypeID satArcType = TypeID( "satArc" + varType.asString().substr(1,length) );
+                            TypeID satArcType = satArcOf(varType);
                             if(debugArc)
                             {
                                 cout << "EquSysForPoint:" << endl;
@@ -234,20 +231,32 @@ namespace gnssSpace
 
                         }
 
-                        // 将tvData存入到未知参数中，以方便后续形成随机模型的phi/q
-                        var.setTypeValueData(tvData);
-
-                        // 将构建随机模型需要的数据存储到未知参数中存储起来
-  
                         currentUnks.insert(var);
-                        tempEquation.addVariable(var, coef);
+                        terms.push_back( std::make_pair(var, coef) );
 
                      }  // End of 'for( VarCoeffMap::const_iterator varIt = ...'
 
                         // New equation is complete: Add it to 'currentEquSet'
                      if(found)
                      {
-                        currentEquSet.insert( tempEquation );
+                        // We need a copy of current Equation header, without
+                        // the variables
+                        Equation tempEquation( equ.header );
+                        tempEquation.header.equationSource = currentSource;
+                        tempEquation.header.equationSat = currentSat;
+
+                        // the variables are added in the set, not copied
+                        // into it: the body of an Equation is not part of
+                        // its order
+                        auto ins( currentEquSet.insert(tempEquation) );
+                        if(ins.second)
+                        {
+                           Equation& newEquation( const_cast<Equation&>(*ins.first) );
+                           for( const auto& term: terms )
+                           {
+                              newEquation.addVariable(term.first, term.second);
+                           }
+                        }
                      }
 
                   }
@@ -263,15 +272,13 @@ namespace gnssSpace
           THROW(e);
       }
 
-         // Return set of current unknowns
-      return currentUnks;
-
    }  // End of method 'EquSysForPoint::prepareEquations()'
 
 
 
       // Compute PhiMatrix
-   void EquSysForPoint::preparePhiQ(CommonTime& epoch)
+   void EquSysForPoint::preparePhiQ( CommonTime& epoch,
+                                     satTypeValueMap& satData )
    {
     
       const int numVar( currentUnkSet.size() );
@@ -281,14 +288,17 @@ namespace gnssSpace
       qMatrix = MatrixXd::Zero(numVar, numVar);
 
       int i(0);
-      for( auto var: currentUnkSet)
+      for( const Variable& var: currentUnkSet)
       {
-          // We will work with a copy of current Variable
-          typeValueMap tData = var.getTypeValueData();
-
           SourceID varSource = var.getSource();
           SatID    varSat = var.getSatellite();
 
+          // The data of the satellite of the variable; the variables which
+          // are not satellite-indexed get the data of the first satellite
+          satTypeValueMap::iterator itSat( satData.find(varSat) );
+          typeValueMap& tData( itSat != satData.end() ?
+                               itSat->second : satData.begin()->second );
+
           // Prepare variable's stochastic model
           var.getModel()->Prepare(epoch,
                                   varSource, 
@@ -308,11 +318,11 @@ namespace gnssSpace
 
 
    // Compute prefit residuals vector
-   void EquSysForPoint::preparePrefitGeometryWeights()
+   void EquSysForPoint::preparePrefitGeometryWeights(satTypeValueMap& satData)
    {
 
          // Declare temporal storage for values
-      std::vector<double> tempPrefit;
+      EpochVector<double> tempPrefit;
 
          // Total number of the current equations
       int numEqu( currentEquSet.size() );
@@ -332,10 +342,10 @@ namespace gnssSpace
       int row(0);
 
       // Visit each Equation in "currentEquSet"
-      for( auto equ:currentEquSet )
+      for( const Equation& equ: currentEquSet )
       {
-         // Get the type value data from the header of the equation
-         typeValueMap tData( equ.header.typeValueData );
+         // Get the type value data of the satellite of the equation
+         typeValueMap& tData( satData(equ.header.equationSat) );
 
          // Get the independent type of this equation
          TypeID indepType( equ.header.indTerm.getType() );
@@ -349,10 +359,11 @@ namespace gnssSpace
          // First, fill weights matrix
          // Check if current 'tData' has weight info. If you don't want those
          // weights to get into equations, please don't put them in GDS
-         if( tData.find(TypeID::weight) != tData.end() )
+         const double* pWeight( tData.tryGet(TypeID::weight) );
+         if( pWeight != NULL )
          {
             // Weights matrix = Equation weight * observation weight
-            rMatrix(row,row) = equ.header.constWeight * tData(TypeID::weight);
+            rMatrix(row,row) = equ.header.constWeight * (*pWeight);
          }
          else
          {
@@ -364,11 +375,10 @@ namespace gnssSpace
          
          // Now, let's visit all Variables and the corresponding 
          // coefficient in this equation description
-         for( auto vc: equ.body )
+         for( const auto& vc: equ.body )
          {
-               // We will work with a copy of current Variable
-            Variable var( vc.first );
-            Coefficient coef( vc.second );
+            const Variable& var( vc.first );
+            const Coefficient& coef( vc.second );
 
                // Coefficient values
             double tempCoef(0.0);
@@ -563,13 +573,13 @@ namespace gnssSpace
    }  // End of method 'EquSysForPoint::getQMatrix()'
 
 
-   void EquSysForPoint::setUpIndex()
+   void EquSysForPoint::setUpIndex(const EpochSet<Variable>& currentUnks)
    {
 
        // Then setup index for this epoch
        int nowIndex  = 0;
-       VariableSet varSet;
-       for( auto &var: currentUnkSet )
+       currentUnkSet.clear();
+       for( auto &var: currentUnks )
        {
            // set old index
            Variable nowVar = var; 
@@ -583,17 +593,57 @@ namespace gnssSpace
            /// set current index
            nowVar.setNowIndex( nowIndex );
 
-           /// store the set
-           varSet.insert(nowVar);
+           /// store the set, in the same order
+           currentUnkSet.insert(currentUnkSet.end(), nowVar);
 
            /// index increment
            nowIndex++;
        }
 
-       // copy 'varSet' to 'currentUnkSet'
-       currentUnkSet = varSet;
-
    }  // End of method 'SolverPPPGNSS::SetupIndex()'
 
 
+      // Write the unknowns of the last epoch
+   void EquSysForPoint::saveState(StateWriter& writer) const
+   {
+      writer.beginBlock("EquSysForPoint", 1);
+
+      writer.put( uint32_t(oldUnkSet.size()) );
+      for( const Variable& var: oldUnkSet )
+      {
+         writer.putSource( var.getSource() );
+         writer.putSat( var.getSatellite() );
+         writer.putType( var.getType() );
+         writer.put( var.getArc() );
+         writer.put( int32_t(var.getNowIndex()) );
+      }
+
+   }  // End of method 'EquSysForPoint::saveState()'
+
+
+      // Restore the unknowns written by saveState()
+   void EquSysForPoint::restoreState(StateReader& reader)
+      noexcept(false)
+   {
+      reader.checkBlock("EquSysForPoint", 1);
+
+      oldUnkSet.clear();
+
+      uint32_t numVar( reader.get<uint32_t>() );
+      for(uint32_t i=0; i<numVar; i++)
+      {
+         // only what Variable::operator< and setUpIndex() look at
+         Variable var;
+         var.setSource( reader.getSource() );
+         var.setSatellite( reader.getSat() );
+         var.setType( reader.getType() );
+         var.setArc( reader.get<double>() );
+         var.setNowIndex( reader.get<int32_t>() );
+
+         oldUnkSet.insert(var);
+      }
+
+   }  // End of method 'EquSysForPoint::restoreState()'
+
+
 }  // End of namespace gnssSpace
@@ -176,8 +176,24 @@ namespace gnssSpace
                                        satTypeValueMap& satData);
 
 
-      // setUp index for current variables
-      virtual void setUpIndex();
+      // setUp index for current variables, into 'currentUnkSet'
+      virtual void setUpIndex(const EpochSet<Variable>& currentUnks);
+
+
+         /** Write the unknowns of the last epoch (source, satellite, type,
+          *  arc and index), which the next Prepare() matches with the new
+          *  ones to carry the solution over.
+          */
+      virtual void saveState(StateWriter& writer) const;
+
+
+         /** Restore the unknowns written by saveState(). The equations of
+          *  this object are kept.
+          *
+          * @throw InvalidRequest if the state is not one of EquSysForPoint
+          */
+      virtual void restoreState(StateReader& reader)
+         noexcept(false);
 
 
          /** Return the TOTAL number of variables being processed.
@@ -264,6 +280,19 @@ namespace gnssSpace
       virtual std::set<Equation> getCurrentEquationsSet() const
       { return currentEquSet; };
 
+         /// Same as getDescripEqus(), without copy.
+      const std::set<Equation>& descripEqus() const
+      { return equDescripSet; };
+
+         /// Same as getCurrentEquationsSet(), without copy.
+      const std::set<Equation>& currentEquations() const
+      { return currentEquSet; };
+
+         /// Same as getVarUnknowns(), without copy.
+         /// @warning Valid until the next Prepare().
+      const VariableSet& varUnknowns() const
+      { return currentUnkSet; };
+
       void dumpDescripEquations(std::ostream& os) 
       {
           for(auto it=equDescripSet.begin(); it!=equDescripSet.end(); it++)
@@ -280,14 +309,15 @@ namespace gnssSpace
           }
       }
 
-         /// Prepare set of current unknowns and set of current equations
-      VariableSet prepareEquations( SourceID& source, satTypeValueMap& satData );
+         /// Prepare set of current equations, and the unknowns they have
+      void prepareEquations( SourceID& source, satTypeValueMap& satData,
+                             EpochSet<Variable>& currentUnks );
 
-         /// Compute phiMatrix and qMatrix
-      void preparePhiQ(CommonTime& epoch);
+         /// Compute phiMatrix and qMatrix, with the data of the satellites
+      void preparePhiQ(CommonTime& epoch, satTypeValueMap& satData);
 
          /// Compute prefit residuals vector
-      void preparePrefitGeometryWeights();
+      void preparePrefitGeometryWeights(satTypeValueMap& satData);
 
 
 
@@ -329,9 +359,6 @@ namespace gnssSpace
          /// Measurements vector (Prefit-residuals)
       VectorXd measVector;
 
-         /// General white noise stochastic model
-      static WhiteNoiseModel whiteNoiseModel;
-
 
    }; // End of class 'EquSysForPoint'
 
@@ -37,7 +37,7 @@ namespace gnssSpace
            // Now, Let's check the range of the code observables.
            TypeIDSet tempFilterTypeSet;
 
-           SatIDSet satRejectedSet;
+           EpochSatIDSet satRejectedSet;
 
            // Loop through all the satellites
            for ( satTypeValueMap::iterator satIt = gData.begin();
@@ -19,6 +19,7 @@
 
 
 #include "FilterSPP.hpp"
+#include <stdint.h>
 #include "SystemTime.hpp"
 #include "NEUUtil.hpp"
 #include "CProbability.hpp"
@@ -33,13 +34,6 @@ using namespace gnssSpace;
 namespace gnssSpace
 {
 
-      // Index initially assigned to this class
-   int FilterSPP::classIndex = 9600000;
-
-      // Returns an index identifying this object.
-   int FilterSPP::getIndex() const
-   { return index; }
-
       // Returns a string identifying this object.
    std::string FilterSPP::getClassName() const
    { return "FilterSPP"; }
@@ -635,7 +629,6 @@ namespace gnssSpace
       {
             // Throw an exception if something unexpected happens
          ProcessingException e( getClassName() + ":"
-                                + asString( getIndex() ) + ":"
                                 + u.what() );
 
          THROW(e);
@@ -734,6 +727,82 @@ namespace gnssSpace
        return delta;
    }
 
+      // Write the state of the filter
+   void FilterSPP::saveState(StateWriter& writer) const
+   {
+      writer.beginBlock(getClassName(), 1);
+
+      writer.put(firstTime);
+
+      writer.put( int32_t(solution.size()) );
+      for(int i=0; i<solution.size(); i++)
+      {
+         writer.put( solution(i) );
+      }
+
+      writer.put( int32_t(covMatrix.rows()) );
+      writer.put( int32_t(covMatrix.cols()) );
+      for(int j=0; j<covMatrix.cols(); j++)
+      {
+         for(int i=0; i<covMatrix.rows(); i++)
+         {
+            writer.put( covMatrix(i,j) );
+         }
+      }
+
+      equSystem.saveState(writer);
+
+      // the white noise and constant models have no state
+      tropoModel.saveState(writer);
+      ionoC1GStoModel.saveState(writer);
+      ionoC1EStoModel.saveState(writer);
+      ionoC2CStoModel.saveState(writer);
+      isbGPSModel.saveState(writer);
+      isbGALModel.saveState(writer);
+      isbBDSModel.saveState(writer);
+
+   }  // End of method 'FilterSPP::saveState()'
+
+
+      // Restore a state written by saveState()
+   void FilterSPP::restoreState(StateReader& reader)
+      noexcept(false)
+   {
+      reader.checkBlock(getClassName(), 1);
+
+      firstTime = reader.get<bool>();
+
+      int32_t size( reader.get<int32_t>() );
+      solution.resize(size);
+      for(int i=0; i<size; i++)
+      {
+         solution(i) = reader.get<double>();
+      }
+
+      int32_t rows( reader.get<int32_t>() );
+      int32_t cols( reader.get<int32_t>() );
+      covMatrix.resize(rows, cols);
+      for(int j=0; j<cols; j++)
+      {
+         for(int i=0; i<rows; i++)
+         {
+            covMatrix(i,j) = reader.get<double>();
+         }
+      }
+
+      equSystem.restoreState(reader);
+
+      tropoModel.restoreState(reader);
+      ionoC1GStoModel.restoreState(reader);
+      ionoC1EStoModel.restoreState(reader);
+      ionoC2CStoModel.restoreState(reader);
+      isbGPSModel.restoreState(reader);
+      isbGALModel.restoreState(reader);
+      isbBDSModel.restoreState(reader);
+
+   }  // End of method 'FilterSPP::restoreState()'
+
+
    Equation FilterSPP::findEquation( std::set<Equation>& equSet,
                                         int index)
    {
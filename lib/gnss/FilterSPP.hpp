@@ -62,6 +62,20 @@ namespace gnssSpace
 
       virtual void Process(Rx3ObsData& rxData);
 
+         /** Write the state of the filter: solution and covariance of the
+          *  last epoch, the unknowns they belong to, and the state of the
+          *  random walk models.
+          */
+      virtual void saveState(StateWriter& writer) const;
+
+         /** Restore a state written by saveState(), so that the next
+          *  epoch goes on from it.
+          *
+          * @throw InvalidRequest if the state is not one of FilterSPP
+          */
+      virtual void restoreState(StateReader& reader)
+         noexcept(false);
+
          /// Returns an index identifying this object.
       virtual void Init(void) ;
 
@@ -95,9 +109,6 @@ namespace gnssSpace
       Equation findEquation( std::set<Equation>& equSet,
                              int index);
 
-      /// Returns an index identifying this object.
-      virtual int getIndex(void) const;
-
       /// Returns a string identifying this object.
       virtual std::string getClassName(void) const;
 
@@ -198,17 +209,6 @@ namespace gnssSpace
       // Equation system
       EquSysForPoint equSystem;
 
-         /// Initial index assigned to this class.
-      static int classIndex;
-
-         /// Index belonging to this object.
-      int index;
-
-         /// Sets the index and increment classIndex.
-      void setIndex(void)
-      { index = classIndex++; };
-
-
    }; // End of class 'FilterSPP'
 
 }  // End of namespace gnssSpace
@@ -0,0 +1,286 @@
+/**
+ * @file FlatTypeValueMap.hpp
+ * Sorted-vector map from TypeID to double, with the first elements stored
+ * inside the object. It has the part of the std::map<TypeID, double>
+ * interface used by typeValueMap, and replaces it when USE_FLAT_TYPEVALUEMAP
+ * is defined (cmake -DUSE_FLAT_TYPEVALUEMAP=ON).
+ */
+
+#ifndef FlatTypeValueMap_HPP
+#define FlatTypeValueMap_HPP
+
+#include <new>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "TypeID.hpp"
+
+namespace gnssSpace
+{
+
+      /** Map from TypeID to double stored as an array sorted by TypeID.
+       *
+       * Up to inlineSize values are kept in the object itself, so that the
+       * values of a satellite (observations plus the model terms added by
+       * the processing classes) take one allocation, or none, instead of
+       * one tree node each; more values go to a heap array which grows by
+       * doubling. Look-up is a binary search over contiguous memory.
+       *
+       * The storage is raw memory: only the values present are constructed
+       * (TypeID has a vtable, so an array of value_type would construct
+       * and copy all of its elements), and an empty map costs nothing to
+       * create or copy.
+       *
+       * Iteration is in TypeID order, as for std::map. Unlike std::map,
+       * inserting or erasing invalidates iterators and references to the
+       * values, so code like m[a] = m[b] must read m[b] first.
+       */
+    class FlatTypeValueMap
+    {
+    public:
+
+        typedef TypeID key_type;
+        typedef double mapped_type;
+        typedef std::pair<TypeID, double> value_type;
+        typedef value_type* iterator;
+        typedef const value_type* const_iterator;
+        typedef size_t size_type;
+
+         /// Number of values stored in the object itself
+        static const size_t inlineSize = 32;
+
+        FlatTypeValueMap()
+            : first(inlineData()), n(0), cap(inlineSize)
+        {}
+
+        FlatTypeValueMap(const FlatTypeValueMap& right)
+            : first(inlineData()), n(0), cap(inlineSize)
+        { assign(right); }
+
+        FlatTypeValueMap(FlatTypeValueMap&& right)
+            : first(inlineData()), n(0), cap(inlineSize)
+        { steal(right); }
+
+        FlatTypeValueMap& operator=(const FlatTypeValueMap& right)
+        {
+            if(this != &right) assign(right);
+            return (*this);
+        }
+
+        FlatTypeValueMap& operator=(FlatTypeValueMap&& right)
+        {
+            if(this != &right)
+            {
+                release();
+                steal(right);
+            }
+            return (*this);
+        }
+
+        ~FlatTypeValueMap()
+        { release(); }
+
+        iterator begin() { return first; }
+        iterator end() { return first + n; }
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return first + n; }
+
+        size_t size() const { return n; }
+        bool empty() const { return n == 0; }
+
+         /// Remove all values, keeping the memory
+        void clear() { destroy(0); }
+
+         /// First value whose type is not less than type
+        iterator lower_bound(const TypeID& type)
+        { return std::lower_bound(begin(), end(), type, lessType); }
+
+        const_iterator lower_bound(const TypeID& type) const
+        { return std::lower_bound(begin(), end(), type, lessType); }
+
+        iterator find(const TypeID& type)
+        {
+            iterator it( lower_bound(type) );
+            return (it != end() && it->first.type == type.type) ? it : end();
+        }
+
+        const_iterator find(const TypeID& type) const
+        {
+            const_iterator it( lower_bound(type) );
+            return (it != end() && it->first.type == type.type) ? it : end();
+        }
+
+        size_t count(const TypeID& type) const
+        { return (find(type) == end() ? 0 : 1); }
+
+         /// Value of type, inserted (as zero) if not present
+        double& operator[](const TypeID& type)
+        {
+            iterator it( lower_bound(type) );
+            if(it == end() || it->first.type != type.type)
+            {
+                it = insertAt(it - begin(), value_type(type, 0.0));
+            }
+            return it->second;
+        }
+
+        std::pair<iterator, bool> insert(const value_type& v)
+        {
+            iterator it( lower_bound(v.first) );
+            if(it != end() && it->first.type == v.first.type)
+            {
+                return std::make_pair(it, false);
+            }
+            return std::make_pair(insertAt(it - begin(), v), true);
+        }
+
+        template <class InputIt>
+        void insert(InputIt from, InputIt to)
+        {
+            for(; from != to; ++from) insert(*from);
+        }
+
+        size_t erase(const TypeID& type)
+        {
+            iterator it( find(type) );
+            if(it == end()) return 0;
+            erase(it);
+            return 1;
+        }
+
+        iterator erase(iterator pos)
+        { return erase(pos, pos + 1); }
+
+        iterator erase(iterator from, iterator to)
+        {
+            iterator last( std::copy(to, end(), from) );
+            destroy(last - begin());
+            return from;
+        }
+
+        void swap(FlatTypeValueMap& right)
+        {
+            FlatTypeValueMap tmp( std::move(right) );
+            right = std::move(*this);
+            (*this) = std::move(tmp);
+        }
+
+        bool operator==(const FlatTypeValueMap& right) const
+        {
+            if(n != right.n) return false;
+            for(size_t i=0; i<n; i++)
+            {
+                if( first[i].first.type != right.first[i].first.type ||
+                    first[i].second != right.first[i].second ) return false;
+            }
+            return true;
+        }
+
+        bool operator!=(const FlatTypeValueMap& right) const
+        { return !(operator==(right)); }
+
+    private:
+
+        static bool lessType(const value_type& v, const TypeID& type)
+        { return v.first.type < type.type; }
+
+        value_type* inlineData()
+        { return reinterpret_cast<value_type*>(buf); }
+
+        const value_type* inlineData() const
+        { return reinterpret_cast<const value_type*>(buf); }
+
+         /// Destroy the values from index i on
+        void destroy(size_t i)
+        {
+            for(size_t j=i; j<n; j++)
+            {
+                first[j].~value_type();
+            }
+            n = i;
+        }
+
+         /// Insert v at index i, growing the storage if needed
+        iterator insertAt(size_t i, const value_type& v)
+        {
+            if(n == cap) grow(2*cap);
+            if(i == n)
+            {
+                new (first + n) value_type(v);
+            }
+            else
+            {
+                new (first + n) value_type(first[n-1]);
+                std::copy_backward(first + i, first + n - 1, first + n);
+                first[i] = v;
+            }
+            n++;
+            return first + i;
+        }
+
+        void grow(size_t newCap)
+        {
+            value_type* p = static_cast<value_type*>(
+                                ::operator new(newCap*sizeof(value_type)) );
+            std::uninitialized_copy(first, first + n, p);
+            size_t num(n);
+            destroy(0);
+            if(first != inlineData()) ::operator delete(first);
+            first = p;
+            n = num;
+            cap = newCap;
+        }
+
+        void assign(const FlatTypeValueMap& right)
+        {
+            destroy(0);
+            if(right.n > cap) grow(right.n);
+            std::uninitialized_copy(right.first, right.first + right.n, first);
+            n = right.n;
+        }
+
+         /// Take the values of right, leaving it empty
+        void steal(FlatTypeValueMap& right)
+        {
+            if(right.first != right.inlineData())
+            {
+                first = right.first;
+                cap = right.cap;
+                n = right.n;
+                right.first = right.inlineData();
+                right.cap = inlineSize;
+                right.n = 0;
+            }
+            else
+            {
+                first = inlineData();
+                cap = inlineSize;
+                std::uninitialized_copy(right.first, right.first + right.n, first);
+                n = right.n;
+                right.destroy(0);
+            }
+        }
+
+        void release()
+        {
+            destroy(0);
+            if(first != inlineData()) ::operator delete(first);
+            first = inlineData();
+            cap = inlineSize;
+        }
+
+        value_type* first;
+        size_t n, cap;
+
+         /// raw memory of the first inlineSize values
+        std::aligned_storage< sizeof(value_type),
+                              alignof(value_type) >::type buf[inlineSize];
+
+    };  // End of class 'FlatTypeValueMap'
+
+}  // End of namespace gnssSpace
+
+#endif   // FlatTypeValueMap_HPP
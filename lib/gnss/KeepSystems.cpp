@@ -35,7 +35,7 @@ namespace gnssSpace
 
         try
         {
-            SatIDSet satRejectedSet;
+            EpochSatIDSet satRejectedSet;
 
             // Loop through all the satellites
             for(satTypeValueMap::iterator it = gData.begin();
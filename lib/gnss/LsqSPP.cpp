@@ -155,9 +155,9 @@ namespace gnssSpace
             }
         }
 
-        std::set<Equation> desSet = equSys.getDescripEqus();
         if(debug)
         {
+            const std::set<Equation>& desSet( equSys.descripEqus() );
             cout << "desSet" << endl;
             for(auto it = desSet.begin(); it!= desSet.end(); it++)
             {
@@ -165,9 +165,9 @@ namespace gnssSpace
             }
         }
 
-        std::set<Equation> equSet = equSys.getCurrentEquationsSet();
         if(debug)
         {
+            const std::set<Equation>& equSet( equSys.currentEquations() );
             cout << "equSet" << endl;
             for(auto it = equSet.begin(); it!= equSet.end(); it++)
             {
@@ -5,6 +5,8 @@
  * This class keeps track of satellite arcs caused by cycle slips.
  */
 
+#include <stdint.h>
+
 #include "MarkArc.hpp"
 
 #define debug 0
@@ -80,7 +82,7 @@ namespace gnssSpace
         noexcept(false)
     {
 
-        SatIDSet satRejectedSet;
+        EpochSatIDSet satRejectedSet;
 
         if(debug)
         {
@@ -141,16 +143,15 @@ namespace gnssSpace
             //////////////////
 
             // Check if satellite currently has entries
-            satTypeArcDataMap::const_iterator itArc( satTypeArcData.find( sat ) );
-            if( itArc == satTypeArcData.end() )
+            if( !satTypeArcData.hasSat( sat ) )
             {
                 // If it doesn't have an entry, insert one
                 // 如果当前卫星第一次出现，则为每一个类型设置初始化弧段时间
                 for(int i=0; i<phaseTypeVec.size(); i++)
                 {
                     TypeID phaseType = phaseTypeVec[i];
-                    satTypeArcData[sat][phaseType].arcChangeTime = CommonTime::BEGINNING_OF_TIME;
-                    satTypeArcData[sat][phaseType].arcNum = 0.0;
+                    satTypeArcData(sat, phaseType).arcChangeTime = CommonTime::BEGINNING_OF_TIME;
+                    satTypeArcData(sat, phaseType).arcNum = 0.0;
                 }
             }
 
@@ -164,7 +165,7 @@ namespace gnssSpace
                     cout << "phaseType:" << phaseType << endl;
                 }
 
-                TypeID csFlagType = TypeID("CSFlag" + phaseType.asString());
+                TypeID csFlagType = csFlagOf(phaseType);
 
                 if(debug)
                 {
@@ -175,6 +176,8 @@ namespace gnssSpace
                 // compatible with different cycle-slip method
                 if ( (*it).second.find(csFlagType) != (*it).second.end() )
                 {
+                    arcData& arc( satTypeArcData(sat, phaseType) );
+
                     if(csDataStream!=NULL)
                     {
                         (*csDataStream) 
@@ -194,18 +197,18 @@ namespace gnssSpace
                     if((*it).second(csFlagType) > 0 )
                     {
                         // Increment the value of "TypeID::satArc"
-                        satTypeArcData[sat][phaseType].arcNum = satTypeArcData[sat][phaseType].arcNum + 1.0;
+                        arc.arcNum = arc.arcNum + 1.0;
 
                         // Update arc change epoch
-                        satTypeArcData[sat][phaseType].arcChangeTime = epoch;
+                        arc.arcChangeTime = epoch;
                     }
                     
                     if(debug)
                     {
-                        cout << "satArcMarker:" << sat << ":" << satTypeArcData[sat][phaseType].arcNum << endl;
+                        cout << "satArcMarker:" << sat << ":" << arc.arcNum << endl;
                     }
 
-                    (*it).second[TypeID("satArc"+phaseType.asString())] = satTypeArcData[sat][phaseType].arcNum;
+                    (*it).second[satArcOf(phaseType)] = arc.arcNum;
                 }
 
             }
@@ -219,4 +222,58 @@ namespace gnssSpace
     }  // End of method 'MarkArc::Process()'
 
 
+      // Write the arcs of every satellite and type
+    void MarkArc::saveState(StateWriter& writer) const
+    {
+        writer.beginBlock(getClassName(), 1);
+
+        std::vector<TypeID> types( satTypeArcData.getTypes() );
+        writer.put( uint32_t(types.size()) );
+        for(size_t t=0; t<types.size(); t++)
+        {
+            std::vector<SatID> sats( satTypeArcData.getSats(types[t]) );
+
+            writer.putType(types[t]);
+            writer.put( uint32_t(sats.size()) );
+            for(size_t i=0; i<sats.size(); i++)
+            {
+                const arcData& arc( satTypeArcData.at(sats[i], types[t]) );
+
+                writer.putSat(sats[i]);
+                writer.put(arc.arcNum);
+                writer.putTime(arc.arcChangeTime);
+                writer.put(arc.arcNew);
+            }
+        }
+
+    }  // End of method 'MarkArc::saveState()'
+
+
+      // Restore a state written by saveState()
+    void MarkArc::restoreState(StateReader& reader)
+        noexcept(false)
+    {
+        reader.checkBlock(getClassName(), 1);
+
+        satTypeArcData.clear();
+
+        uint32_t numTypes( reader.get<uint32_t>() );
+        for(uint32_t t=0; t<numTypes; t++)
+        {
+            TypeID type( reader.getType() );
+
+            uint32_t numSats( reader.get<uint32_t>() );
+            for(uint32_t i=0; i<numSats; i++)
+            {
+                arcData& arc( satTypeArcData(reader.getSat(), type) );
+
+                arc.arcNum = reader.get<double>();
+                arc.arcChangeTime = reader.getTime();
+                arc.arcNew = reader.get<bool>();
+            }
+        }
+
+    }  // End of method 'MarkArc::restoreState()'
+
+
 }  // End of namespace gnssSpace
@@ -16,6 +16,8 @@
 
 #include "CommonTime.hpp"
 #include "Rx3ObsData.hpp"
+#include "SatIndex.hpp"
+#include "ProcessorState.hpp"
 
 using namespace utilSpace;
 using namespace timeSpace;
@@ -75,6 +77,22 @@ namespace gnssSpace
         };
 
 
+        /** Write the arcs (number and epoch of the last change) of every
+         *  satellite and type, to start another object from them with
+         *  restoreState().
+         */
+        virtual void saveState(StateWriter& writer) const;
+
+
+        /** Restore a state written by saveState(). The settings of this
+         *  object are kept.
+         *
+         * @throw InvalidRequest if the state is not one of MarkArc
+         */
+        virtual void restoreState(StateReader& reader)
+            noexcept(false);
+
+
         /// Return a string identifying this object.
         virtual std::string getClassName(void) const;
 
@@ -100,11 +118,11 @@ namespace gnssSpace
         };
 
 
-        typedef std::map<SatID, std::map<TypeID, arcData>> satTypeArcDataMap;
+        typedef SatTypeStateArray<arcData> satTypeArcDataMap;
 
         std::ofstream* csDataStream;
 
-        /// Map holding information regarding every satellite
+        /// Arc data of every satellite and type
         satTypeArcDataMap satTypeArcData;
 
         std::map<SatelliteSystem, std::vector<TypeID>> satCombType;
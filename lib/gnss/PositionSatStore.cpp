@@ -62,6 +62,8 @@ namespace gnssSpace
    PositionRecord PositionSatStore::getValue(const SatID& sat, const CommonTime& ttag)
       const noexcept(false)
    {
+      if(fixedGetValue) return (this->*fixedGetValue)(sat, ttag);
+
       try {
          bool isExact;
          int i;
@@ -158,6 +160,113 @@ namespace gnssSpace
       catch(InvalidRequest& e) { RETHROW(e); }
    }
 
+   // getValue() for interpolation of fixed order N; the same as the general
+   // code in getValue(), but with the data window in arrays on the stack and
+   // one set of Lagrange weights for all components.
+   template <int N>
+   PositionRecord PositionSatStore::getFixedOrderValue(const SatID& sat,
+                                                       const CommonTime& ttag)
+      const noexcept(false)
+   {
+      try {
+         PositionRecord rec;
+         DataTableIterator it1, it2, kt;        // cf. TabularSatStore.hpp
+
+         bool isExact(getTableInterval(sat, ttag, N/2, it1, it2, haveVelocity));
+         if(isExact && haveVelocity) {
+            rec = it1->second;
+            return rec;
+         }
+
+         // pull data out of the data table
+         const int Nlow(N/2-1), Nhi(N/2);
+         int i, n, Nmatch(N/2);
+
+         CommonTime ttag0(it1->first);
+
+         double times[N],P[3][N],V[3][N],A[3][N];
+         double sigP[3][N],sigV[3][N],sigA[3][N];
+
+         kt = it1;
+         for(n=0; n<N; n++, ++kt) {
+            // find index matching ttag
+            if(isExact && ABS(kt->first - ttag) < 1.e-8)
+               Nmatch = n;
+            times[n] = kt->first - ttag0;                // sec
+            for(i=0; i<3; i++) {
+               P[i][n] = kt->second.Pos[i];
+               V[i][n] = kt->second.Vel[i];
+               A[i][n] = kt->second.Acc[i];
+               sigP[i][n] = kt->second.sigPos[i];
+               sigV[i][n] = kt->second.sigVel[i];
+               sigA[i][n] = kt->second.sigAcc[i];
+            }
+         }
+
+         // Lagrange weights and their derivatives, the same for all components
+         double L[N],Lp[N];
+         double dt(ttag-ttag0);                 // dt in seconds
+         FixedLagrangeWeights<N>(times,dt,L,Lp);
+
+         rec.sigAcc = rec.Acc = Triple(0,0,0);        // default
+         for(i=0; i<3; i++) {
+            double p(0),v(0),a(0);
+            if(haveVelocity) {
+               for(n=0; n<N; n++) {
+                  p += L[n]*P[i][n];
+                  v += L[n]*V[i][n];
+                  // interpolate accelerations, or velocities(dm/s) to get A
+                  a += (haveAcceleration ? L[n]*A[i][n] : Lp[n]*V[i][n]);
+               }
+               rec.Pos[i] = p;
+               rec.Vel[i] = v;
+               rec.Acc[i] = (haveAcceleration ? a : a*0.1);   // dm/s/s -> m/s/s
+
+               if(isExact) {
+                  rec.sigPos[i] = sigP[i][Nmatch];
+                  rec.sigVel[i] = sigV[i][Nmatch];
+                  if(haveAcceleration) rec.sigAcc[i] = sigA[i][Nmatch];
+               }
+               else {
+                  rec.sigPos[i] = RSS(sigP[i][Nhi],sigP[i][Nlow]);
+                  rec.sigVel[i] = RSS(sigV[i][Nhi],sigV[i][Nlow]);
+                  if(haveAcceleration)
+                     rec.sigAcc[i] = RSS(sigA[i][Nhi],sigA[i][Nlow]);
+               }
+            }
+            else {            // no V data - must interpolate position to get velocity
+               for(n=0; n<N; n++) {
+                  p += L[n]*P[i][n];
+                  v += Lp[n]*P[i][n];
+               }
+               rec.Pos[i] = p;
+               rec.Vel[i] = v*10000.;           // km/sec -> dm/sec
+
+               if(isExact) rec.sigPos[i] = sigP[i][Nmatch];
+               else        rec.sigPos[i] = RSS(sigP[i][Nhi],sigP[i][Nlow]);
+               rec.sigVel[i] = 0.0;
+            }
+         }
+
+         return rec;
+      }
+      catch(InvalidRequest& e) { RETHROW(e); }
+   }
+
+   // Choose fixedGetValue for the current interpOrder
+   void PositionSatStore::selectInterpolationKernel(void) throw()
+   {
+      switch(interpOrder) {
+         case  2: fixedGetValue = &PositionSatStore::getFixedOrderValue<2>;  break;
+         case  4: fixedGetValue = &PositionSatStore::getFixedOrderValue<4>;  break;
+         case  6: fixedGetValue = &PositionSatStore::getFixedOrderValue<6>;  break;
+         case  8: fixedGetValue = &PositionSatStore::getFixedOrderValue<8>;  break;
+         case 10: fixedGetValue = &PositionSatStore::getFixedOrderValue<10>; break;
+         case 12: fixedGetValue = &PositionSatStore::getFixedOrderValue<12>; break;
+         default: fixedGetValue = NULL;
+      }
+   }
+
    // Return the position for the given satellite at the given time
    // @param[in] sat the SatID of the satellite of interest
    // @param[in] ttag the time (CommonTime) of interest
@@ -322,6 +431,106 @@ namespace gnssSpace
       catch(InvalidRequest& e) { RETHROW(e); }
    }
 
+   // Compute position, velocity and acceleration for one satellite at each
+   // of a list of times, in one pass over its data table.
+   // @param[in] sat the SatID of the satellite of interest
+   // @param[in] ttags the times (CommonTime) of interest
+   // @param[out] pva 9 values per time: Pos, Vel and Acc
+   // @param[out] ok 1 if the values at this time could be computed, else 0
+   // @return the number of times for which the values were computed
+   int PositionSatStore::getValues(const SatID& sat,
+                                   const std::vector<CommonTime>& ttags,
+                                   std::vector<double>& pva,
+                                   std::vector<char>& ok)
+      const throw()
+   {
+      const size_t N(ttags.size());
+      pva.assign(9*N, 0.0);
+      ok.assign(N, 0);
+
+      int i, nok(0);
+      size_t k, n;
+      DataTableIterator it1, it2, kt;
+
+      // work buffers, reused for all times
+      vector<double> times,P[3],V[3],A[3],L,Lp,Lpp;
+
+      for(k=0; k<N; k++) {
+         const CommonTime& ttag(ttags[k]);
+         double *rec(&pva[9*k]);
+
+         // always ask for the whole interval, it is needed for the acceleration
+         try {
+            getTableInterval(sat, ttag, Nhalf, it1, it2, false);
+         }
+         catch(InvalidRequest& e) {
+            // at the ends of the table only an exact match can be returned
+            try {
+               if(!haveVelocity ||
+                  !getTableInterval(sat, ttag, Nhalf, it1, it2, true)) continue;
+            }
+            catch(InvalidRequest& e) { continue; }
+
+            for(i=0; i<3; i++) {
+               rec[i]   = it1->second.Pos[i];
+               rec[3+i] = it1->second.Vel[i];
+               rec[6+i] = it1->second.Acc[i];
+            }
+            ok[k] = 1; nok++;
+            continue;
+         }
+
+         // pull data out of the data table
+         CommonTime ttag0(it1->first);
+         times.clear();
+         for(i=0; i<3; i++) { P[i].clear(); V[i].clear(); A[i].clear(); }
+
+         kt = it1;
+         while(1) {
+            times.push_back(kt->first - ttag0);          // sec
+            for(i=0; i<3; i++) {
+               P[i].push_back(kt->second.Pos[i]);
+               if(haveVelocity) V[i].push_back(kt->second.Vel[i]);
+               if(haveAcceleration) A[i].push_back(kt->second.Acc[i]);
+            }
+            if(kt == it2) break;
+            ++kt;
+         };
+
+         // one set of Lagrange weights for all components
+         LagrangeWeights(times, double(ttag-ttag0), L, Lp, Lpp);
+
+         for(i=0; i<3; i++) {
+            double p(0), v(0), a(0);
+            if(haveVelocity) {
+               for(n=0; n<times.size(); n++) {
+                  p += L[n]*P[i][n];
+                  v += L[n]*V[i][n];
+                  if(haveAcceleration) a += L[n]*A[i][n];
+                  else                 a += Lp[n]*V[i][n];
+               }
+               if(!haveAcceleration) a *= 0.1;      // dm/s/s -> m/s/s
+            }
+            else {
+               // no V data - differentiate the positions(km)
+               for(n=0; n<times.size(); n++) {
+                  p += L[n]*P[i][n];
+                  v += Lp[n]*P[i][n];
+                  a += Lpp[n]*P[i][n];
+               }
+               v *= 10000.;                         // km/s -> dm/s
+               a *= 1000.;                          // km/s/s -> m/s/s
+            }
+            rec[i] = p;
+            rec[3+i] = v;
+            rec[6+i] = a;
+         }
+         ok[k] = 1; nok++;
+      }
+
+      return nok;
+   }
+
    // Add a PositionRecord to the store.
    void PositionSatStore::addPositionRecord(const SatID& sat, const CommonTime& ttag,
                                             const PositionRecord& rec)
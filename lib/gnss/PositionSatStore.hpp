@@ -7,6 +7,7 @@
 #define POSITION_SAT_STORE_INCLUDE
 
 #include <map>
+#include <vector>
 #include <iostream>
 
 #include "TabularSatStore.hpp"
@@ -76,6 +77,21 @@ namespace gnssSpace
       /// Store half the interpolation order, for convenience
       unsigned int Nhalf;
 
+      /// Interpolation kernel of fixed order for getValue(), chosen in
+      /// setInterpolationOrder(); NULL if there is none for interpOrder,
+      /// then the general (run-time order) code is used.
+      PositionRecord (PositionSatStore::*fixedGetValue)(const SatID& sat,
+                                                        const CommonTime& ttag)
+         const;
+
+      /// getValue() for interpolation of fixed order N (N/2 points on each side)
+      template <int N>
+      PositionRecord getFixedOrderValue(const SatID& sat, const CommonTime& ttag)
+         const noexcept(false);
+
+      /// Choose fixedGetValue for the current interpOrder
+      void selectInterpolationKernel(void) throw();
+
    // member functions
    public:
 
@@ -88,6 +104,7 @@ namespace gnssSpace
          haveVelocity = false;
          haveClockBias = false;
          haveClockDrift = false;
+         selectInterpolationKernel();
       }
 
       /// Destructor
@@ -142,6 +159,21 @@ namespace gnssSpace
       Triple getAcceleration(const SatID& sat, const CommonTime& ttag)
          const noexcept(false);
 
+      /// Compute position, velocity and acceleration for one satellite at each
+      /// of a list of times, in one pass over its data table. The interpolation
+      /// weights are computed once per time and shared by the three components,
+      /// and the work buffers are reused, so this is much cheaper than calling
+      /// getValue() for every time.
+      /// @param[in] sat the SatID of the satellite of interest
+      /// @param[in] ttags the times (CommonTime) of interest
+      /// @param[out] pva 9 values per time: Pos, Vel and Acc, in the units of
+      ///    getValue() and getAcceleration()
+      /// @param[out] ok 1 if the values at this time could be computed, else 0
+      /// @return the number of times for which the values were computed
+      int getValues(const SatID& sat, const std::vector<CommonTime>& ttags,
+                    std::vector<double>& pva, std::vector<char>& ok)
+         const throw();
+
       /// Dump information about the object to an ostream.
       /// @param[in] os ostream to receive the output; defaults to std::cout
       /// @param[in] detail integer level of detail to provide; allowed values are
@@ -190,8 +222,9 @@ namespace gnssSpace
          { return interpOrder; }
 
       /// Set the interpolation order; this routine forces the order to be even.
+      /// Orders 2 to 12 use interpolation kernels of fixed order.
       void setInterpolationOrder(unsigned int order) throw()
-         { Nhalf = (order+1)/2; interpOrder = 2*Nhalf; }
+         { Nhalf = (order+1)/2; interpOrder = 2*Nhalf; selectInterpolationKernel(); }
 
       /// Set the flag; if true then bad position values are rejected when
       /// adding data to the store.
@@ -0,0 +1,356 @@
+#pragma ident "$Id$"
+
+/**
+ * @file PreprocessObs.cpp
+ * Preprocessing of the observables of an epoch in a single pass over the
+ * satellites: the work of KeepSystems, FilterCode, ConvertObs and
+ * RequiredObs, in this order.
+ */
+
+#include <algorithm>
+
+#include "PreprocessObs.hpp"
+
+#define debug 0
+
+using namespace std;
+using namespace utilSpace;
+
+namespace gnssSpace
+{
+
+      // Return a string identifying this object.
+    std::string PreprocessObs::getClassName() const
+    { return "PreprocessObs"; }
+
+
+      // Systems to keep, as in KeepSystems
+    PreprocessObs& PreprocessObs::setSystems(const std::string& sysStr)
+    {
+        sysVec.clear();
+        for(size_t i=0; i<sysStr.size(); i++)
+        {
+            char sysChar = sysStr[i];
+            SatelliteSystem satSys(sysChar);
+            sysVec.push_back(satSys);
+        }
+
+        sysTables.clear();
+
+        return (*this);
+
+    }  // End of method 'PreprocessObs::setSystems()'
+
+
+      // Types to convert to 3-char types, as in ConvertObs
+    PreprocessObs& PreprocessObs::setSysPrioriTypes(const SysTypesMap& sysTypes)
+    {
+        sysPrioriTypes = sysTypes;
+
+        sysTables.clear();
+
+        return (*this);
+
+    }  // End of method 'PreprocessObs::setSysPrioriTypes()'
+
+
+      // Add a type to be required, as in RequiredObs
+    PreprocessObs& PreprocessObs::addRequiredType( const SatelliteSystem& sys,
+                                                   const TypeID& type )
+    {
+        if( sys == SatelliteSystem::GPS ||
+            sys == SatelliteSystem::GLONASS ||
+            sys == SatelliteSystem::Galileo ||
+            sys == SatelliteSystem::BDS )
+        {
+            requiredTypes[sys].insert(type);
+        }
+
+        return (*this);
+
+    }  // End of method 'PreprocessObs::addRequiredType()'
+
+
+      // Add a set of types to be required, as in RequiredObs
+    PreprocessObs& PreprocessObs::addRequiredType( const SatelliteSystem& sys,
+                                                   const TypeIDSet& typeSet )
+    {
+        if( sys == SatelliteSystem::GPS ||
+            sys == SatelliteSystem::GLONASS ||
+            sys == SatelliteSystem::Galileo ||
+            sys == SatelliteSystem::BDS )
+        {
+            requiredTypes[sys].insert(typeSet.begin(), typeSet.end());
+        }
+
+        return (*this);
+
+    }  // End of method 'PreprocessObs::addRequiredType()'
+
+
+      // Table of a system, updated to the types of the header
+    PreprocessObs::SysTable& PreprocessObs::getSysTable( const SatelliteSystem& sys,
+                                                         const SysTypesMap& mapObsTypes )
+        noexcept(false)
+    {
+        SysTable& table( sysTables[sys] );
+
+        string sysString(1, sys.toChar());
+
+        if(!table.prioriSet)
+        {
+            table.kept = ( find(sysVec.begin(), sysVec.end(), sys)
+                           != sysVec.end() );
+
+            // L1CG=> L1G; C1WG=>C1G
+            SysTypesMap::const_iterator it( sysPrioriTypes.find(sysString) );
+            if(it != sysPrioriTypes.end())
+            {
+                const TypeIDVec& prioriTypes( (*it).second );
+                for(size_t i=0; i<prioriTypes.size(); i++)
+                {
+                    string longTypeStr = prioriTypes[i].asString();
+                    table.longTypes.push_back(prioriTypes[i]);
+                    table.shortTypes.push_back(
+                        TypeID(longTypeStr.substr(0,2) + longTypeStr.substr(3,1)) );
+                }
+            }
+
+            table.prioriSet = true;
+        }
+
+        // the types of the header, if they changed since the last epoch
+        TypeIDVec noTypes;
+        SysTypesMap::const_iterator it( mapObsTypes.find(sysString) );
+        const TypeIDVec& obsTypes( it != mapObsTypes.end() ? (*it).second
+                                                           : noTypes );
+        if(obsTypes != table.obsTypes)
+        {
+            table.obsTypes = obsTypes;
+            table.isCode.resize(obsTypes.size());
+            for(size_t i=0; i<obsTypes.size(); i++)
+            {
+                table.isCode[i] = ( obsTypes[i].asString()[0] == 'C' );
+            }
+        }
+
+        return table;
+
+    }  // End of method 'PreprocessObs::getSysTable()'
+
+
+      /* Process the data of an epoch.
+       *
+       * @param mapObsTypes   Observation types of the header.
+       * @param satTypes      Good observation types of each satellite.
+       * @param satShortTypes 3-char types of each satellite.
+       * @param gData         Data object holding the data.
+       */
+    satTypeValueMap& PreprocessObs::Process( const SysTypesMap& mapObsTypes,
+                                             std::map<SatID, TypeIDVec>& satTypes,
+                                             std::map<SatID, TypeIDVec>& satShortTypes,
+                                             satTypeValueMap& gData )
+        noexcept(false)
+    {
+        try
+        {
+            EpochSatIDSet satRejectedSet;
+
+            // the satellites come sorted by system
+            SatelliteSystem::Systems lastSys(SatelliteSystem::Unknown);
+            SysTable* pTable(NULL);
+
+            // as RequiredObs, a system without types of its own keeps
+            // the ones of the satellite before
+            const TypeIDSet* pRequired(NULL);
+
+            std::vector<char> bad;
+            TypeIDVec goodTypes;
+
+            for(satTypeValueMap::iterator satIt = gData.begin();
+                satIt != gData.end();
+                ++satIt)
+            {
+                const SatID& sat( (*satIt).first );
+                typeValueMap& tvMap( (*satIt).second );
+
+                if( pTable == NULL || sat.system != lastSys )
+                {
+                    pTable = &getSysTable(sat.system, mapObsTypes);
+                    lastSys = sat.system;
+                }
+                const SysTable& table( *pTable );
+
+                //////////////////////////////
+                // KeepSystems
+                //////////////////////////////
+                if(!table.kept)
+                {
+                    satRejectedSet.insert(sat);
+                    continue;
+                }
+
+                //////////////////////////////
+                // FilterCode
+                //////////////////////////////
+                const TypeIDVec& typeVec( table.obsTypes );
+                bad.assign(typeVec.size(), 0);
+
+                // filter observable with zero values
+                for(size_t i=0; i<typeVec.size(); i++)
+                {
+                    const double* pValue( tvMap.tryGet(typeVec[i]) );
+                    if( pValue == NULL || (*pValue) == 0.0 )
+                    {
+                        tvMap.removeTypeID(typeVec[i]);
+                        bad[i] = 1;
+                    }
+                }
+
+                // codes out of bounds, with their phase, signal strength
+                // and doppler
+                for(size_t i=0; i<typeVec.size(); i++)
+                {
+                    if( !table.isCode[i] || bad[i] )
+                    {
+                        continue;
+                    }
+
+                    const double* pValue( tvMap.tryGet(typeVec[i]) );
+                    if( pValue == NULL || checkValue(*pValue) )
+                    {
+                        continue;
+                    }
+
+                    if(debug)
+                    {
+                        cout << getClassName() << ": sat:" << sat
+                             << " type:" << typeVec[i]
+                             << " value:" << (*pValue) << endl;
+                    }
+
+                    tvMap.removeTypeID(typeVec[i]);
+                    bad[i] = 1;
+
+                    string typeStr = typeVec[i].asString();
+                    const char relatedChars[3] = { 'L', 'S', 'D' };
+                    for(int k=0; k<3; k++)
+                    {
+                        typeStr[0] = relatedChars[k];
+                        TypeID relatedType(typeStr);
+
+                        tvMap.removeTypeID(relatedType);
+
+                        for(size_t j=0; j<typeVec.size(); j++)
+                        {
+                            if( !bad[j] && typeVec[j] == relatedType )
+                            {
+                                bad[j] = 1;
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                goodTypes.clear();
+                for(size_t i=0; i<typeVec.size(); i++)
+                {
+                    if(!bad[i])
+                    {
+                        goodTypes.push_back(typeVec[i]);
+                    }
+                }
+
+                if(goodTypes.empty())
+                {
+                    satRejectedSet.insert(sat);
+                    continue;
+                }
+
+                // good observation types for current satellite
+                satTypes[sat].swap(goodTypes);
+
+                //////////////////////////////
+                // ConvertObs
+                //////////////////////////////
+                TypeIDVec& shortTypes( satShortTypes[sat] );
+                for(size_t i=0; i<table.longTypes.size(); i++)
+                {
+                    const TypeID& shortType( table.shortTypes[i] );
+                    if(tvMap.tryGet(shortType) != NULL)
+                    {
+                        continue;
+                    }
+
+                    const double* pLong( tvMap.tryGet(table.longTypes[i]) );
+                    if(pLong != NULL)
+                    {
+                        // read first: inserting shortType may move the
+                        // values of a flat typeValueMap
+                        double value( *pLong );
+                        tvMap[shortType] = value;
+
+                        shortTypes.push_back(shortType);
+                    }
+                }
+
+                //////////////////////////////
+                // RequiredObs
+                //////////////////////////////
+                if( sat.system == SatelliteSystem::GPS ||
+                    sat.system == SatelliteSystem::GLONASS ||
+                    sat.system == SatelliteSystem::Galileo ||
+                    sat.system == SatelliteSystem::BDS )
+                {
+                    pRequired = &requiredTypes[sat.system];
+                }
+
+                if( pRequired == NULL || pRequired->empty() )
+                {
+                    satRejectedSet.insert(sat);
+                    continue;
+                }
+
+                for(TypeIDSet::const_iterator typeIt = pRequired->begin();
+                    typeIt != pRequired->end();
+                    ++typeIt)
+                {
+                    if(tvMap.tryGet(*typeIt) == NULL)
+                    {
+                        satRejectedSet.insert(sat);
+                        break;
+                    }
+                }
+            }
+
+            gData.removeSatID(satRejectedSet);
+
+            return gData;
+        }
+        catch(Exception& u)
+        {
+            // Throw an exception if something unexpected happens
+            ProcessingException e( getClassName() + ":" + u.what() );
+            THROW(e);
+        }
+
+    }  // End of method 'PreprocessObs::Process()'
+
+
+      // Process the data of an epoch, with the types of rxData.pHeader
+    void PreprocessObs::Process(Rx3ObsData& rxData)
+        noexcept(false)
+    {
+        if(rxData.pHeader == NULL)
+        {
+            ProcessingException e( getClassName()
+                                   + ": the header of the data is not set" );
+            THROW(e);
+        }
+
+        Process( (*rxData.pHeader).mapObsTypes, rxData.satTypes,
+                 rxData.satShortTypes, rxData.stvData );
+
+    }  // End of method 'PreprocessObs::Process()'
+
+}  // End of namespace gnssSpace
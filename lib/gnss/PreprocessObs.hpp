@@ -0,0 +1,184 @@
+#pragma ident "$Id$"
+
+/**
+ * @file PreprocessObs.hpp
+ * Preprocessing of the observables of an epoch in a single pass over the
+ * satellites: the work of KeepSystems, FilterCode, ConvertObs and
+ * RequiredObs, in this order.
+ */
+
+#ifndef PreprocessObs_HPP
+#define PreprocessObs_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "Exception.hpp"
+#include "Rx3ObsData.hpp"
+
+namespace gnssSpace
+{
+
+      /** This class does the preprocessing of KeepSystems, FilterCode,
+       *  ConvertObs and RequiredObs in one pass over the satellites,
+       *  with the same result as running them one after the other.
+       *
+       * Each of these classes walks all the satellites of the epoch and
+       * builds the strings of the TypeIDs again for each satellite. Here
+       * each satellite is visited once, the satellites rejected are
+       * removed once at the end, and what depends only on the system
+       * (observation types of the header, which of them are codes, short
+       * types to convert to) is worked out once per system and kept while
+       * the header types don't change.
+       *
+       * A typical way to use this class follows:
+       *
+       * @code
+       *   ChooseOptimalTypes chooseOptimalTypes;
+       *   SysTypesMap sysPrioriTypes = chooseOptimalTypes.get(rxHeader.mapObsTypes);
+       *
+       *   PreprocessObs preprocessObs("GEC");
+       *   preprocessObs.setSysPrioriTypes(sysPrioriTypes);
+       *   preprocessObs.addRequiredType(SatelliteSystem::GPS, TypeID::C1G);
+       *   preprocessObs.addRequiredType(SatelliteSystem::GPS, TypeID::C2G);
+       *
+       *   rxData.pHeader = &rxHeader;
+       *   while( rxStream >> rxData )
+       *   {
+       *      preprocessObs.Process(rxData);
+       *      ...
+       *   }
+       * @endcode
+       *
+       * Like RequiredObs, only the required types of GPS, GLONASS, Galileo
+       * and BDS are kept; satellites of other systems are checked with
+       * the types of the satellite before them.
+       */
+    class PreprocessObs
+    {
+    public:
+
+         /// Default constructor, keeping GPS
+        PreprocessObs()
+            : minLimit(15000000.0), maxLimit(45000000.0)
+        { setSystems("G"); };
+
+
+         /** Common constructor
+          *
+          * @param sysStr   Chars of the systems to keep, e.g. "GEC".
+          */
+        PreprocessObs(const std::string& sysStr)
+            : minLimit(15000000.0), maxLimit(45000000.0)
+        { setSystems(sysStr); };
+
+
+         /// Systems to keep, as in KeepSystems
+        virtual PreprocessObs& setSystems(const std::string& sysStr);
+
+
+         /// Minimum limit of the codes (in meters), as in FilterCode
+        virtual PreprocessObs& setMinLimit(const double& min)
+        { minLimit = min; return (*this); };
+
+         /// Maximum limit of the codes (in meters), as in FilterCode
+        virtual PreprocessObs& setMaxLimit(const double& max)
+        { maxLimit = max; return (*this); };
+
+
+         /// Types to convert to 3-char types, as in ConvertObs
+        virtual PreprocessObs& setSysPrioriTypes(const SysTypesMap& sysTypes);
+
+
+         /// Add a type to be required, as in RequiredObs
+        virtual PreprocessObs& addRequiredType( const SatelliteSystem& sys,
+                                                const TypeID& type );
+
+         /// Add a set of types to be required, as in RequiredObs
+        virtual PreprocessObs& addRequiredType( const SatelliteSystem& sys,
+                                                const TypeIDSet& typeSet );
+
+
+         /** Process the data of an epoch.
+          *
+          * @param mapObsTypes   Observation types of the header.
+          * @param satTypes      Good observation types of each satellite.
+          * @param satShortTypes 3-char types of each satellite.
+          * @param gData         Data object holding the data.
+          */
+        virtual satTypeValueMap& Process( const SysTypesMap& mapObsTypes,
+                                          std::map<SatID, TypeIDVec>& satTypes,
+                                          std::map<SatID, TypeIDVec>& satShortTypes,
+                                          satTypeValueMap& gData )
+            noexcept(false);
+
+
+        virtual void Process(SysTypesMap& mapObsTypes, Rx3ObsData& rxData)
+            noexcept(false)
+        {
+            Process( mapObsTypes, rxData.satTypes,
+                     rxData.satShortTypes, rxData.stvData );
+        };
+
+
+         /// Process the data of an epoch, with the types of rxData.pHeader
+        virtual void Process(Rx3ObsData& rxData)
+            noexcept(false);
+
+
+         /// Return a string identifying this object.
+        virtual std::string getClassName(void) const;
+
+
+         /// Destructor
+        virtual ~PreprocessObs() {};
+
+
+    private:
+
+         /// What depends only on the system of the satellite
+        struct SysTable
+        {
+            SysTable()
+                : kept(false), prioriSet(false)
+            {};
+
+             /// whether the system is kept
+            bool kept;
+
+             /// observation types of the header, and which are codes
+            TypeIDVec obsTypes;
+            std::vector<char> isCode;
+
+             /// long types to convert, and the short type of each one
+            bool prioriSet;
+            TypeIDVec longTypes;
+            TypeIDVec shortTypes;
+        };
+
+         /// Table of a system, updated to the types of the header
+        SysTable& getSysTable( const SatelliteSystem& sys,
+                               const SysTypesMap& mapObsTypes )
+            noexcept(false);
+
+         /// Whether a code value is within the limits
+        bool checkValue(const double& value) const
+        { return ( (value>=minLimit) && (value<=maxLimit) ); };
+
+        std::vector<SatelliteSystem> sysVec;
+
+        double minLimit;
+        double maxLimit;
+
+        SysTypesMap sysPrioriTypes;
+
+        std::map<SatelliteSystem, TypeIDSet> requiredTypes;
+
+        std::map<SatelliteSystem, SysTable> sysTables;
+
+    }; // End of class 'PreprocessObs'
+
+}  // End of namespace gnssSpace
+
+#endif   // PreprocessObs_HPP
@@ -0,0 +1,224 @@
+/**
+ * @file ProcessingPipeline.cpp
+ * Chain of processing stages, assembled by name and timed stage by stage.
+ */
+
+#include <sstream>
+#include <iomanip>
+
+#include "Counter.hpp"
+#include "ProcessingPipeline.hpp"
+
+using namespace std;
+using namespace timeSpace;
+
+namespace gnssSpace
+{
+
+      // Make a stage available under a name
+    ProcessingPipeline& ProcessingPipeline::registerStage( const std::string& stageName,
+                                                           StageFunction function )
+    {
+        std::map<std::string, size_t>::iterator it( stageIndex.find(stageName) );
+        if(it != stageIndex.end())
+        {
+            stages[(*it).second].function = function;
+            return (*this);
+        }
+
+        Stage stage;
+        stage.function = function;
+        stage.stats.name = stageName;
+
+        stageIndex[stageName] = stages.size();
+        stages.push_back(stage);
+
+        return (*this);
+
+    }  // End of method 'ProcessingPipeline::registerStage()'
+
+
+      // Set the chain from a list of registered names
+    void ProcessingPipeline::assemble(const std::string& stageList)
+        noexcept(false)
+    {
+        std::vector<size_t> newChain;
+
+        std::istringstream iss(stageList);
+        string stageName;
+        while(iss >> stageName)
+        {
+            std::map<std::string, size_t>::const_iterator it(
+                                                stageIndex.find(stageName) );
+            if(it == stageIndex.end())
+            {
+                InvalidRequest e( name + ": unknown stage '" + stageName + "'" );
+                THROW(e);
+            }
+            newChain.push_back((*it).second);
+        }
+
+        chain = newChain;
+
+    }  // End of method 'ProcessingPipeline::assemble()'
+
+
+      // Set the chain from a variable of a configuration file
+    void ProcessingPipeline::assemble( ConfigReader& confReader,
+                                       const std::string& variable,
+                                       const std::string& section )
+        noexcept(false)
+    {
+        string stageList;
+        try
+        {
+            stageList = confReader.getValue(variable, section);
+        }
+        catch(ConfigurationException& e)
+        {
+            if(!defaultChain.empty())
+            {
+                assemble(defaultChain);
+                return;
+            }
+
+            // not configured: all the stages, as registered
+            chain.clear();
+            for(size_t i=0; i<stages.size(); i++)
+            {
+                chain.push_back(i);
+            }
+            return;
+        }
+
+        assemble(stageList);
+
+    }  // End of method 'ProcessingPipeline::assemble()'
+
+
+      // Run the chain on the data of an epoch
+    void ProcessingPipeline::Process(Rx3ObsData& rxData)
+        noexcept(false)
+    {
+        for(size_t i=0; i<chain.size(); i++)
+        {
+            Stage& stage( stages[chain[i]] );
+
+            size_t numSats( rxData.stvData.size() );
+            double begin( Counter::now() );
+
+            stage.function(rxData);
+
+            stage.stats.seconds += Counter::now() - begin;
+            stage.stats.numCalls++;
+            if(rxData.stvData.size() < numSats)
+            {
+                stage.stats.satsRemoved += numSats - rxData.stvData.size();
+            }
+        }
+
+    }  // End of method 'ProcessingPipeline::Process()'
+
+
+      // Names of the stages of the chain, in order
+    std::vector<std::string> ProcessingPipeline::getStageNames() const
+    {
+        std::vector<std::string> names;
+        for(size_t i=0; i<chain.size(); i++)
+        {
+            names.push_back(stages[chain[i]].stats.name);
+        }
+        return names;
+    }
+
+
+      // Statistics of the stages of the chain, in order
+    std::vector<ProcessingPipeline::StageStats> ProcessingPipeline::getStats() const
+    {
+        std::vector<StageStats> stats;
+        for(size_t i=0; i<chain.size(); i++)
+        {
+            stats.push_back(stages[chain[i]].stats);
+        }
+        return stats;
+    }
+
+
+      // Set the statistics to zero
+    void ProcessingPipeline::resetStats()
+    {
+        for(size_t i=0; i<stages.size(); i++)
+        {
+            string stageName( stages[i].stats.name );
+            stages[i].stats = StageStats();
+            stages[i].stats.name = stageName;
+        }
+    }
+
+
+      // Add the statistics of the stages of the same names of another pipeline
+    void ProcessingPipeline::addStats(const ProcessingPipeline& other)
+    {
+        for(size_t i=0; i<other.stages.size(); i++)
+        {
+            const StageStats& otherStats( other.stages[i].stats );
+
+            std::map<std::string, size_t>::const_iterator it(
+                                        stageIndex.find(otherStats.name) );
+            if(it == stageIndex.end())
+            {
+                continue;
+            }
+
+            StageStats& stats( stages[(*it).second].stats );
+            stats.numCalls += otherStats.numCalls;
+            stats.seconds += otherStats.seconds;
+            stats.satsRemoved += otherStats.satsRemoved;
+        }
+    }
+
+
+      // Print the statistics of the stages
+    void ProcessingPipeline::printStats(std::ostream& s) const
+    {
+        std::ios::fmtflags oldFlags( s.flags() );
+        std::streamsize oldPrecision( s.precision() );
+
+        double total(0.0);
+        for(size_t i=0; i<chain.size(); i++)
+        {
+            total += stages[chain[i]].stats.seconds;
+        }
+
+        s << name << ":" << endl
+          << left << setw(24) << "  stage" << right
+          << setw(10) << "calls"
+          << setw(12) << "time(s)"
+          << setw(12) << "us/call"
+          << setw(8) << "%"
+          << setw(14) << "satsRemoved" << endl;
+
+        for(size_t i=0; i<chain.size(); i++)
+        {
+            const StageStats& stats( stages[chain[i]].stats );
+            s << left << setw(24) << "  " + stats.name << right
+              << setw(10) << stats.numCalls
+              << fixed << setprecision(3)
+              << setw(12) << stats.seconds
+              << setprecision(1)
+              << setw(12) << ( stats.numCalls ?
+                               1.e6*stats.seconds/stats.numCalls : 0.0 )
+              << setw(8) << ( total > 0.0 ? 100.0*stats.seconds/total : 0.0 )
+              << setw(14) << stats.satsRemoved << endl;
+        }
+
+        s << left << setw(24) << "  total" << right
+          << setw(10) << ""
+          << fixed << setprecision(3) << setw(12) << total << endl;
+
+        s.flags(oldFlags);
+        s.precision(oldPrecision);
+
+    }  // End of method 'ProcessingPipeline::printStats()'
+
+}  // End of namespace gnssSpace
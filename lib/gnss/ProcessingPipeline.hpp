@@ -0,0 +1,193 @@
+/**
+ * @file ProcessingPipeline.hpp
+ * Chain of processing stages with a uniform interface, assembled by name
+ * from a configuration file, and timed stage by stage.
+ */
+
+#ifndef ProcessingPipeline_HPP
+#define ProcessingPipeline_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <ostream>
+
+#include "Exception.hpp"
+#include "ConfigReader.hpp"
+#include "Rx3ObsData.hpp"
+
+using namespace utilSpace;
+
+namespace gnssSpace
+{
+
+      /** Chain of processing stages.
+       *
+       * The processing classes have slightly different 'Process()' methods,
+       * and some need more than the data (the receiver position, the
+       * observation types of the header, ...). So each one is registered
+       * under a name with a function taking only the Rx3ObsData, which does
+       * whatever the class needs. The chain itself is then a list of names,
+       * given in the code or read from a configuration file, so stages can
+       * be reordered or dropped without touching the code.
+       *
+       * Each stage counts its calls, its time and the satellites it
+       * removes; see printStats().
+       *
+       * @code
+       *   Triple rcvPos;
+       *
+       *   ProcessingPipeline model("model");
+       *   model.registerProcessor("computeDerivative", computeDerivative,
+       *       [&](){ computeDerivative.setCoordinates(rcvPos); } );
+       *   model.registerProcessor("computeTrop", computeTrop);
+       *   model.registerProcessor("prefit", sppPrefit);
+       *
+       *   // "model = computeDerivative computeTrop prefit" in the file
+       *   model.assemble(confReader, "model");
+       *
+       *   while( rxStream >> rxData )
+       *   {
+       *      model.Process(rxData);
+       *      ...
+       *   }
+       *
+       *   model.printStats(cout);
+       * @endcode
+       */
+    class ProcessingPipeline
+    {
+    public:
+
+         /// What a stage does with the data of an epoch
+        typedef std::function<void(Rx3ObsData&)> StageFunction;
+
+         /// Statistics of a stage
+        struct StageStats
+        {
+            StageStats()
+                : numCalls(0), seconds(0.0), satsRemoved(0)
+            {};
+
+            std::string name;
+            size_t numCalls;
+            double seconds;
+            size_t satsRemoved;
+        };
+
+
+         /// Constructor, with the name printed with the statistics
+        ProcessingPipeline(const std::string& pipelineName = "pipeline")
+            : name(pipelineName)
+        {};
+
+
+         /// Make a stage available under a name
+        virtual ProcessingPipeline& registerStage( const std::string& stageName,
+                                                   StageFunction function );
+
+
+         /** Make a processing object available under a name, for the
+          *  classes with a 'Process(Rx3ObsData&)' method. The object is
+          *  kept by reference.
+          *
+          * @param prepare   Called before each 'Process()', e.g. to give
+          *                  the object the current receiver position.
+          */
+        template <class P>
+        ProcessingPipeline& registerProcessor( const std::string& stageName,
+                                               P& processor,
+                                               std::function<void()> prepare
+                                                   = std::function<void()>() )
+        {
+            P* p(&processor);
+            return registerStage( stageName,
+                                  [p, prepare](Rx3ObsData& rxData)
+                                  {
+                                      if(prepare) prepare();
+                                      p->Process(rxData);
+                                  } );
+        };
+
+
+         /** Chain used by assemble() when the variable is not in the
+          *  configuration file, as a list of registered names; without
+          *  one, all the stages are chained in the order they were
+          *  registered.
+          */
+        virtual ProcessingPipeline& setDefaultChain(const std::string& stageList)
+        { defaultChain = stageList; return (*this); };
+
+
+         /** Set the chain from a list of registered names separated by
+          *  white space.
+          *
+          * @throw InvalidRequest if a name is not registered
+          */
+        virtual void assemble(const std::string& stageList)
+            noexcept(false);
+
+         /** Set the chain from a variable of a configuration file. If the
+          *  variable is not in the file, the default chain is used, see
+          *  setDefaultChain().
+          *
+          * @throw InvalidRequest if a name is not registered
+          */
+        virtual void assemble( ConfigReader& confReader,
+                               const std::string& variable,
+                               const std::string& section = "DEFAULT" )
+            noexcept(false);
+
+
+         /// Run the chain on the data of an epoch
+        virtual void Process(Rx3ObsData& rxData)
+            noexcept(false);
+
+
+         /// Names of the stages of the chain, in order
+        virtual std::vector<std::string> getStageNames() const;
+
+         /// Statistics of the stages of the chain, in order
+        virtual std::vector<StageStats> getStats() const;
+
+         /// Set the statistics to zero
+        virtual void resetStats();
+
+         /// Add the statistics of the stages of the same names of another
+         /// pipeline, e.g. of the same chain run on another thread
+        virtual void addStats(const ProcessingPipeline& other);
+
+         /// Print the statistics of the stages
+        virtual void printStats(std::ostream& s) const;
+
+
+         /// Destructor
+        virtual ~ProcessingPipeline() {};
+
+    private:
+
+        struct Stage
+        {
+            StageFunction function;
+            StageStats stats;
+        };
+
+        std::string name;
+
+         /// registered stages, and their order of registration
+        std::vector<Stage> stages;
+        std::map<std::string, size_t> stageIndex;
+
+         /// the chain, as indexes of stages
+        std::vector<size_t> chain;
+
+         /// chain when the configuration file has none, empty for all the
+         /// stages
+        std::string defaultChain;
+
+    };  // End of class 'ProcessingPipeline'
+
+}  // End of namespace gnssSpace
+
+#endif   // ProcessingPipeline_HPP
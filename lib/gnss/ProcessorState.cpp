@@ -0,0 +1,252 @@
+/**
+ * @file ProcessorState.cpp
+ * Snapshots of the state the processing objects keep from one epoch to
+ * the next (cycle-slip windows, arc numbers, filter state), to save it
+ * and to start another object from it.
+ */
+
+#include <fstream>
+#include <stdint.h>
+
+#include "ProcessorState.hpp"
+
+using namespace std;
+
+namespace gnssSpace
+{
+
+    const char StateFormat::magic[8] = { 'G','B','X','S','T','A','T','E' };
+
+
+      // Start the block of an object
+    void StateWriter::beginBlock(const std::string& className,
+                                 unsigned int version)
+    {
+        putString(className);
+        put(uint32_t(version));
+    }
+
+
+    void StateWriter::putString(const std::string& str)
+    {
+        put(uint32_t(str.size()));
+        buffer.insert(buffer.end(), str.begin(), str.end());
+    }
+
+
+    void StateWriter::putTime(const CommonTime& time)
+    {
+        long day, msod;
+        double fsod;
+        TimeSystem timeSys;
+        time.getInternal(day, msod, fsod, timeSys);
+        put(int32_t(day));
+        put(int32_t(msod));
+        put(fsod);
+        put(int32_t(timeSys.getTimeSystem()));
+    }
+
+
+    void StateWriter::putSat(const SatID& sat)
+    {
+        // the system by value: variables not indexed by satellite have
+        // an Unknown one, without a char to read it back
+        put(int8_t(sat.system));
+        put(int16_t(sat.id));
+    }
+
+
+    void StateWriter::putType(const TypeID& type)
+    {
+        putString(type.asString());
+    }
+
+
+    void StateWriter::putSource(const SourceID& source)
+    {
+        putString(source.sourceName);
+    }
+
+
+      // Write the snapshot to a file
+    void StateWriter::save(const std::string& fileName) const
+        noexcept(false)
+    {
+        ofstream strm(fileName.c_str(), ios::out | ios::binary);
+        if(!strm)
+        {
+            FileMissingException e("StateWriter: can't create " + fileName);
+            THROW(e);
+        }
+
+        uint32_t header[2] = { StateFormat::version,
+                               StateFormat::byteOrderMark };
+        uint64_t size( buffer.size() );
+        strm.write(StateFormat::magic, sizeof(StateFormat::magic));
+        strm.write(reinterpret_cast<const char*>(header), sizeof(header));
+        strm.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        strm.write(buffer.data(), buffer.size());
+
+        if(!strm)
+        {
+            FFStreamError e("StateWriter: error writing " + fileName);
+            THROW(e);
+        }
+
+    }  // End of method 'StateWriter::save()'
+
+
+      // Check that n more bytes are there
+    void StateReader::need(size_t n)
+        noexcept(false)
+    {
+        if(pos + n > buffer.size())
+        {
+            InvalidRequest e("StateReader: end of the snapshot");
+            THROW(e);
+        }
+    }
+
+
+      // Check that the next block is the one of the given class and version
+    void StateReader::checkBlock(const std::string& className,
+                                 unsigned int version)
+        noexcept(false)
+    {
+        string name( getString() );
+        if(name != className)
+        {
+            InvalidRequest e("StateReader: a state of " + name
+                             + " where one of " + className
+                             + " was expected");
+            THROW(e);
+        }
+
+        if(get<uint32_t>() != version)
+        {
+            InvalidRequest e("StateReader: the state of " + className
+                             + " has another version");
+            THROW(e);
+        }
+
+    }  // End of method 'StateReader::checkBlock()'
+
+
+    std::string StateReader::getString()
+        noexcept(false)
+    {
+        uint32_t size( get<uint32_t>() );
+        need(size);
+
+        string str( buffer.begin() + pos, buffer.begin() + pos + size );
+        pos += size;
+        return str;
+    }
+
+
+    CommonTime StateReader::getTime()
+        noexcept(false)
+    {
+        int32_t day( get<int32_t>() );
+        int32_t msod( get<int32_t>() );
+        double fsod( get<double>() );
+        int32_t timeSys( get<int32_t>() );
+
+        CommonTime time;
+        time.setInternal( day, msod, fsod,
+                          static_cast<TimeSystem::Systems>(timeSys) );
+        return time;
+    }
+
+
+    SatID StateReader::getSat()
+        noexcept(false)
+    {
+        int8_t sys( get<int8_t>() );
+        int16_t prn( get<int16_t>() );
+
+        if(sys < 0 || sys >= SatelliteSystem::count)
+        {
+            InvalidRequest e("StateReader: unknown satellite system");
+            THROW(e);
+        }
+
+        return SatID(prn, static_cast<SatelliteSystem::Systems>(sys));
+    }
+
+
+    TypeID StateReader::getType()
+        noexcept(false)
+    {
+        string name( getString() );
+        try
+        {
+            return TypeID(name);
+        }
+        catch(InvalidType& u)
+        {
+            InvalidRequest e("StateReader: unknown type " + name);
+            THROW(e);
+        }
+    }
+
+
+    SourceID StateReader::getSource()
+        noexcept(false)
+    {
+        SourceID source;
+        source.sourceName = getString();
+        return source;
+    }
+
+
+      // Read a snapshot written by StateWriter::save()
+    void StateReader::load(const std::string& fileName)
+        noexcept(false)
+    {
+        ifstream strm(fileName.c_str(), ios::in | ios::binary);
+        if(!strm)
+        {
+            FileMissingException e("StateReader: can't open " + fileName);
+            THROW(e);
+        }
+
+        char magic[8];
+        uint32_t header[2];
+        uint64_t size(0);
+        strm.read(magic, sizeof(magic));
+        strm.read(reinterpret_cast<char*>(header), sizeof(header));
+        strm.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if( !strm ||
+            std::memcmp(magic, StateFormat::magic, sizeof(magic)) != 0 )
+        {
+            FFStreamError e("StateReader: not a state file: " + fileName);
+            THROW(e);
+        }
+
+        if(header[1] != StateFormat::byteOrderMark)
+        {
+            FFStreamError e("StateReader: byte order of " + fileName
+                            + " differs from this machine");
+            THROW(e);
+        }
+
+        if(header[0] > StateFormat::version)
+        {
+            FFStreamError e("StateReader: " + fileName
+                            + " has a newer format version");
+            THROW(e);
+        }
+
+        buffer.resize(size);
+        if( size > 0 && !strm.read(buffer.data(), size) )
+        {
+            FFStreamError e("StateReader: truncated file " + fileName);
+            THROW(e);
+        }
+
+        pos = 0;
+
+    }  // End of method 'StateReader::load()'
+
+}  // End of namespace gnssSpace
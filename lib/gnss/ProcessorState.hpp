@@ -0,0 +1,205 @@
+/**
+ * @file ProcessorState.hpp
+ * Snapshots of the state the processing objects keep from one epoch to
+ * the next (cycle-slip windows, arc numbers, filter state), to save it
+ * and to start another object from it.
+ */
+
+#ifndef ProcessorState_HPP
+#define ProcessorState_HPP
+
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "SatID.hpp"
+#include "TypeID.hpp"
+#include "SourceID.hpp"
+
+using namespace utilSpace;
+using namespace timeSpace;
+
+namespace gnssSpace
+{
+
+      /** Layout of the snapshots written by StateWriter::save().
+       *
+       * The file starts with the magic "GBXSTATE", the format version
+       * (uint32), the byte order mark 0x01020304 (uint32) and the size of
+       * the snapshot (uint64), followed by the snapshot.
+       *
+       * In the snapshot, each object writes a block: its class name and
+       * the version of its layout, then its state. Times are written as
+       * their internal values, satellites as system (int8) and PRN
+       * (int16), and types and sources by name, so that a snapshot stays
+       * valid when TypeID values change. Values are in the byte order of
+       * the machine writing the snapshot.
+       */
+    struct StateFormat
+    {
+        static const char magic[8];
+
+         /// Version written, and the newest that can be read
+        static const unsigned int version = 1;
+
+        static const unsigned int byteOrderMark = 0x01020304;
+
+    };  // End of struct 'StateFormat'
+
+
+      /** Write the state of processing objects into a snapshot.
+       *
+       * @code
+       *   StateWriter writer;
+       *   markArc.saveState(writer);
+       *   filterSPP.saveState(writer);
+       *   writer.save("state.bin");
+       * @endcode
+       *
+       * @sa StateReader
+       */
+    class StateWriter
+    {
+    public:
+
+         /// Default constructor, with an empty snapshot
+        StateWriter() {};
+
+         /// Start the block of an object
+        void beginBlock(const std::string& className, unsigned int version);
+
+         /// Append a value of a plain type (int, double, bool, ...)
+        template <class T>
+        void put(const T& value)
+        {
+            const char* p( reinterpret_cast<const char*>(&value) );
+            buffer.insert(buffer.end(), p, p + sizeof(T));
+        }
+
+        void putString(const std::string& str);
+        void putTime(const CommonTime& time);
+        void putSat(const SatID& sat);
+        void putType(const TypeID& type);
+        void putSource(const SourceID& source);
+
+         /// The snapshot
+        const std::vector<char>& getData() const
+        { return buffer; };
+
+         /// Empty the snapshot
+        void clear()
+        { buffer.clear(); };
+
+         /** Write the snapshot to a file.
+          *
+          * @throw FileMissingException if it can't be created
+          * @throw FFStreamError if it can't be written
+          */
+        void save(const std::string& fileName) const
+            noexcept(false);
+
+    private:
+
+        std::vector<char> buffer;
+
+    };  // End of class 'StateWriter'
+
+
+      /** Read a snapshot written by StateWriter, in the same order.
+       *
+       * @code
+       *   StateReader reader;
+       *   reader.load("state.bin");
+       *   markArc.restoreState(reader);
+       *   filterSPP.restoreState(reader);
+       * @endcode
+       *
+       * The values are checked against the end of the snapshot, and each
+       * block against the class reading it, so a snapshot of other
+       * objects, or in another order, is refused instead of giving a
+       * wrong state.
+       */
+    class StateReader
+    {
+    public:
+
+         /// Default constructor, with an empty snapshot
+        StateReader()
+            : pos(0)
+        {};
+
+         /// Constructor, reading the given snapshot
+        StateReader(const std::vector<char>& data)
+            : buffer(data), pos(0)
+        {};
+
+         /** Check that the next block is the one of the given class and
+          *  version.
+          *
+          * @throw InvalidRequest if it is not
+          */
+        void checkBlock(const std::string& className, unsigned int version)
+            noexcept(false);
+
+         /** Take a value of a plain type.
+          *
+          * @throw InvalidRequest at the end of the snapshot
+          */
+        template <class T>
+        T get()
+            noexcept(false)
+        {
+            need(sizeof(T));
+
+            T value;
+            std::memcpy(&value, &buffer[pos], sizeof(T));
+            pos += sizeof(T);
+            return value;
+        }
+
+        std::string getString()
+            noexcept(false);
+        CommonTime getTime()
+            noexcept(false);
+        SatID getSat()
+            noexcept(false);
+        TypeID getType()
+            noexcept(false);
+        SourceID getSource()
+            noexcept(false);
+
+         /// true when all the snapshot has been read
+        bool atEnd() const
+        { return pos == buffer.size(); };
+
+         /// Read again from the start of the snapshot
+        void rewind()
+        { pos = 0; };
+
+         /** Read a snapshot written by StateWriter::save().
+          *
+          * @throw FileMissingException if it can't be opened
+          * @throw FFStreamError if it is not a file of this format, or is
+          *        written with another byte order or a newer version
+          */
+        void load(const std::string& fileName)
+            noexcept(false);
+
+    private:
+
+         /// Check that n more bytes are there
+        void need(size_t n)
+            noexcept(false);
+
+        std::vector<char> buffer;
+
+         /// position of the next value
+        size_t pos;
+
+    };  // End of class 'StateReader'
+
+}  // End of namespace gnssSpace
+
+#endif   // ProcessorState_HPP
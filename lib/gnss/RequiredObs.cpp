@@ -54,7 +54,7 @@ namespace gnssSpace
 
         try
         {
-            SatIDSet satRejectedSet;
+            EpochSatIDSet satRejectedSet;
 
             TypeIDSet requiredTypeSet;
 
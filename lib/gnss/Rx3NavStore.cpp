@@ -808,57 +808,89 @@ namespace gnssSpace
     GPSEphemeris Rx3NavStore::findGPSEphemeris(const SatID& sat , const CommonTime& epoch)
     {
         GPSWeekSecond targetWS(epoch);
-        for(auto it:gpsEphData[sat])
+        auto satIt = gpsEphData.find(sat);
+        if(satIt != gpsEphData.end())
         {
-            GPSWeekSecond ws(it.first);
-            double diff = ws.sow - targetWS.sow;
-            if( diff > -7200 && diff <7200)
+            for(auto& it : satIt->second)
             {
-                return it.second;
+                GPSWeekSecond ws(it.first);
+                double diff = ws.sow - targetWS.sow;
+                if( diff > -7200 && diff <7200)
+                {
+                    return it.second;
+                }
             }
         }
+
+        InvalidRequest e("No ephemeris for satellite " + sat.toString()
+                         + " at " + epoch.asString());
+        THROW(e);
     }
 
     BDSEphemeris Rx3NavStore::findBDSEphemeris(const SatID& sat , const CommonTime& epoch)
     {
         GPSWeekSecond targetWS(epoch);
-        for(auto it:bdsEphData[sat])
+        auto satIt = bdsEphData.find(sat);
+        if(satIt != bdsEphData.end())
         {
-            GPSWeekSecond ws(it.first);
-            double diff = ws.sow - targetWS.sow;
-            if( diff > -7200 && diff <7200)
+            for(auto& it : satIt->second)
             {
-                return it.second;
+                GPSWeekSecond ws(it.first);
+                double diff = ws.sow - targetWS.sow;
+                if( diff > -7200 && diff <7200)
+                {
+                    return it.second;
+                }
             }
         }
+
+        InvalidRequest e("No ephemeris for satellite " + sat.toString()
+                         + " at " + epoch.asString());
+        THROW(e);
     }
 
     GalEphemeris Rx3NavStore::findGalEphemeris(const SatID& sat , const CommonTime& epoch)
     {
         GPSWeekSecond targetWS(epoch);
-        for(auto it:galEphData[sat])
+        auto satIt = galEphData.find(sat);
+        if(satIt != galEphData.end())
         {
-            GPSWeekSecond ws(it.first);
-            double diff = ws.sow - targetWS.sow;
-            if( diff > -7200 && diff <7200)
+            for(auto& it : satIt->second)
             {
-                return it.second;
+                GPSWeekSecond ws(it.first);
+                double diff = ws.sow - targetWS.sow;
+                if( diff > -7200 && diff <7200)
+                {
+                    return it.second;
+                }
             }
         }
+
+        InvalidRequest e("No ephemeris for satellite " + sat.toString()
+                         + " at " + epoch.asString());
+        THROW(e);
     }
 
     GloEphemeris Rx3NavStore::findGloEphemeris(const SatID& sat , const CommonTime& epoch)
     {
         GPSWeekSecond targetWS(epoch);
-        for(auto it:gloEphData[sat])
+        auto satIt = gloEphData.find(sat);
+        if(satIt != gloEphData.end())
         {
-            GPSWeekSecond ws(it.first);
-            double diff = ws.sow - targetWS.sow;
-            if( diff > -1800 && diff <1800)
+            for(auto& it : satIt->second)
             {
-                return it.second;
+                GPSWeekSecond ws(it.first);
+                double diff = ws.sow - targetWS.sow;
+                if( diff > -1800 && diff <1800)
+                {
+                    return it.second;
+                }
             }
         }
+
+        InvalidRequest e("No ephemeris for satellite " + sat.toString()
+                         + " at " + epoch.asString());
+        THROW(e);
     }
 
 }  // namespace gnssSpace
@@ -399,8 +399,6 @@ namespace gnssSpace
    void Rx3ObsData::readRecordVer2(std::fstream& strm)
       noexcept(false)
    {
-      static CommonTime previousTime(CommonTime::BEGINNING_OF_TIME);
-
          // get the epoch line and check
       string line;
       while(line.empty())        // ignore blank lines in place of epoch lines
@@ -465,7 +463,6 @@ namespace gnssSpace
             if(line.substr(0,26) == string(26, ' '))
             {
                currEpoch = CommonTime::BEGINNING_OF_TIME;
-               //currEpoch = previousTime; ??
             }
             else
             {
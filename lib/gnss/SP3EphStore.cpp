@@ -9,6 +9,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <exception>
 
 #include "Exception.hpp"
 #include "SatID.hpp"
@@ -56,10 +57,13 @@ namespace gnssSpace
         catch (InvalidRequest &e)
         {RETHROW(e); }
 
-        try
-        { crec = clkStore.getValue(sat, ttag); }
-        catch (InvalidRequest &e)
-        {RETHROW(e); }
+        if (!clkTable.getValue(sat, ttag, crec.bias, crec.drift))
+        {
+            try
+            { crec = clkStore.getValue(sat, ttag); }
+            catch (InvalidRequest &e)
+            {RETHROW(e); }
+        }
 
         try
         {
@@ -88,6 +92,58 @@ namespace gnssSpace
         {RETHROW(e); }
     }
 
+    // Compute orbit and clock of one satellite at each of a list of times,
+    // in one pass over its tables.
+    // param[out] rec 11 values per time: position (m), velocity (m/s),
+    //    acceleration (m/s/s), clock bias (s) and clock drift (s/s)
+    // return the number of times for which the values were computed
+    int SP3EphStore::getXvtValues(const SatID &sat,
+                                  const std::vector<CommonTime> &ttags,
+                                  std::vector<double> &rec,
+                                  std::vector<char> &ok) const throw()
+    {
+        const size_t N(ttags.size());
+        rec.assign(11 * N, 0.0);
+
+        std::vector<double> pva;
+        posStore.getValues(sat, ttags, pva, ok);
+
+        // SP3 clock in microsec, RINEX clock in sec
+        const double clkFactor(useSP3clock ? 1.e-6 : 1.0);
+
+        int nok(0);
+        for (size_t k = 0; k < N; k++)
+        {
+            if (!ok[k]) continue;
+
+            ClockRecord crec;
+            if (!clkTable.getValue(sat, ttags[k], crec.bias, crec.drift))
+            {
+                try
+                { crec = clkStore.getValue(sat, ttags[k]); }
+                catch (InvalidRequest &e)
+                {
+                    ok[k] = 0;
+                    continue;
+                }
+            }
+
+            double *r(&rec[11 * k]);
+            const double *p(&pva[9 * k]);
+            for (int i = 0; i < 3; i++)
+            {
+                r[i] = p[i] * 1000.0;           // km -> m
+                r[3 + i] = p[3 + i] * 0.1;      // dm/s -> m/s
+                r[6 + i] = p[6 + i];            // m/s/s
+            }
+            r[9] = crec.bias * clkFactor;
+            r[10] = crec.drift * clkFactor;
+            nok++;
+        }
+
+        return nok;
+    }
+
     // Determine the earliest time for which this object can successfully
     // determine the Xvt for any object.
     // return the earliest time in the table
@@ -242,6 +298,25 @@ namespace gnssSpace
     // stores. Also update the FileStore with the filename and SP3 header.
     void SP3EphStore::loadSP3Store(const string &filename, bool fillClockStore)
     noexcept(false)
+    {
+        try
+        {
+            SP3FileTable table;
+            readSP3File(filename, fillClockStore, table);
+            mergeSP3File(filename, table, fillClockStore);
+        }
+        catch (Exception &e)
+        {
+            RETHROW(e);
+        }
+    }
+
+
+    // Read an SP3 file into a table, applying the reject flags, without
+    // touching the store.
+    void SP3EphStore::readSP3File(const string &filename, bool fillClockStore,
+                                  SP3FileTable &table) const
+    noexcept(false)
     {
         try
         {
@@ -255,7 +330,7 @@ namespace gnssSpace
             }
 
             // declare header and data
-            SP3EphHeader head;
+            SP3EphHeader& head(table.head);
 
             // read the SP3 ephemeris header
             try
@@ -269,33 +344,6 @@ namespace gnssSpace
             }
             //cout << "Read header" << endl; head.dump();
 
-            // check/save TimeSystem to storeTimeSystem
-            if (head.timeSystem != TimeSystem::Any && head.timeSystem != TimeSystem::Unknown)
-            {
-                // if store time system has not been set, do so
-                if (storeTimeSystem == TimeSystem::Any)
-                {
-                    // NB. store-, pos- and clk- TimeSystems must always be the same
-                    storeTimeSystem = head.timeSystem;
-                    posStore.setTimeSystem(head.timeSystem);
-                    clkStore.setTimeSystem(head.timeSystem);
-                }
-
-                    // if store system has been set, and it doesn't agree, throw
-                else if (storeTimeSystem != head.timeSystem)
-                {
-                    InvalidRequest ir("Time system of file " + filename
-                                      + " (" + head.timeSystem.asString()
-                                      + ") is incompatible with store time system ("
-                                      + storeTimeSystem.asString() + ").");
-                    THROW(ir);
-                }
-
-            }  // end if header time system is set
-
-            // save in FileStore
-            SP3Files.addFile(filename, head);
-
             // define SP3EphData
             SP3EphData data;
 
@@ -311,11 +359,8 @@ namespace gnssSpace
             prec.Pos = prec.sigPos = prec.Vel = prec.sigVel
                     = prec.Acc = prec.sigAcc = Triple(0, 0, 0);
 
-            if (fillClockStore)
-            {
-                crec.bias = crec.drift = crec.sig_bias = crec.sig_drift = 0.0;
-                crec.accel = crec.sig_accel = 0.0;
-            }
+            crec.bias = crec.drift = crec.sig_bias = crec.sig_drift = 0.0;
+            crec.accel = crec.sig_accel = 0.0;
 
             try
             {
@@ -485,10 +530,14 @@ namespace gnssSpace
                         else
                         {
                             //cout << "Add rec: " << sat << " " << ttag << " " << prec<<endl;
-                            if (!rejectPredPosFlag || !predP)
-                                posStore.addPositionRecord(sat, ttag, prec);
-                            if (fillClockStore && (!rejectPredClockFlag || !predC))
-                                clkStore.addClockRecord(sat, ttag, crec);
+                            SP3FileRecord rec;
+                            rec.sat = sat;
+                            rec.ttag = ttag;
+                            rec.prec = prec;
+                            rec.crec = crec;
+                            rec.addPos = (!rejectPredPosFlag || !predP);
+                            rec.addClk = (fillClockStore && (!rejectPredClockFlag || !predC));
+                            table.records.push_back(rec);
 
                             // prepare for next
                             haveP = haveV = haveEP = haveEV = predP = predC = false;
@@ -520,10 +569,14 @@ namespace gnssSpace
                     else
                     {
                         //cout << "Add last rec: "<< sat <<" "<< ttag <<" "<< prec << endl;
-                        if (!rejectPredPosFlag || !predP)
-                            posStore.addPositionRecord(sat, ttag, prec);
-                        if (fillClockStore && (!rejectPredClockFlag || !predC))
-                            clkStore.addClockRecord(sat, ttag, crec);
+                        SP3FileRecord rec;
+                        rec.sat = sat;
+                        rec.ttag = ttag;
+                        rec.prec = prec;
+                        rec.crec = crec;
+                        rec.addPos = (!rejectPredPosFlag || !predP);
+                        rec.addClk = (fillClockStore && (!rejectPredClockFlag || !predC));
+                        table.records.push_back(rec);
                     }
                 }
             }
@@ -549,6 +602,67 @@ namespace gnssSpace
     }
 
 
+    // Merge a table read by readSP3File() into the store.
+    void SP3EphStore::mergeSP3File(const string &filename, SP3FileTable &table,
+                                   bool fillClockStore)
+    noexcept(false)
+    {
+        try
+        {
+            SP3EphHeader& head(table.head);
+
+            // check/save TimeSystem to storeTimeSystem
+            if (head.timeSystem != TimeSystem::Any && head.timeSystem != TimeSystem::Unknown)
+            {
+                // if store time system has not been set, do so
+                if (storeTimeSystem == TimeSystem::Any)
+                {
+                    // NB. store-, pos- and clk- TimeSystems must always be the same
+                    storeTimeSystem = head.timeSystem;
+                    posStore.setTimeSystem(head.timeSystem);
+                    clkStore.setTimeSystem(head.timeSystem);
+                }
+
+                    // if store system has been set, and it doesn't agree, throw
+                else if (storeTimeSystem != head.timeSystem)
+                {
+                    InvalidRequest ir("Time system of file " + filename
+                                      + " (" + head.timeSystem.asString()
+                                      + ") is incompatible with store time system ("
+                                      + storeTimeSystem.asString() + ").");
+                    THROW(ir);
+                }
+
+            }  // end if header time system is set
+
+            // save in FileStore
+            SP3Files.addFile(filename, head);
+            if (fillClockStore) clkTable.clear();
+
+            try
+            {
+                for (size_t i = 0; i < table.records.size(); i++)
+                {
+                    const SP3FileRecord& rec(table.records[i]);
+                    if (rec.addPos)
+                        posStore.addPositionRecord(rec.sat, rec.ttag, rec.prec);
+                    if (fillClockStore && rec.addClk)
+                        clkStore.addClockRecord(rec.sat, rec.ttag, rec.crec);
+                }
+            }
+            catch (Exception &e)
+            {
+                e.addText("Error reading data of file " + filename);
+                RETHROW(e);
+            }
+        }
+        catch (Exception &e)
+        {
+            RETHROW(e);
+        }
+    }
+
+
     // Load an SP3 ephemeris file; may set the velocity and acceleration flags.
     // If the clock store uses RINEX clock files, this ignores the clock data.
     void SP3EphStore::loadSP3File(const std::string &filename)
@@ -564,6 +678,52 @@ namespace gnssSpace
         }
     }
 
+
+    // Load a list of SP3 ephemeris files, parsed concurrently and merged
+    // into the store in the given order.
+    void SP3EphStore::loadSP3Files(const std::vector<std::string> &filenames)
+    noexcept(false)
+    {
+        int nfile(filenames.size());
+        std::vector<SP3FileTable> tables(nfile);
+        std::vector<std::exception_ptr> errors(nfile);
+
+        // parsing is independent for each file; the store is not touched
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < nfile; i++)
+        {
+            try
+            {
+                readSP3File(filenames[i], useSP3clock, tables[i]);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+
+        // merge in file order, so that boundary epochs and time system
+        // checks behave as for sequential loading
+        try
+        {
+            for (int i = 0; i < nfile; i++)
+            {
+                if (errors[i]) std::rethrow_exception(errors[i]);
+                mergeSP3File(filenames[i], tables[i], useSP3clock);
+
+                // release the file table once merged
+                std::vector<SP3FileRecord>().swap(tables[i].records);
+            }
+        }
+        catch (Exception &e)
+        {
+            RETHROW(e);
+        }
+    }
+
+
     // Load a RINEX clock file; may set the 'have' bias and drift flags
     void SP3EphStore::loadRinexClockFile(const std::string &filename)
     noexcept(false)
@@ -572,6 +732,24 @@ namespace gnssSpace
         {
             if (useSP3clock) useRinexClockData();
 
+            ClockFileTable table;
+            if (readRinexClockFile(filename, table))
+                mergeRinexClockFile(filename, table);
+        }
+        catch (Exception &e)
+        {
+            RETHROW(e);
+        }
+    }
+
+
+    // Read a RINEX clock file into a table without touching the store.
+    bool SP3EphStore::readRinexClockFile(const std::string &filename,
+                                         ClockFileTable &table) const
+    noexcept(false)
+    {
+        try
+        {
             // open the input stream
             std::fstream strm(filename.c_str());
             if (!strm)
@@ -581,7 +759,7 @@ namespace gnssSpace
             }
 
             // declare header and data
-            Rx3ClockHeader head;
+            Rx3ClockHeader& head(table.head);
             Rx3ClockData data;
 
             // read the RINEX clock header
@@ -601,43 +779,15 @@ namespace gnssSpace
                 head.dumpValid();
             }
 
-            // check/save TimeSystem to storeTimeSystem
-            if (head.timeSystem != TimeSystem::Any &&
-                head.timeSystem != TimeSystem::Unknown)
-            {
-                // if store time system has not been set, do so
-                if (storeTimeSystem == TimeSystem::Any)
-                {
-                    // NB. store-, pos- and clk- TimeSystems must always be the same
-                    storeTimeSystem = head.timeSystem;
-                    posStore.setTimeSystem(head.timeSystem);
-                    clkStore.setTimeSystem(head.timeSystem);
-                }
-
-                    // if store system has been set, and it doesn't agree, throw
-                else if (storeTimeSystem != head.timeSystem)
-                {
-                    InvalidRequest ir("Time system of file " + filename
-                                      + " (" + head.timeSystem.asString()
-                                      + ") is incompatible with store time system ("
-                                      + storeTimeSystem.asString() + ").");
-                    THROW(ir);
-                }
-            }  // end if header time system is set
-
                 // there is no way to determine the time system....this is a problem TD
                 // TD SP3EphStore::fixTimeSystem() ??
-            else
+            table.defaultTimeSystem = (head.timeSystem == TimeSystem::Any ||
+                                       head.timeSystem == TimeSystem::Unknown);
+            if (table.defaultTimeSystem)
             {
                 head.timeSystem = TimeSystem::GPS;
-                storeTimeSystem = head.timeSystem;
-                posStore.setTimeSystem(head.timeSystem);
-                clkStore.setTimeSystem(head.timeSystem);
             }
 
-            // save in FileStore
-            clkFiles.addFile(filename, head);
-
             // read data
             try
             {
@@ -672,7 +822,9 @@ namespace gnssSpace
                         rec.sig_drift = data.sig_drift;
                         rec.accel = data.accel;
                         rec.sig_accel = data.sig_accel;
-                        clkStore.addClockRecord(data.sat, data.time, rec);
+                        table.sats.push_back(data.sat);
+                        table.times.push_back(data.time);
+                        table.records.push_back(rec);
                     }
                 }
             }
@@ -687,7 +839,118 @@ namespace gnssSpace
         }
         catch (EndOfFile &e)
         {
-            return;
+            return false;
+        }
+        catch (Exception &e)
+        {
+            RETHROW(e);
+        }
+
+        return true;
+    }
+
+
+    // Merge a table read by readRinexClockFile() into the store.
+    void SP3EphStore::mergeRinexClockFile(const std::string &filename,
+                                          ClockFileTable &table)
+    noexcept(false)
+    {
+        try
+        {
+            Rx3ClockHeader& head(table.head);
+
+            // check/save TimeSystem to storeTimeSystem
+            if (!table.defaultTimeSystem)
+            {
+                // if store time system has not been set, do so
+                if (storeTimeSystem == TimeSystem::Any)
+                {
+                    // NB. store-, pos- and clk- TimeSystems must always be the same
+                    storeTimeSystem = head.timeSystem;
+                    posStore.setTimeSystem(head.timeSystem);
+                    clkStore.setTimeSystem(head.timeSystem);
+                }
+
+                    // if store system has been set, and it doesn't agree, throw
+                else if (storeTimeSystem != head.timeSystem)
+                {
+                    InvalidRequest ir("Time system of file " + filename
+                                      + " (" + head.timeSystem.asString()
+                                      + ") is incompatible with store time system ("
+                                      + storeTimeSystem.asString() + ").");
+                    THROW(ir);
+                }
+            }  // end if header time system is set
+            else
+            {
+                storeTimeSystem = head.timeSystem;
+                posStore.setTimeSystem(head.timeSystem);
+                clkStore.setTimeSystem(head.timeSystem);
+            }
+
+            // save in FileStore
+            clkFiles.addFile(filename, head);
+            clkTable.clear();
+
+            try
+            {
+                for (size_t i = 0; i < table.records.size(); i++)
+                    clkStore.addClockRecord(table.sats[i], table.times[i],
+                                            table.records[i]);
+            }
+            catch (Exception &e)
+            {
+                e.addText("Error reading data of file " + filename);
+                RETHROW(e);
+            }
+        }
+        catch (Exception &e)
+        {
+            RETHROW(e);
+        }
+    }
+
+
+    // Load a list of RINEX clock files, parsed concurrently and merged into
+    // the store in the given order.
+    void SP3EphStore::loadRinexClockFiles(const std::vector<std::string> &filenames)
+    noexcept(false)
+    {
+        if (useSP3clock) useRinexClockData();
+
+        int nfile(filenames.size());
+        std::vector<ClockFileTable> tables(nfile);
+        std::vector<char> haveData(nfile, 0);
+        std::vector<std::exception_ptr> errors(nfile);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < nfile; i++)
+        {
+            try
+            {
+                haveData[i] = readRinexClockFile(filenames[i], tables[i]);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+
+        try
+        {
+            for (int i = 0; i < nfile; i++)
+            {
+                if (errors[i]) std::rethrow_exception(errors[i]);
+                if (!haveData[i]) continue;
+                mergeRinexClockFile(filenames[i], tables[i]);
+
+                // release the file table once merged
+                ClockFileTable empty;
+                std::swap(tables[i].records, empty.records);
+                std::swap(tables[i].times, empty.times);
+            }
         }
         catch (Exception &e)
         {
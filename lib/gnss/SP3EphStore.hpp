@@ -21,6 +21,7 @@
 
 #include "FileStore.hpp"
 #include "ClockSatStore.hpp"
+#include "ClockTable.hpp"
 #include "PositionSatStore.hpp"
 
 #include "SP3EphHeader.hpp"
@@ -57,6 +58,10 @@ namespace gnssSpace
          /// ClockSatStore for SP3 OR RINEX clock data
         ClockSatStore clkStore;
 
+         /** Regular grid copy of the clock data, used before clkStore
+          * when valid; see useClockTable() */
+        ClockTable clkTable;
+
          /// FileStore for the SP3 input files
         FileStore<SP3EphHeader> SP3Files;
 
@@ -88,6 +93,37 @@ namespace gnssSpace
           * from RINEX clock files. */
         bool rejectPredClockFlag;
 
+         /// One record of an SP3 file, with the store flags already applied.
+        struct SP3FileRecord
+        {
+            SatID sat;
+            CommonTime ttag;
+            PositionRecord prec;
+            ClockRecord crec;
+            bool addPos;         ///< false if rejected as predicted position
+            bool addClk;         ///< false if rejected, or clocks not wanted
+        };
+
+         /** Header and records of one SP3 file. Files are read into
+          * these tables independently of the store, so that several
+          * files may be parsed concurrently and then merged in order. */
+        struct SP3FileTable
+        {
+            SP3EphHeader head;
+            std::vector<SP3FileRecord> records;
+        };
+
+         /** Header and 'AS' records of one RINEX clock file, read
+          * independently of the store (see SP3FileTable). */
+        struct ClockFileTable
+        {
+            Rx3ClockHeader head;
+            bool defaultTimeSystem;  ///< header had no time system, GPS assumed
+            std::vector<SatID> sats;
+            std::vector<CommonTime> times;
+            std::vector<ClockRecord> records;
+        };
+
          // member functions
 
          /** Private utility routine used by the loadFile and
@@ -99,6 +135,33 @@ namespace gnssSpace
         void loadSP3Store(const std::string& filename, bool fillClockStore)
             noexcept(false);
 
+         /** Read an SP3 file into a table, applying the reject flags,
+          * without touching the store. Safe to call concurrently. */
+        void readSP3File(const std::string& filename, bool fillClockStore,
+                         SP3FileTable& table) const
+            noexcept(false);
+
+         /** Merge a table read by readSP3File() into the store: check
+          * and set the time system, add the file to the FileStore and
+          * add the records. Records for epochs already in the store
+          * (e.g. the boundary epoch of consecutive files) are updated,
+          * exactly as when the files are loaded one by one. */
+        void mergeSP3File(const std::string& filename, SP3FileTable& table,
+                          bool fillClockStore)
+            noexcept(false);
+
+         /** Read a RINEX clock file into a table without touching the
+          * store. Safe to call concurrently.
+          * @return false if the file ended before any data. */
+        bool readRinexClockFile(const std::string& filename,
+                                ClockFileTable& table) const
+            noexcept(false);
+
+         /// Merge a table read by readRinexClockFile() into the store.
+        void mergeRinexClockFile(const std::string& filename,
+                                 ClockFileTable& table)
+            noexcept(false);
+
     public:
 
          /// Default constructor
@@ -127,6 +190,21 @@ namespace gnssSpace
         virtual Xvt getXvt(const SatID& sat, const CommonTime& ttag)
             noexcept(false);
 
+         /** Compute orbit and clock of one satellite at each of a list of
+          * times, in one pass over its tables (see
+          * PositionSatStore::getValues()).
+          * @param[in] sat the satellite of interest
+          * @param[in] ttags the times to look up
+          * @param[out] rec 11 values per time: position (m), velocity (m/s),
+          *    acceleration (m/s/s), clock bias (s) and clock drift (s/s)
+          * @param[out] ok 1 if orbit and clock at this time could be
+          *    computed, else 0
+          * @return the number of times for which the values were computed */
+        int getXvtValues(const SatID& sat,
+                         const std::vector<CommonTime>& ttags,
+                         std::vector<double>& rec,
+                         std::vector<char>& ok) const throw();
+
          /** Dump information about the store to an ostream.
           * @param[in] os ostream to receive the output; defaults to std::cout
           * @param[in] detail integer level of detail to provide;
@@ -167,6 +245,7 @@ namespace gnssSpace
         {
             posStore.edit(tmin, tmax);
             clkStore.edit(tmin, tmax);
+            clkTable.clear();
         }
 
          /// Clear the dataset, meaning remove all data
@@ -292,6 +371,7 @@ namespace gnssSpace
         virtual void clearClock(void) throw()
         { 
             clkStore.clear(); 
+            clkTable.clear();
         }
 
 
@@ -437,6 +517,36 @@ namespace gnssSpace
         void setClockLinearInterp(void) throw()
         { clkStore.setLinearInterp(); }
 
+         /** Copy the clock data, once loaded, into a table on a regular
+          * time grid, which is then used by getXvt() and getXvtValues()
+          * instead of the clock store. This is much faster for high-rate
+          * (e.g. 30 s or 5 s) RINEX clocks, where interpolation with few
+          * points is enough. Where the table can not give a value (gaps,
+          * ends of the data) the clock store is used as before. The table
+          * is dropped whenever the clock data change.
+          * @param nPoints 2 for linear (same values as the linear clock
+          *    store) or 3 for quadratic interpolation
+          * @return false if the clock data are not on one regular grid,
+          *    then the clock store alone is used */
+        bool useClockTable(int nPoints = 2) throw()
+        {
+            try
+            {
+                clkTable.setInterpolationPoints(nPoints);
+                clkTable.build(clkStore);
+            }
+            catch(InvalidRequest& e) { return false; }
+            return true;
+        }
+
+         /// Stop using the clock table
+        void dropClockTable(void) throw()
+        { clkTable.clear(); }
+
+         /// Get the clock table, e.g. for batch evaluation of all satellites
+        const ClockTable& getClockTable(void) const throw()
+        { return clkTable; }
+
 
          /** Get a list (std::vector) of SatIDs present in both clock
           * and position stores */
@@ -517,6 +627,22 @@ namespace gnssSpace
           * @throw if time step is inconsistent with previous value */
         void loadRinexClockFile(const std::string& filename) noexcept(false);
 
+         /** Load a list of SP3 ephemeris files. The files are parsed
+          * concurrently (when built with USE_OPENMP) and then merged
+          * into the store in the order given, so the result is the
+          * same as calling loadSP3File() for each file in turn.
+          * @param filenames names of files (SP3 format) to load
+          * @throw the first error, in file order; files before the
+          *   failing one are already in the store */
+        void loadSP3Files(const std::vector<std::string>& filenames)
+            noexcept(false);
+
+         /** Load a list of RINEX clock files, parsed concurrently and
+          * merged in the order given (see loadSP3Files()).
+          * @param filenames names of files (RINEX clock format) to load */
+        void loadRinexClockFiles(const std::vector<std::string>& filenames)
+            noexcept(false);
+
 
          /** Add a complete PositionRecord to the store; this is the
           * preferred method of adding data to the tables.
@@ -561,7 +687,7 @@ namespace gnssSpace
                             const ClockRecord& rec)
             noexcept(false)
         {
-            try { clkStore.addClockRecord(sat,ttag,rec); }
+            try { clkStore.addClockRecord(sat,ttag,rec); clkTable.clear(); }
             catch(InvalidRequest& ir) { RETHROW(ir); }
         }
 
@@ -570,7 +696,7 @@ namespace gnssSpace
                           const double& bias, const double& sig=0.0)
             noexcept(false)
         {
-            try { clkStore.addClockBias(sat,ttag,bias,sig); }
+            try { clkStore.addClockBias(sat,ttag,bias,sig); clkTable.clear(); }
             catch(InvalidRequest& ir) { RETHROW(ir); }
         }
 
@@ -579,7 +705,7 @@ namespace gnssSpace
                            const double& drift, const double& sig=0.0)
             noexcept(false)
         {
-            try { clkStore.addClockDrift(sat,ttag,drift,sig); }
+            try { clkStore.addClockDrift(sat,ttag,drift,sig); clkTable.clear(); }
             catch(InvalidRequest& ir) { RETHROW(ir); }
         }
 
@@ -588,7 +714,7 @@ namespace gnssSpace
                                   const double& accel, const double& sig=0.0)
             noexcept(false)
         {
-            try { clkStore.addClockAcceleration(sat,ttag,accel,sig); }
+            try { clkStore.addClockAcceleration(sat,ttag,accel,sig); clkTable.clear(); }
             catch(InvalidRequest& ir) { RETHROW(ir); }
         }
 
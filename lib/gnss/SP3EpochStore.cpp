@@ -0,0 +1,270 @@
+/// @file SP3EpochStore.cpp
+/// Precompute the orbits and clocks of a SP3EphStore at the epochs of an
+/// observation file, and keep them in a compact per-epoch table.
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+#include "Exception.hpp"
+#include "Rx3ObsHeader.hpp"
+#include "Rx3ObsData.hpp"
+
+#include "SP3EpochStore.hpp"
+
+using namespace std;
+
+#define debug 0
+
+using namespace utilSpace;
+using namespace coordSpace;
+using namespace timeSpace;
+using namespace mathSpace;
+namespace gnssSpace
+{
+    // Compute the table for all satellites of the ephemeris store at the
+    // given epochs.
+    void SP3EpochStore::Prepare(SP3EphStore &ephStore,
+                                const std::vector<CommonTime> &epochTimes)
+        noexcept(false)
+    {
+        clear();
+
+        pEphStore = &ephStore;
+        epochs = epochTimes;
+        std::sort(epochs.begin(), epochs.end());
+        epochs.erase(std::unique(epochs.begin(), epochs.end()), epochs.end());
+
+        sats = ephStore.getSatList();
+        for (size_t j = 0; j < sats.size(); j++)
+            satIndex[sats[j]] = j;
+
+        const int nEpoch(epochs.size()), nSat(sats.size());
+        table.assign(size_t(nEpoch) * nSat * nValues, 0.0);
+        valid.assign(size_t(nEpoch) * nSat, 0);
+
+        // one sweep over the epochs for each satellite; the satellites are
+        // independent, and write to separate entries of the table
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int j = 0; j < nSat; j++)
+        {
+            std::vector<double> rec;
+            std::vector<char> ok;
+            ephStore.getXvtValues(sats[j], epochs, rec, ok);
+
+            for (int k = 0; k < nEpoch; k++)
+            {
+                if (!ok[k]) continue;
+                size_t ndx(size_t(k) * nSat + j);
+                std::copy(&rec[size_t(k) * nValues],
+                          &rec[size_t(k) * nValues] + nValues,
+                          &table[ndx * nValues]);
+                valid[ndx] = 1;
+            }
+        }
+
+        if (debug)
+            dump(cout, 1);
+    }
+
+    // Return the list of epochs of a RINEX observation file.
+    std::vector<CommonTime> SP3EpochStore::readObsEpochs(const std::string &obsFile)
+        noexcept(false)
+    {
+        std::fstream rxStream(obsFile.c_str(), ios::in);
+        if (!rxStream)
+        {
+            FileMissingException fe("Cannot open obs file: " + obsFile);
+            THROW(fe);
+        }
+
+        Rx3ObsHeader rxHeader;
+        Rx3ObsData rxData;
+
+        rxStream >> rxHeader;
+        rxData.pHeader = &rxHeader;
+
+        std::vector<CommonTime> epochTimes;
+        while (true)
+        {
+            try
+            {
+                rxStream >> rxData;
+            }
+            catch (EndOfFile &e)
+            {
+                break;
+            }
+            epochTimes.push_back(rxData.currEpoch);
+        }
+
+        return epochTimes;
+    }
+
+    // Find the index of the epoch nearest to ttag, -1 if none.
+    int SP3EpochStore::findEpoch(const CommonTime &ttag) throw()
+    {
+        if (epochs.empty()) return -1;
+
+        const int nEpoch(epochs.size());
+
+        // usually the same epoch as the last request, if it is still the
+        // nearest one: not farther than the next epoch on the side of ttag
+        // (ties go to the later epoch, as below)
+        if (lastIndex < nEpoch)
+        {
+            double dt(ttag - epochs[lastIndex]);
+            if (std::abs(dt) <= maxOffset)
+            {
+                if (dt >= 0.0)
+                {
+                    if (lastIndex + 1 == nEpoch ||
+                        dt < (epochs[lastIndex + 1] - ttag))
+                        return lastIndex;
+                }
+                else if (lastIndex == 0 ||
+                         (ttag - epochs[lastIndex - 1]) >= -dt)
+                    return lastIndex;
+            }
+        }
+
+        std::vector<CommonTime>::const_iterator it =
+            std::lower_bound(epochs.begin(), epochs.end(), ttag);
+
+        int k(it - epochs.begin());
+        if (it == epochs.end() ||
+            (k > 0 && (ttag - epochs[k - 1]) < (epochs[k] - ttag)))
+            k--;
+
+        if (std::abs(ttag - epochs[k]) > maxOffset) return -1;
+
+        lastIndex = k;
+        return k;
+    }
+
+    // Returns the position, velocity, and clock offset of the indicated
+    // object in ECEF coordinates (meters) at the indicated time.
+    Xvt SP3EpochStore::getXvt(const SatID &sat, const CommonTime &ttag)
+        noexcept(false)
+    {
+        if (pEphStore == NULL)
+        {
+            InvalidRequest e("SP3EpochStore: Prepare() has not been called.");
+            THROW(e);
+        }
+
+        std::map<SatID, int>::const_iterator satIt = satIndex.find(sat);
+        int k(findEpoch(ttag));
+
+        size_t ndx(0);
+        if (satIt != satIndex.end() && k >= 0)
+            ndx = size_t(k) * sats.size() + satIt->second;
+
+        // not in the table, ask the ephemeris itself
+        if (satIt == satIndex.end() || k < 0 || !valid[ndx])
+        {
+            try
+            { return pEphStore->getXvt(sat, ttag); }
+            catch (InvalidRequest &e)
+            {RETHROW(e); }
+        }
+
+        // second order expansion from the epoch of the table
+        const double *r(&table[ndx * nValues]);
+        double dt(ttag - epochs[k]);
+
+        Xvt retXvt;
+        for (int i = 0; i < 3; i++)
+        {
+            retXvt.x[i] = r[i] + (r[3 + i] + 0.5 * r[6 + i] * dt) * dt;
+            retXvt.v[i] = r[3 + i] + r[6 + i] * dt;
+        }
+        retXvt.clkbias = r[9] + r[10] * dt;
+        retXvt.clkdrift = r[10];
+
+        // compute relativity correction, in seconds
+        retXvt.computeRelativityCorrection();
+
+        return retXvt;
+    }
+
+    // Dump information about the store to an ostream.
+    void SP3EpochStore::dump(std::ostream &os, short detail) const throw()
+    {
+        os << "Dump SP3EpochStore:" << std::endl;
+        os << " " << epochs.size() << " epochs, " << sats.size()
+           << " satellites, max offset " << maxOffset << " s" << std::endl;
+        if (!epochs.empty())
+            os << " Time limits " << epochs.front() << " - "
+               << epochs.back() << std::endl;
+
+        if (detail > 0)
+        {
+            for (size_t j = 0; j < sats.size(); j++)
+            {
+                int n(0);
+                for (size_t k = 0; k < epochs.size(); k++)
+                    if (valid[k * sats.size() + j]) n++;
+                os << " " << sats[j] << " " << n << std::endl;
+            }
+        }
+
+        os << "End dump SP3EpochStore." << std::endl;
+    }
+
+    // Edit the dataset, removing epochs outside the indicated time interval
+    void SP3EpochStore::edit(const CommonTime &tmin, const CommonTime &tmax)
+        throw()
+    {
+        size_t k1 = std::lower_bound(epochs.begin(), epochs.end(), tmin)
+                    - epochs.begin();
+        size_t k2 = std::upper_bound(epochs.begin(), epochs.end(), tmax)
+                    - epochs.begin();
+        if (k2 < k1) k2 = k1;
+
+        const size_t nSat(sats.size());
+        epochs = std::vector<CommonTime>(epochs.begin() + k1,
+                                         epochs.begin() + k2);
+        table = std::vector<double>(table.begin() + k1 * nSat * nValues,
+                                    table.begin() + k2 * nSat * nValues);
+        valid = std::vector<char>(valid.begin() + k1 * nSat,
+                                  valid.begin() + k2 * nSat);
+        lastIndex = 0;
+    }
+
+    // Clear the dataset, meaning remove all data
+    void SP3EpochStore::clear(void) throw()
+    {
+        epochs.clear();
+        sats.clear();
+        satIndex.clear();
+        table.clear();
+        valid.clear();
+        lastIndex = 0;
+    }
+
+    // Determine the earliest time in the table.
+    CommonTime SP3EpochStore::getInitialTime() const noexcept(false)
+    {
+        if (epochs.empty())
+        {
+            InvalidRequest e("SP3EpochStore is empty");
+            THROW(e);
+        }
+        return epochs.front();
+    }
+
+    // Determine the latest time in the table.
+    CommonTime SP3EpochStore::getFinalTime() const noexcept(false)
+    {
+        if (epochs.empty())
+        {
+            InvalidRequest e("SP3EpochStore is empty");
+            THROW(e);
+        }
+        return epochs.back();
+    }
+
+}  // End of namespace gnssSpace
@@ -0,0 +1,188 @@
+/** @file SP3EpochStore.hpp
+ * Precompute the orbits and clocks of a SP3EphStore at the epochs of
+ * an observation file, and keep them in a compact per-epoch table.
+ * ComputeSatPos may use this store instead of the SP3EphStore, the
+ * light-time offset from the epoch is then bridged with a short
+ * Taylor expansion instead of a new interpolation of the SP3 tables. */
+
+#ifndef SP3EpochStore_INCLUDE
+#define SP3EpochStore_INCLUDE
+
+#include <map>
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "Exception.hpp"
+#include "SatID.hpp"
+#include "CommonTime.hpp"
+#include "XvtStore.hpp"
+#include "SP3EphStore.hpp"
+
+using namespace utilSpace;
+using namespace coordSpace;
+using namespace timeSpace;
+using namespace mathSpace;
+
+namespace gnssSpace
+{
+    /** Table of satellite position, velocity, acceleration, clock bias
+     * and clock drift at a list of epochs, computed in one sweep from a
+     * SP3EphStore (in parallel over the satellites if USE_OPENMP).
+     *
+     * getXvt(sat, t) looks up the epoch nearest to t and expands
+     * position and clock to t; for the offsets of the transmit time
+     * (< 0.2 s) this agrees with SP3EphStore::getXvt() to well below a
+     * millimeter. Times farther than maxOffset from any epoch, or
+     * values missing in the table, are taken from the SP3EphStore,
+     * which therefore must not be destroyed before this store.
+     *
+     * The store keeps the epoch of the last request, where the search of
+     * the next one starts: getXvt() changes it, and a store must not be
+     * shared by threads, e.g. by the stations of a StationBatch. Build
+     * one per station, from the SP3EphStore they share.
+     *
+     * A typical use is
+     * @code
+     *    SP3EphStore sp3Store;
+     *    sp3Store.loadSP3Files(sp3Files);
+     *
+     *    SP3EpochStore epochStore;
+     *    epochStore.Prepare(sp3Store, SP3EpochStore::readObsEpochs(obsFile));
+     *
+     *    ComputeSatPos computeSatPos(epochStore);
+     * @endcode */
+    class SP3EpochStore : public XvtStore<SatID>
+    {
+    public:
+
+         /// Default constructor
+        SP3EpochStore() throw()
+            : pEphStore(NULL), maxOffset(1.0), lastIndex(0)
+        { }
+
+         /// Destructor
+        virtual ~SP3EpochStore()
+        { }
+
+         /** Compute the table for all satellites of the ephemeris store at
+          * the given epochs.
+          * @param[in] ephStore the precise ephemeris, used also for the
+          *    requests not covered by the table
+          * @param[in] epochTimes the epochs, e.g. from readObsEpochs() */
+        void Prepare(SP3EphStore& ephStore,
+                     const std::vector<CommonTime>& epochTimes)
+            noexcept(false);
+
+         /** Return the list of epochs of a RINEX observation file.
+          * @throw FileMissingException if the file can not be opened */
+        static std::vector<CommonTime> readObsEpochs(const std::string& obsFile)
+            noexcept(false);
+
+         /// Set the largest offset (seconds) from an epoch of the table
+         /// for which the table is used, default 1 s.
+        void setMaxOffset(const double& offset) throw()
+        { maxOffset = offset; }
+
+         /// Get the largest offset (seconds) from an epoch of the table.
+        double getMaxOffset(void) const throw()
+        { return maxOffset; }
+
+         /// Return the epochs of the table
+        const std::vector<CommonTime>& getEpochs(void) const throw()
+        { return epochs; }
+
+         /// Return the satellites of the table
+        const std::vector<SatID>& getSatList(void) const throw()
+        { return sats; }
+
+         // XvtStore interface:
+         /** Returns the position, velocity, and clock offset of the
+          * indicated object in ECEF coordinates (meters) at the
+          * indicated time.
+          * @param[in] sat the satellite of interest
+          * @param[in] ttag the time to look up
+          * @return the Xvt of the object at the indicated time
+          * @throw InvalidRequest If the request can not be completed for any
+          *    reason, this is thrown. The text may have additional
+          *    information as to why the request failed. */
+        virtual Xvt getXvt(const SatID& sat, const CommonTime& ttag)
+            noexcept(false);
+
+         /** Dump information about the store to an ostream.
+          * @param[in] os ostream to receive the output; defaults to std::cout
+          * @param[in] detail integer level of detail to provide;
+          *    0: number of epochs and satellites, time limits
+          *    1: above plus the number of valid entries per satellite */
+        virtual void dump(std::ostream& os = std::cout, short detail = 0)
+            const throw();
+
+         /** Edit the dataset, removing epochs outside the indicated
+          * time interval
+          * @param[in] tmin defines the beginning of the time interval
+          * @param[in] tmax defines the end of the time interval */
+        virtual void edit(const CommonTime& tmin,
+                          const CommonTime& tmax = CommonTime::END_OF_TIME)
+            throw();
+
+         /// Clear the dataset, meaning remove all data
+        virtual void clear(void) throw();
+
+         /// Return time system of the table
+        virtual TimeSystem getTimeSystem(void) const throw()
+        { return (pEphStore ? pEphStore->getTimeSystem() : TimeSystem::Any); }
+
+         /** Determine the earliest time in the table.
+          * @throw InvalidRequest if the object has no data. */
+        virtual CommonTime getInitialTime() const noexcept(false);
+
+         /** Determine the latest time in the table.
+          * @throw InvalidRequest if the object has no data. */
+        virtual CommonTime getFinalTime() const noexcept(false);
+
+         /// Return true if the satellite is present in the table
+        virtual bool isPresent(const SatID& sat) const throw()
+        { return (satIndex.find(sat) != satIndex.end()); }
+
+         /// Return true if velocity is present in the table; it always is
+        virtual bool hasVelocity() const throw()
+        { return true; }
+
+    private:
+
+         /// Number of values per (epoch,satellite): position, velocity,
+         /// acceleration, clock bias and clock drift
+        static const int nValues = 11;
+
+         /// Find the index of the epoch nearest to ttag, -1 if none.
+        int findEpoch(const CommonTime& ttag) throw();
+
+         /// Ephemeris the table was computed from
+        SP3EphStore* pEphStore;
+
+         /// Largest offset (seconds) from an epoch for which the table is used
+        double maxOffset;
+
+         /// Epoch index of the last request, the next one is usually
+         /// at the same epoch
+        int lastIndex;
+
+         /// Epochs of the table, in increasing order
+        std::vector<CommonTime> epochs;
+
+         /// Satellites of the table, and their column in the table
+        std::vector<SatID> sats;
+        std::map<SatID, int> satIndex;
+
+         /// The table, row (epoch) major: nValues values for each
+         /// (epoch,satellite) at (epoch*sats.size()+sat)*nValues
+        std::vector<double> table;
+
+         /// 1 if the entry of (epoch,satellite) is valid
+        std::vector<char> valid;
+
+    }; // End of class 'SP3EpochStore'
+
+}  // End of namespace gnssSpace
+
+#endif // SP3EpochStore_INCLUDE
@@ -0,0 +1,136 @@
+/**
+ * @file SatGeometry.cpp
+ * Receiver-satellite geometry of all the satellites of an epoch: ranges,
+ * line-of-sight partials, elevations and azimuths, over arrays of
+ * coordinates.
+ */
+
+#include <cmath>
+
+#include "SatGeometry.hpp"
+#include "constants.hpp"
+
+using namespace std;
+
+namespace gnssSpace
+{
+
+      // Default constructor, receiver at the center of the Earth
+    SatGeometry::SatGeometry()
+        : frameOk(false)
+    {
+        rx[0] = rx[1] = rx[2] = 0.0;
+        up[0] = up[1] = up[2] = 0.0;
+        north[0] = north[1] = north[2] = 0.0;
+        east[0] = east[1] = 0.0;
+    }
+
+
+      // Set the receiver position, and compute its local frame
+    SatGeometry& SatGeometry::setReceiver(const Position& rxPos)
+    {
+        rx[0] = rxPos.X();
+        rx[1] = rxPos.Y();
+        rx[2] = rxPos.Z();
+
+        // geocentric frame, as Triple::azAngle()
+        double xy( rx[0]*rx[0] + rx[1]*rx[1] );
+        double xyz( xy + rx[2]*rx[2] );
+        xy = ::sqrt(xy);
+        xyz = ::sqrt(xyz);
+
+        frameOk = ( xy > 1e-14 && xyz > 1e-14 );
+        if(!frameOk)
+        {
+            return (*this);
+        }
+
+        double cosl( rx[0]/xy );
+        double sinl( rx[1]/xy );
+        double sint( rx[2]/xyz );
+
+        north[0] = -sint*cosl;
+        north[1] = -sint*sinl;
+        north[2] = xy/xyz;
+
+        east[0] = -sinl;
+        east[1] = cosl;
+
+        // up over the ellipsoid, as Position::elevationGeodetic()
+        double latGeodetic( rxPos.getGeodeticLatitude()*DEG_TO_RAD );
+        double longGeodetic( rxPos.getLongitude()*DEG_TO_RAD );
+
+        up[0] = ::cos(latGeodetic)*::cos(longGeodetic);
+        up[1] = ::cos(latGeodetic)*::sin(longGeodetic);
+        up[2] = ::sin(latGeodetic);
+
+        return (*this);
+
+    }  // End of method 'SatGeometry::setReceiver()'
+
+
+      // Geometry of n satellites
+    void SatGeometry::compute( int n,
+                               const double* x, const double* y, const double* z,
+                               double* rho,
+                               double* dx, double* dy, double* dz,
+                               double* elev, double* azim,
+                               char* valid )
+    {
+        if( cosUp.size() < size_t(n) )
+        {
+            cosUp.resize(n);
+            localN.resize(n);
+            localE.resize(n);
+        }
+
+        double* pCosUp( cosUp.empty() ? NULL : &cosUp[0] );
+        double* pN( localN.empty() ? NULL : &localN[0] );
+        double* pE( localE.empty() ? NULL : &localE[0] );
+
+        const double rx0(rx[0]), rx1(rx[1]), rx2(rx[2]);
+        const double up0(up[0]), up1(up[1]), up2(up[2]);
+        const double n0(north[0]), n1(north[1]), n2(north[2]);
+        const double e0(east[0]), e1(east[1]);
+        const char ok( frameOk ? 1 : 0 );
+
+        // ranges, partials and the local components of the line of
+        // sight: no branch and no call, to be vectorized
+        for(int i=0; i<n; i++)
+        {
+            double sx( x[i] - rx0 );
+            double sy( y[i] - rx1 );
+            double sz( z[i] - rx2 );
+
+            double r( ::sqrt(sx*sx + sy*sy + sz*sz) );
+            rho[i] = r;
+
+            dx[i] = (rx0 - x[i]) / r;
+            dy[i] = (rx1 - y[i]) / r;
+            dz[i] = (rx2 - z[i]) / r;
+
+            pCosUp[i] = (sx*up0 + sy*up1 + sz*up2) / r;
+
+            double p1( n0*sx + n1*sy + n2*sz );
+            double p2( e0*sx + e1*sy );
+            pN[i] = p1;
+            pE[i] = p2;
+
+            // Position::elevationGeodetic() and Triple::azAngle() throw
+            // in these cases
+            valid[i] = ok & char(r > 1e-4) &
+                       char( (::fabs(p1) + ::fabs(p2)) >= 1.0e-16 );
+        }
+
+        // angles
+        for(int i=0; i<n; i++)
+        {
+            elev[i] = 90.0 - ::acos(pCosUp[i])*RAD_TO_DEG;
+
+            double alpha( 90.0 - ::atan2(pN[i], pE[i])*RAD_TO_DEG );
+            azim[i] = (alpha < 0.0) ? alpha + 360.0 : alpha;
+        }
+
+    }  // End of method 'SatGeometry::compute()'
+
+}  // End of namespace gnssSpace
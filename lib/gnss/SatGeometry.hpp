@@ -0,0 +1,101 @@
+/**
+ * @file SatGeometry.hpp
+ * Receiver-satellite geometry of all the satellites of an epoch: ranges,
+ * line-of-sight partials, elevations and azimuths, over arrays of
+ * coordinates.
+ */
+
+#ifndef SatGeometry_HPP
+#define SatGeometry_HPP
+
+#include <vector>
+
+#include "Position.hpp"
+
+using namespace coordSpace;
+
+namespace gnssSpace
+{
+
+      /** Geometry between a receiver and a set of satellites, given as
+       *  structure-of-arrays (x[], y[], z[]).
+       *
+       *  Position::elevationGeodetic() and Position::azimuth() work out
+       *  the geodetic latitude and the local frame of the receiver again
+       *  for each satellite, and build several Position and Triple
+       *  objects on the way. Here the frame of the receiver is computed
+       *  once in setReceiver(), and compute() goes over the satellites in
+       *  plain loops over contiguous arrays, without any allocation, that
+       *  the compiler can vectorize.
+       *
+       *  The results are those of the Position methods: the elevation is
+       *  taken over the ellipsoid (as elevationGeodetic()), and the
+       *  azimuth in the geocentric frame (as azimuth()). A satellite is
+       *  not valid where these methods would throw: within 0.1 mm of the
+       *  receiver, or with a receiver at the center or on the axis of the
+       *  Earth.
+       *
+       *  @code
+       *    SatGeometry geometry;
+       *    geometry.setReceiver(nominalPos);
+       *    geometry.compute(n, x, y, z, rho, dx, dy, dz, elev, azim, valid);
+       *  @endcode
+       */
+    class SatGeometry
+    {
+    public:
+
+         /// Default constructor, receiver at the center of the Earth
+        SatGeometry();
+
+         /// Set the receiver position, and compute its local frame
+        SatGeometry& setReceiver(const Position& rxPos);
+
+         /// Receiver coordinates (ECEF, meters)
+        double rxX() const { return rx[0]; };
+        double rxY() const { return rx[1]; };
+        double rxZ() const { return rx[2]; };
+
+         /** Geometry of n satellites.
+          *
+          * @param n       Number of satellites.
+          * @param x,y,z   Satellite positions (ECEF, meters).
+          * @param rho     Geometric ranges (meters).
+          * @param dx,dy,dz Partials of the range to the receiver position.
+          * @param elev    Geodetic elevations (degrees).
+          * @param azim    Azimuths (degrees, 0 to 360).
+          * @param valid   1 where the geometry could be computed, else 0.
+          */
+        void compute( int n,
+                      const double* x, const double* y, const double* z,
+                      double* rho,
+                      double* dx, double* dy, double* dz,
+                      double* elev, double* azim,
+                      char* valid );
+
+    private:
+
+         /// receiver coordinates
+        double rx[3];
+
+         /// up vector over the ellipsoid, for the elevation
+        double up[3];
+
+         /// north and east vectors of the geocentric frame, for the azimuth
+        double north[3];
+        double east[2];
+
+         /// false if the receiver is at the center or on the axis
+        bool frameOk;
+
+         /// cosine of the zenith angle, and local north and east, of each
+         /// satellite, kept from one epoch to the next
+        std::vector<double> cosUp;
+        std::vector<double> localN;
+        std::vector<double> localE;
+
+    }; // End of class 'SatGeometry'
+
+}  // End of namespace gnssSpace
+
+#endif   // SatGeometry_HPP
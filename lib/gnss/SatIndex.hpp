@@ -0,0 +1,238 @@
+/**
+ * @file SatIndex.hpp
+ * Dense index of the satellites (system x PRN -> 0..count-1), and
+ * containers of per-satellite state built on it.
+ */
+
+#ifndef SatIndex_HPP
+#define SatIndex_HPP
+
+#include <vector>
+#include <map>
+
+#include "SatID.hpp"
+#include "TypeID.hpp"
+
+namespace gnssSpace
+{
+
+      /** Dense index of the satellites: each system has maxPRN slots, so
+       *  the index of a satellite is system*maxPRN + PRN-1, found without
+       *  any search.
+       */
+    struct SatIndex
+    {
+         /// Slots per system
+        static const int maxPRN = 64;
+
+         /// Number of indexes
+        static const int count = SatelliteSystem::count * maxPRN;
+
+         /// Index of a satellite, -1 if its PRN is out of range
+        static int of(const SatID& sat)
+        {
+            return (sat.id >= 1 && sat.id <= maxPRN) ?
+                   int(sat.system)*maxPRN + sat.id - 1 : -1;
+        }
+
+         /// Satellite of an index
+        static SatID satOf(int index)
+        {
+            return SatID( index%maxPRN + 1,
+                          static_cast<SatelliteSystem::Systems>(index/maxPRN) );
+        }
+
+    };  // End of struct 'SatIndex'
+
+
+      /** State of each satellite, stored in an array indexed by SatIndex.
+       *  operator[] works as for std::map<SatID, T>: the state is default
+       *  constructed the first time a satellite is used. Satellites with a
+       *  PRN out of the range of SatIndex go to a std::map.
+       */
+    template <class T>
+    class SatStateArray
+    {
+    public:
+
+         /// State of a satellite, added if not present
+        T& operator[](const SatID& sat)
+        {
+            int i( SatIndex::of(sat) );
+            if(i < 0) return others[sat];
+
+            if(slots.empty())
+            {
+                slots.resize(SatIndex::count);
+                used.assign(SatIndex::count, 0);
+            }
+
+            used[i] = 1;
+            return slots[i];
+        }
+
+         /// true if the satellite has a state
+        bool has(const SatID& sat) const
+        {
+            int i( SatIndex::of(sat) );
+            if(i < 0) return others.find(sat) != others.end();
+
+            return !used.empty() && used[i];
+        }
+
+         /// Remove the state of a satellite
+        void erase(const SatID& sat)
+        {
+            int i( SatIndex::of(sat) );
+            if(i < 0)
+            {
+                others.erase(sat);
+            }
+            else if(!used.empty() && used[i])
+            {
+                slots[i] = T();
+                used[i] = 0;
+            }
+        }
+
+         /// Remove all states
+        void clear()
+        {
+            slots.clear();
+            used.clear();
+            others.clear();
+        }
+
+         /// Satellites with a state, in the order of their index
+        std::vector<SatID> getSats() const
+        {
+            std::vector<SatID> sats;
+            for(size_t i=0; i<used.size(); i++)
+            {
+                if(used[i]) sats.push_back( SatIndex::satOf(i) );
+            }
+
+            for(typename std::map<SatID, T>::const_iterator it = others.begin();
+                it != others.end();
+                ++it)
+            {
+                sats.push_back( (*it).first );
+            }
+
+            return sats;
+        }
+
+         /// State of a satellite, which must have one (see has())
+        const T& at(const SatID& sat) const
+        {
+            int i( SatIndex::of(sat) );
+            if(i < 0) return others.find(sat)->second;
+
+            return slots[i];
+        }
+
+    private:
+
+        std::vector<T> slots;
+        std::vector<char> used;
+
+         /// satellites out of the range of SatIndex
+        std::map<SatID, T> others;
+
+    };  // End of class 'SatStateArray'
+
+
+      /** State of each satellite and type, stored in one SatStateArray per
+       *  type. The column of a type is found with the TypeID value, so
+       *  that operator() needs no search.
+       */
+    template <class T>
+    class SatTypeStateArray
+    {
+    public:
+
+        SatTypeStateArray()
+            : colOfType(TypeID::count, -1)
+        {}
+
+         /// State of a satellite and type, added if not present
+        T& operator()(const SatID& sat, const TypeID& type)
+        {
+            int& col( colOfType[type.type] );
+            if(col < 0)
+            {
+                col = columns.size();
+                columns.push_back( SatStateArray<T>() );
+            }
+
+            satUsed[sat] = 1;
+            return columns[col][sat];
+        }
+
+         /// true if the satellite has a state for this type
+        bool has(const SatID& sat, const TypeID& type) const
+        {
+            int col( colOfType[type.type] );
+            return col >= 0 && columns[col].has(sat);
+        }
+
+         /// true if the satellite has a state for any type
+        bool hasSat(const SatID& sat) const
+        { return satUsed.has(sat); }
+
+         /// Remove the states of a satellite
+        void eraseSat(const SatID& sat)
+        {
+            for(size_t c=0; c<columns.size(); c++) columns[c].erase(sat);
+            satUsed.erase(sat);
+        }
+
+         /// Remove all states
+        void clear()
+        {
+            columns.clear();
+            satUsed.clear();
+            colOfType.assign(TypeID::count, -1);
+        }
+
+         /// Types with a state for any satellite, in the order of TypeID
+        std::vector<TypeID> getTypes() const
+        {
+            std::vector<TypeID> types;
+            for(size_t t=0; t<colOfType.size(); t++)
+            {
+                if(colOfType[t] >= 0)
+                {
+                    types.push_back( TypeID(static_cast<TypeID::ValueType>(t)) );
+                }
+            }
+
+            return types;
+        }
+
+         /// Satellites with a state for a type
+        std::vector<SatID> getSats(const TypeID& type) const
+        {
+            int col( colOfType[type.type] );
+            return (col >= 0) ? columns[col].getSats() : std::vector<SatID>();
+        }
+
+         /// State of a satellite and type, which must have one (see has())
+        const T& at(const SatID& sat, const TypeID& type) const
+        { return columns[colOfType[type.type]].at(sat); }
+
+    private:
+
+         /// column of each TypeID value, -1 if not used
+        std::vector<int> colOfType;
+
+        std::vector< SatStateArray<T> > columns;
+
+         /// satellites with a state for any type
+        SatStateArray<char> satUsed;
+
+    };  // End of class 'SatTypeStateArray'
+
+}  // End of namespace gnssSpace
+
+#endif   // SatIndex_HPP
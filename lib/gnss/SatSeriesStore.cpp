@@ -0,0 +1,695 @@
+/**
+ * @file SatSeriesStore.cpp
+ * Columnar store of the time series of some TypeIDs of each satellite.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <fstream>
+#include <stdint.h>
+
+#include "SatSeriesStore.hpp"
+
+using namespace std;
+
+namespace gnssSpace
+{
+
+    const size_t SatSeriesStore::chunkSize;
+
+
+    namespace
+    {
+        const char seriesMagic[8] = { 'G','B','X','S','E','R','I','E' };
+        const uint32_t seriesVersion = 1;
+        const uint32_t byteOrderMark = 0x01020304;
+
+          // largest quantized value kept; beyond, llround() is undefined,
+          // and the differences of two values could overflow
+        const double maxQuantized = 1.e18;
+
+          // append an integer, 7 bits per byte
+        inline void putVarint(std::vector<unsigned char>& bytes, uint64_t v)
+        {
+            while(v >= 0x80)
+            {
+                bytes.push_back( (unsigned char)(v | 0x80) );
+                v >>= 7;
+            }
+            bytes.push_back( (unsigned char)v );
+        }
+
+        inline uint64_t getVarint(const unsigned char*& p)
+        {
+            uint64_t v(0);
+            int shift(0);
+            while(*p & 0x80)
+            {
+                v |= uint64_t(*p++ & 0x7f) << shift;
+                shift += 7;
+            }
+            v |= uint64_t(*p++) << shift;
+            return v;
+        }
+
+          // signed to unsigned, small magnitudes to small numbers
+        inline uint64_t zigzag(long long v)
+        { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+
+        inline long long unzigzag(uint64_t v)
+        { return (long long)(v >> 1) ^ -(long long)(v & 1); }
+
+        template <class T>
+        void put(std::ofstream& strm, const T& value)
+        { strm.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+        template <class T>
+        T get(std::ifstream& strm)
+            noexcept(false)
+        {
+            T value;
+            if( !strm.read(reinterpret_cast<char*>(&value), sizeof(T)) )
+            {
+                FFStreamError e("SatSeriesStore: truncated file");
+                THROW(e);
+            }
+            return value;
+        }
+
+        void putColumn( std::ofstream& strm,
+                        const std::vector<unsigned char>& bytes,
+                        const std::vector<size_t>& chunkStart )
+        {
+            put(strm, uint32_t(chunkStart.size()));
+            for(size_t i=0; i<chunkStart.size(); i++)
+            {
+                put(strm, uint64_t(chunkStart[i]));
+            }
+            put(strm, uint64_t(bytes.size()));
+            strm.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+
+          // skip n integers of [p, end), false if they don't fit in it
+        inline bool skipVarints( const unsigned char* p,
+                                 const unsigned char* end,
+                                 size_t n )
+        {
+            for(size_t i=0; i<n; i++)
+            {
+                int len(0);
+                do
+                {
+                    if(p == end || ++len > 10) return false;
+                } while(*p++ & 0x80);
+            }
+            return true;
+        }
+
+          // Check that a column read from a file can be decoded: one chunk
+          // per chunkSize rows, in order, each one with its rows of
+          // integers before the next chunk
+        void checkColumn( const std::vector<unsigned char>& bytes,
+                          const std::vector<size_t>& chunkStart,
+                          size_t rows,
+                          size_t chunkSize )
+            noexcept(false)
+        {
+            size_t numChunks( rows/chunkSize + (rows%chunkSize ? 1 : 0) );
+            if(chunkStart.size() != numChunks)
+            {
+                FFStreamError e("SatSeriesStore: chunk table doesn't match "
+                                "the number of rows");
+                THROW(e);
+            }
+
+            for(size_t c=0; c<numChunks; c++)
+            {
+                size_t end( (c+1 < numChunks) ? chunkStart[c+1]
+                                              : bytes.size() );
+                size_t n( std::min(chunkSize, rows - c*chunkSize) );
+                if( chunkStart[c] >= bytes.size() ||
+                    end > bytes.size() ||
+                    chunkStart[c] >= end ||
+                    !skipVarints( &bytes[0] + chunkStart[c],
+                                  &bytes[0] + end, n ) )
+                {
+                    FFStreamError e("SatSeriesStore: corrupt chunk");
+                    THROW(e);
+                }
+            }
+        }
+
+        void getColumn( std::ifstream& strm,
+                        std::vector<unsigned char>& bytes,
+                        std::vector<size_t>& chunkStart )
+            noexcept(false)
+        {
+            chunkStart.resize( get<uint32_t>(strm) );
+            for(size_t i=0; i<chunkStart.size(); i++)
+            {
+                chunkStart[i] = get<uint64_t>(strm);
+            }
+            bytes.resize( get<uint64_t>(strm) );
+            if( !bytes.empty() &&
+                !strm.read(reinterpret_cast<char*>(bytes.data()), bytes.size()) )
+            {
+                FFStreamError e("SatSeriesStore: truncated file");
+                THROW(e);
+            }
+        }
+    }
+
+
+      // Add a column
+    SatSeriesStore& SatSeriesStore::addColumn( const TypeID& type,
+                                               double resolution )
+        noexcept(false)
+    {
+        if(!seriesData.empty())
+        {
+            InvalidRequest e("SatSeriesStore: columns must be added "
+                             "before the data");
+            THROW(e);
+        }
+
+        for(size_t i=0; i<types.size(); i++)
+        {
+            if(types[i] == type)
+            {
+                resolutions[i] = resolution;
+                return (*this);
+            }
+        }
+
+        types.push_back(type);
+        resolutions.push_back(resolution);
+
+        return (*this);
+
+    }  // End of method 'SatSeriesStore::addColumn()'
+
+
+      // Append a row to each satellite of an epoch
+    void SatSeriesStore::append( const CommonTime& epoch,
+                                 const satTypeValueMap& stvData )
+        noexcept(false)
+    {
+        double dt( (refEpochSet ? (epoch - refEpoch) : 0.0)/timeRes );
+        if( !(std::abs(dt) < maxQuantized) )
+        {
+            InvalidRequest e("SatSeriesStore: epoch too far from the first "
+                             "one for the time resolution");
+            THROW(e);
+        }
+
+        if(!refEpochSet)
+        {
+            refEpoch = epoch;
+            refEpochSet = true;
+        }
+
+        long long t( std::llround(dt) );
+
+        for(satTypeValueMap::const_iterator it = stvData.begin();
+            it != stvData.end();
+            ++it)
+        {
+            Series& series( seriesData[(*it).first] );
+            if(series.values.size() != types.size())
+            {
+                series.values.resize(types.size());
+            }
+
+            // a new chunk: the differences start again from 0
+            bool newChunk( series.rows % chunkSize == 0 );
+
+            Column& time( series.time );
+            if(newChunk)
+            {
+                time.chunkStart.push_back(time.bytes.size());
+                time.last = 0;
+                series.lastStep = 0;
+            }
+
+            long long step( t - time.last );
+            putVarint(time.bytes, zigzag(step - series.lastStep));
+            series.lastStep = step;
+            time.last = t;
+
+            for(size_t col=0; col<types.size(); col++)
+            {
+                Column& column( series.values[col] );
+                if(newChunk)
+                {
+                    column.chunkStart.push_back(column.bytes.size());
+                    column.last = 0;
+                }
+
+                // 0 for a missing value; values which are not finite, or
+                // too large for the resolution, are missing too
+                const double* pValue( (*it).second.tryGet(types[col]) );
+                double value( (pValue == NULL) ? 0.0
+                                               : (*pValue)/resolutions[col] );
+                if( pValue == NULL || !(std::abs(value) < maxQuantized) )
+                {
+                    column.bytes.push_back(0);
+                    continue;
+                }
+
+                long long q( std::llround(value) );
+                putVarint(column.bytes, zigzag(q - column.last) + 1);
+                column.last = q;
+            }
+
+            series.rows++;
+        }
+
+    }  // End of method 'SatSeriesStore::append()'
+
+
+      // Remove the data, keeping the columns
+    void SatSeriesStore::clear()
+    {
+        seriesData.clear();
+        refEpochSet = false;
+    }
+
+
+      // Satellites with data
+    SatIDSet SatSeriesStore::getSatIDSet() const
+    {
+        SatIDSet satSet;
+        for(std::map<SatID, Series>::const_iterator it = seriesData.begin();
+            it != seriesData.end();
+            ++it)
+        {
+            satSet.insert((*it).first);
+        }
+        return satSet;
+    }
+
+
+      // Number of rows of a satellite
+    size_t SatSeriesStore::numRows(const SatID& sat) const
+    {
+        std::map<SatID, Series>::const_iterator it( seriesData.find(sat) );
+        return (it == seriesData.end()) ? 0 : (*it).second.rows;
+    }
+
+
+      // Index of the column of a type
+    size_t SatSeriesStore::columnOf(const TypeID& type) const
+        noexcept(false)
+    {
+        for(size_t i=0; i<types.size(); i++)
+        {
+            if(types[i] == type) return i;
+        }
+
+        TypeIDNotFound e("SatSeriesStore: no column for " + type.asString());
+        THROW(e);
+    }
+
+
+      // Decode the times of a chunk, in seconds from refEpoch
+    size_t SatSeriesStore::decodeTimes( const Series& series,
+                                        size_t chunk,
+                                        double* times ) const
+    {
+        size_t n( std::min(chunkSize, series.rows - chunk*chunkSize) );
+        const unsigned char* p( &series.time.bytes[0]
+                                + series.time.chunkStart[chunk] );
+
+        long long t(0), step(0);
+        for(size_t i=0; i<n; i++)
+        {
+            step += unzigzag(getVarint(p));
+            t += step;
+            times[i] = t*timeRes;
+        }
+
+        return n;
+
+    }  // End of method 'SatSeriesStore::decodeTimes()'
+
+
+      // Decode the values of a chunk of a column, NaN where missing
+    size_t SatSeriesStore::decodeValues( const Series& series,
+                                         size_t col,
+                                         size_t chunk,
+                                         double* values ) const
+    {
+        const Column& column( series.values[col] );
+        double res( resolutions[col] );
+
+        size_t n( std::min(chunkSize, series.rows - chunk*chunkSize) );
+        const unsigned char* p( &column.bytes[0] + column.chunkStart[chunk] );
+
+        long long q(0);
+        for(size_t i=0; i<n; i++)
+        {
+            uint64_t v( getVarint(p) );
+            if(v == 0)
+            {
+                values[i] = std::numeric_limits<double>::quiet_NaN();
+                continue;
+            }
+            q += unzigzag(v - 1);
+            values[i] = q*res;
+        }
+
+        return n;
+
+    }  // End of method 'SatSeriesStore::decodeValues()'
+
+
+      // Series of a column for a satellite
+    void SatSeriesStore::getSeries( const SatID& sat,
+                                    const TypeID& type,
+                                    std::vector<double>& times,
+                                    std::vector<double>& values ) const
+        noexcept(false)
+    {
+        size_t col( columnOf(type) );
+
+        times.clear();
+        values.clear();
+
+        std::map<SatID, Series>::const_iterator it( seriesData.find(sat) );
+        if(it == seriesData.end()) return;
+
+        const Series& series( (*it).second );
+        times.resize(series.rows);
+        values.resize(series.rows);
+
+        for(size_t c=0; c<series.time.chunkStart.size(); c++)
+        {
+            decodeTimes(series, c, &times[c*chunkSize]);
+            decodeValues(series, col, c, &values[c*chunkSize]);
+        }
+
+    }  // End of method 'SatSeriesStore::getSeries()'
+
+
+      // RMS of the values of a column for a satellite
+    double SatSeriesStore::rms( const SatID& sat,
+                                const TypeID& type,
+                                size_t& count ) const
+        noexcept(false)
+    {
+        size_t col( columnOf(type) );
+
+        count = 0;
+
+        std::map<SatID, Series>::const_iterator it( seriesData.find(sat) );
+        if(it == seriesData.end()) return 0.0;
+
+        const Series& series( (*it).second );
+
+        double values[chunkSize];
+        double sum2(0.0);
+        for(size_t c=0; c<series.time.chunkStart.size(); c++)
+        {
+            size_t n( decodeValues(series, col, c, values) );
+            for(size_t i=0; i<n; i++)
+            {
+                if(values[i] != values[i]) continue;
+                sum2 += values[i]*values[i];
+                count++;
+            }
+        }
+
+        return (count > 0) ? std::sqrt(sum2/count) : 0.0;
+
+    }  // End of method 'SatSeriesStore::rms()'
+
+
+      // Statistics of a column in bins of the values of another one
+    std::vector<SatSeriesStore::BinStats>
+    SatSeriesStore::binned( const TypeID& type,
+                            const TypeID& binType,
+                            double binMin,
+                            double binWidth,
+                            int numBins ) const
+        noexcept(false)
+    {
+        size_t col( columnOf(type) );
+        size_t binCol( columnOf(binType) );
+
+        std::vector<double> sum(numBins, 0.0), sum2(numBins, 0.0);
+        std::vector<BinStats> stats(numBins);
+
+        double values[chunkSize], binValues[chunkSize];
+        for(std::map<SatID, Series>::const_iterator it = seriesData.begin();
+            it != seriesData.end();
+            ++it)
+        {
+            const Series& series( (*it).second );
+            for(size_t c=0; c<series.time.chunkStart.size(); c++)
+            {
+                size_t n( decodeValues(series, col, c, values) );
+                decodeValues(series, binCol, c, binValues);
+
+                for(size_t i=0; i<n; i++)
+                {
+                    double b( std::floor((binValues[i] - binMin)/binWidth) );
+                    if( !(b >= 0.0 && b < numBins) ) continue;
+                    if(values[i] != values[i]) continue;
+
+                    int k( static_cast<int>(b) );
+                    sum[k] += values[i];
+                    sum2[k] += values[i]*values[i];
+                    stats[k].count++;
+                }
+            }
+        }
+
+        for(int k=0; k<numBins; k++)
+        {
+            if(stats[k].count == 0) continue;
+            stats[k].mean = sum[k]/stats[k].count;
+            stats[k].rms = std::sqrt(sum2[k]/stats[k].count);
+        }
+
+        return stats;
+
+    }  // End of method 'SatSeriesStore::binned()'
+
+
+      // Bytes taken by the columns
+    size_t SatSeriesStore::memoryUsed() const
+    {
+        size_t size(0);
+        for(std::map<SatID, Series>::const_iterator it = seriesData.begin();
+            it != seriesData.end();
+            ++it)
+        {
+            const Series& series( (*it).second );
+            size += sizeof(Series)
+                  + series.time.bytes.capacity()
+                  + series.time.chunkStart.capacity()*sizeof(size_t);
+            for(size_t col=0; col<series.values.size(); col++)
+            {
+                size += sizeof(Column)
+                      + series.values[col].bytes.capacity()
+                      + series.values[col].chunkStart.capacity()*sizeof(size_t);
+            }
+        }
+        return size;
+
+    }  // End of method 'SatSeriesStore::memoryUsed()'
+
+
+      // Write the store to a binary columnar file
+    void SatSeriesStore::writeFile(const std::string& fileName) const
+        noexcept(false)
+    {
+        std::ofstream strm(fileName.c_str(), ios::out | ios::binary);
+        if(!strm)
+        {
+            FileMissingException e("SatSeriesStore: can't create " + fileName);
+            THROW(e);
+        }
+
+        // header
+        strm.write(seriesMagic, sizeof(seriesMagic));
+        put(strm, seriesVersion);
+        put(strm, byteOrderMark);
+
+        long day, msod;
+        double fsod;
+        TimeSystem timeSys;
+        refEpoch.getInternal(day, msod, fsod, timeSys);
+        put(strm, int32_t(day));
+        put(strm, int32_t(msod));
+        put(strm, fsod);
+        put(strm, int32_t(timeSys.getTimeSystem()));
+        put(strm, timeRes);
+        put(strm, uint32_t(chunkSize));
+
+        // columns, with the TypeIDs by name
+        put(strm, uint16_t(types.size()));
+        for(size_t col=0; col<types.size(); col++)
+        {
+            string name( types[col].asString() );
+            put(strm, resolutions[col]);
+            put(strm, uint16_t(name.size()));
+            strm.write(name.data(), name.size());
+        }
+
+        // satellites
+        put(strm, uint16_t(seriesData.size()));
+        for(std::map<SatID, Series>::const_iterator it = seriesData.begin();
+            it != seriesData.end();
+            ++it)
+        {
+            const Series& series( (*it).second );
+            put(strm, (*it).first.systemChar());
+            put(strm, int16_t((*it).first.id));
+            put(strm, uint64_t(series.rows));
+
+            putColumn(strm, series.time.bytes, series.time.chunkStart);
+            for(size_t col=0; col<types.size(); col++)
+            {
+                putColumn( strm, series.values[col].bytes,
+                           series.values[col].chunkStart );
+            }
+        }
+
+        if(!strm)
+        {
+            FFStreamError e("SatSeriesStore: error writing " + fileName);
+            THROW(e);
+        }
+
+    }  // End of method 'SatSeriesStore::writeFile()'
+
+
+      // Read a file written by writeFile(), replacing the store
+    void SatSeriesStore::loadFile(const std::string& fileName)
+        noexcept(false)
+    {
+        std::ifstream strm(fileName.c_str(), ios::in | ios::binary);
+        if(!strm)
+        {
+            FileMissingException e("SatSeriesStore: can't open " + fileName);
+            THROW(e);
+        }
+
+        char magic[8];
+        strm.read(magic, sizeof(magic));
+        if( !strm || std::memcmp(magic, seriesMagic, sizeof(magic)) != 0 )
+        {
+            FFStreamError e("SatSeriesStore: not a series file: " + fileName);
+            THROW(e);
+        }
+
+        uint32_t version( get<uint32_t>(strm) );
+        if( get<uint32_t>(strm) != byteOrderMark )
+        {
+            FFStreamError e("SatSeriesStore: byte order of " + fileName
+                            + " differs from this machine");
+            THROW(e);
+        }
+        if(version > seriesVersion)
+        {
+            FFStreamError e("SatSeriesStore: " + fileName
+                            + " has a newer format version");
+            THROW(e);
+        }
+
+        int32_t day( get<int32_t>(strm) );
+        int32_t msod( get<int32_t>(strm) );
+        double fsod( get<double>(strm) );
+        int32_t timeSys( get<int32_t>(strm) );
+        double res( get<double>(strm) );
+        if( get<uint32_t>(strm) != chunkSize )
+        {
+            FFStreamError e("SatSeriesStore: chunk size of " + fileName
+                            + " differs from this build");
+            THROW(e);
+        }
+
+        seriesData.clear();
+        types.clear();
+        resolutions.clear();
+
+        refEpoch.setInternal( day, msod, fsod,
+                              static_cast<TimeSystem::Systems>(timeSys) );
+        refEpochSet = true;
+        timeRes = res;
+
+        uint16_t numCols( get<uint16_t>(strm) );
+        for(int col=0; col<numCols; col++)
+        {
+            double resolution( get<double>(strm) );
+            string name( get<uint16_t>(strm), ' ' );
+            if( !strm.read(&name[0], name.size()) )
+            {
+                FFStreamError e("SatSeriesStore: truncated file");
+                THROW(e);
+            }
+            types.push_back( TypeID(name) );
+            resolutions.push_back(resolution);
+        }
+
+        uint16_t numSats( get<uint16_t>(strm) );
+        for(int i=0; i<numSats; i++)
+        {
+            char sysChar( get<char>(strm) );
+            int16_t prn( get<int16_t>(strm) );
+
+            SatelliteSystem sys;
+            sys.fromChar(sysChar);
+            Series& series( seriesData[SatID(prn, sys.getSatelliteSystem())] );
+
+            series.rows = get<uint64_t>(strm);
+            getColumn(strm, series.time.bytes, series.time.chunkStart);
+            checkColumn( series.time.bytes, series.time.chunkStart,
+                         series.rows, chunkSize );
+
+            series.values.resize(types.size());
+            for(size_t col=0; col<types.size(); col++)
+            {
+                getColumn( strm, series.values[col].bytes,
+                           series.values[col].chunkStart );
+                checkColumn( series.values[col].bytes,
+                             series.values[col].chunkStart,
+                             series.rows, chunkSize );
+            }
+
+            if(series.rows == 0) continue;
+
+            // the last values of the last chunk, to go on appending to it
+            size_t chunk( series.time.chunkStart.size() - 1 );
+            size_t n( series.rows - chunk*chunkSize );
+
+            const unsigned char* p( &series.time.bytes[0]
+                                    + series.time.chunkStart[chunk] );
+            long long t(0), step(0);
+            for(size_t k=0; k<n; k++)
+            {
+                step += unzigzag(getVarint(p));
+                t += step;
+            }
+            series.time.last = t;
+            series.lastStep = step;
+
+            for(size_t col=0; col<types.size(); col++)
+            {
+                Column& column( series.values[col] );
+                p = &column.bytes[0] + column.chunkStart[chunk];
+                long long q(0);
+                for(size_t k=0; k<n; k++)
+                {
+                    uint64_t v( getVarint(p) );
+                    if(v != 0) q += unzigzag(v - 1);
+                }
+                column.last = q;
+            }
+        }
+
+    }  // End of method 'SatSeriesStore::loadFile()'
+
+}  // End of namespace gnssSpace
@@ -0,0 +1,278 @@
+/**
+ * @file SatSeriesStore.hpp
+ * Columnar store of the time series of some TypeIDs of each satellite
+ * over a whole session, for the analysis of residuals, elevations, MW
+ * values, arcs, ...
+ */
+
+#ifndef SatSeriesStore_HPP
+#define SatSeriesStore_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "DataStructures.hpp"
+#include "Rx3ObsData.hpp"
+
+using namespace utilSpace;
+using namespace timeSpace;
+
+namespace gnssSpace
+{
+
+      /** Columnar store of the time series of some TypeIDs of each
+       *  satellite.
+       *
+       * Each satellite has a time column and a column per TypeID added
+       * with addColumn(). The values are quantized to the resolution of
+       * their column and stored as variable length differences to the
+       * previous value; times are quantized to the time resolution and
+       * stored as differences of the interval, which are 0 for a regular
+       * sampling. A missing value takes one byte. So a row takes a few
+       * bytes per column, instead of a map node per value.
+       *
+       * The columns are split in chunks of chunkSize rows, each one
+       * decoded on its own. Scans decode a chunk into a plain array of
+       * doubles and run over it, so they stay simple loops.
+       *
+       * A typical way to use this class follows:
+       *
+       * @code
+       *   SatSeriesStore seriesStore;
+       *   seriesStore.addColumn(TypeID::elevation, 1.e-3);
+       *   seriesStore.addColumn(TypeID::postfitC1G, 1.e-4);
+       *
+       *   while( rxStream >> rxData )
+       *   {
+       *      ...
+       *      lsqSPP.Process(rxData);
+       *      seriesStore.append(rxData);
+       *   }
+       *
+       *   // RMS of the residuals in 5 degree bins of elevation
+       *   std::vector<SatSeriesStore::BinStats> stats(
+       *      seriesStore.binned(TypeID::postfitC1G, TypeID::elevation,
+       *                         0.0, 5.0, 18) );
+       *
+       *   seriesStore.writeFile("session.col");
+       * @endcode
+       *
+       * @warning The columns must be added before the first append().
+       */
+    class SatSeriesStore
+    {
+    public:
+
+         /// Number of rows of a chunk
+        static const size_t chunkSize = 256;
+
+         /// Statistics of the values of a bin
+        struct BinStats
+        {
+            BinStats()
+                : count(0), mean(0.0), rms(0.0)
+            {};
+
+            size_t count;
+            double mean;
+            double rms;
+        };
+
+
+         /** Constructor.
+          *
+          * @param timeResolution   Resolution of the times, in seconds.
+          */
+        SatSeriesStore(double timeResolution = 1.e-3)
+            : timeRes(timeResolution), refEpochSet(false)
+        {};
+
+
+         /** Add a column.
+          *
+          * @param type         TypeID of the values.
+          * @param resolution   Resolution the values are kept with.
+          *
+          * @throw InvalidRequest if data were already appended
+          */
+        virtual SatSeriesStore& addColumn( const TypeID& type,
+                                           double resolution )
+            noexcept(false);
+
+
+         /** Append a row to each satellite of an epoch. Values which are
+          *  NaN or infinite, or too large for the resolution of their
+          *  column, are kept as missing.
+          *
+          * @throw InvalidRequest if the epoch is too far from the first one
+          *        for the time resolution
+          */
+        virtual void append( const CommonTime& epoch,
+                             const satTypeValueMap& stvData )
+            noexcept(false);
+
+        virtual void append(const Rx3ObsData& rData)
+            noexcept(false)
+        { append(rData.currEpoch, rData.stvData); };
+
+
+         /// Remove the data, keeping the columns
+        virtual void clear();
+
+
+         /// TypeIDs of the columns
+        const std::vector<TypeID>& getColumns() const
+        { return types; };
+
+         /// Epoch the times are counted from: the first one appended
+        const CommonTime& getRefEpoch() const
+        { return refEpoch; };
+
+         /// Satellites with data
+        virtual SatIDSet getSatIDSet() const;
+
+         /// Number of rows of a satellite
+        virtual size_t numRows(const SatID& sat) const;
+
+
+         /** Series of a column for a satellite.
+          *
+          * @param sat      Satellite.
+          * @param type     TypeID of the column.
+          * @param times    Seconds from getRefEpoch().
+          * @param values   Values, NaN where missing.
+          *
+          * @throw TypeIDNotFound if there is no such column
+          */
+        virtual void getSeries( const SatID& sat,
+                                const TypeID& type,
+                                std::vector<double>& times,
+                                std::vector<double>& values ) const
+            noexcept(false);
+
+
+         /** RMS of the values of a column for a satellite.
+          *
+          * @param count   Number of values used.
+          *
+          * @throw TypeIDNotFound if there is no such column
+          */
+        virtual double rms( const SatID& sat,
+                            const TypeID& type,
+                            size_t& count ) const
+            noexcept(false);
+
+
+         /** Statistics of the values of a column, over all satellites, in
+          *  bins of the values of another one, e.g. residuals by elevation.
+          *  Rows where either value is missing, or outside the bins, are
+          *  left out.
+          *
+          * @param type       TypeID of the values.
+          * @param binType    TypeID the bins are of.
+          * @param binMin     Lower limit of the first bin.
+          * @param binWidth   Width of the bins.
+          * @param numBins    Number of bins.
+          *
+          * @throw TypeIDNotFound if there is no such column
+          */
+        virtual std::vector<BinStats> binned( const TypeID& type,
+                                              const TypeID& binType,
+                                              double binMin,
+                                              double binWidth,
+                                              int numBins ) const
+            noexcept(false);
+
+
+         /// Bytes taken by the columns
+        virtual size_t memoryUsed() const;
+
+
+         /** Write the store to a binary columnar file: the columns of each
+          *  satellite are written as they are kept, with their chunks.
+          */
+        virtual void writeFile(const std::string& fileName) const
+            noexcept(false);
+
+         /** Read a file written by writeFile(), replacing the store. The
+          *  chunks are checked to decode within their column.
+          *
+          * @throw FileMissingException if the file can't be opened
+          * @throw FFStreamError if the file is not a series file, or is
+          *        truncated or corrupt
+          */
+        virtual void loadFile(const std::string& fileName)
+            noexcept(false);
+
+
+         /// Destructor
+        virtual ~SatSeriesStore() {};
+
+    private:
+
+         /// A column: the encoded values, and where each chunk starts
+        struct Column
+        {
+            Column()
+                : last(0)
+            {};
+
+            std::vector<unsigned char> bytes;
+            std::vector<size_t> chunkStart;
+
+             /// last quantized value appended
+            long long last;
+        };
+
+         /// Columns of a satellite
+        struct Series
+        {
+            Series()
+                : rows(0), lastStep(0)
+            {};
+
+            size_t rows;
+
+             /// last time interval appended, in units of timeRes
+            long long lastStep;
+
+            Column time;
+            std::vector<Column> values;
+        };
+
+         /// Index of the column of a type
+         /// @throw TypeIDNotFound if there is no such column
+        size_t columnOf(const TypeID& type) const
+            noexcept(false);
+
+         /// Decode the times of a chunk, in seconds from refEpoch
+        size_t decodeTimes( const Series& series,
+                            size_t chunk,
+                            double* times ) const;
+
+         /// Decode the values of a chunk of a column, NaN where missing
+        size_t decodeValues( const Series& series,
+                             size_t col,
+                             size_t chunk,
+                             double* values ) const;
+
+        double timeRes;
+
+        CommonTime refEpoch;
+        bool refEpochSet;
+
+         /// TypeID and resolution of the columns
+        std::vector<TypeID> types;
+        std::vector<double> resolutions;
+
+        std::map<SatID, Series> seriesData;
+
+    };  // End of class 'SatSeriesStore'
+
+}  // End of namespace gnssSpace
+
+#endif   // SatSeriesStore_HPP
@@ -0,0 +1,284 @@
+/**
+ * @file SatTypeValueTable.cpp
+ * Dense (structure-of-arrays) container of the data of one epoch.
+ */
+
+#include <algorithm>
+
+#include "SatTypeValueTable.hpp"
+
+using namespace utilSpace;
+using namespace std;
+
+namespace gnssSpace
+{
+
+      // order of (satellite, row) pairs by satellite
+    static bool lessSat(const std::pair<SatID, int>& left, const SatID& sat)
+    { return left.first < sat; }
+
+
+    satTypeValueTable::satTypeValueTable()
+        : nActive(0), colOfType(TypeID::count, -1), rowCap(0), nWords(0)
+    {}
+
+
+      // Remove all data, keeping the memory
+    void satTypeValueTable::clear()
+    {
+        for(size_t i=0; i<types.size(); i++)
+        {
+            colOfType[types[i].type] = -1;
+        }
+
+        sats.clear();
+        active.clear();
+        nActive = 0;
+        satRows.clear();
+        types.clear();
+        values.clear();
+        masks.clear();
+
+    }  // End of method 'satTypeValueTable::clear()'
+
+
+      // Row of a satellite, -1 if not found or removed
+    int satTypeValueTable::satIndex(const SatID& sat) const
+    {
+        std::vector< std::pair<SatID, int> >::const_iterator it =
+            std::lower_bound(satRows.begin(), satRows.end(), sat, lessSat);
+
+        if( it == satRows.end() || it->first != sat || !active[it->second] )
+        {
+            return -1;
+        }
+
+        return it->second;
+
+    }  // End of method 'satTypeValueTable::satIndex()'
+
+
+      // Row of a satellite, added (or made active again) if not found
+    int satTypeValueTable::addSat(const SatID& sat)
+    {
+        std::vector< std::pair<SatID, int> >::iterator it =
+            std::lower_bound(satRows.begin(), satRows.end(), sat, lessSat);
+
+        if( it != satRows.end() && it->first == sat )
+        {
+            if( !active[it->second] )
+            {
+                active[it->second] = 1;
+                nActive++;
+            }
+            return it->second;
+        }
+
+        int row( sats.size() );
+        reserveRows(row + 1);
+
+        sats.push_back(sat);
+        active.push_back(1);
+        nActive++;
+        satRows.insert(it, std::make_pair(sat, row));
+
+        return row;
+
+    }  // End of method 'satTypeValueTable::addSat()'
+
+
+      // Column of a type, added if not found
+    int satTypeValueTable::addType(const TypeID& type)
+    {
+        int col( typeIndex(type) );
+        if(col >= 0) return col;
+
+        col = types.size();
+        types.push_back(type);
+        colOfType[type.type] = col;
+
+        values.resize(values.size() + rowCap, 0.0);
+        masks.resize(masks.size() + nWords, 0);
+
+        return col;
+
+    }  // End of method 'satTypeValueTable::addType()'
+
+
+      // Make room for n rows, moving the data if needed
+    void satTypeValueTable::reserveRows(int n)
+    {
+        if(n <= rowCap) return;
+
+        int newCap( std::max(n, std::max(2*rowCap, 64)) );
+        int newWords( (newCap + 63) / 64 );
+
+        const int nCol( types.size() );
+        std::vector<double> newValues(size_t(nCol) * newCap, 0.0);
+        std::vector<uint64_t> newMasks(size_t(nCol) * newWords, 0);
+
+        for(int c=0; c<nCol; c++)
+        {
+            std::copy( values.begin() + size_t(c)*rowCap,
+                       values.begin() + size_t(c+1)*rowCap,
+                       newValues.begin() + size_t(c)*newCap );
+            std::copy( masks.begin() + size_t(c)*nWords,
+                       masks.begin() + size_t(c+1)*nWords,
+                       newMasks.begin() + size_t(c)*newWords );
+        }
+
+        values.swap(newValues);
+        masks.swap(newMasks);
+        rowCap = newCap;
+        nWords = newWords;
+
+    }  // End of method 'satTypeValueTable::reserveRows()'
+
+
+      // Return the data value corresponding to provided SatID and TypeID.
+    double satTypeValueTable::getValue( const SatID& sat,
+                                        const TypeID& type ) const
+        noexcept(false)
+    {
+        int row( satIndex(sat) );
+        if(row < 0)
+        {
+            THROW(SatIDNotFound("SatID not found in table"));
+        }
+
+        int col( typeIndex(type) );
+        if( col < 0 || !hasValue(row, col) )
+        {
+            THROW(TypeIDNotFound(type.asString() + " TypeID not found in table"));
+        }
+
+        return value(row, col);
+
+    }  // End of method 'satTypeValueTable::getValue()'
+
+
+      // Return a reference to the value of a satellite and type, added
+      // (as zero) if not present.
+    double& satTypeValueTable::operator()(const SatID& sat, const TypeID& type)
+    {
+        int row( addSat(sat) );
+        int col( addType(type) );
+
+        if( !hasValue(row, col) ) setValue(row, col, 0.0);
+
+        return values[size_t(col)*rowCap + row];
+
+    }  // End of method 'satTypeValueTable::operator()'
+
+
+      // Remove the satellite of this row; the row stays, inactive.
+    void satTypeValueTable::removeRow(int row)
+    {
+        if( !active[row] ) return;
+
+        active[row] = 0;
+        nActive--;
+
+        for(size_t c=0; c<types.size(); c++)
+        {
+            removeValue(row, c);
+        }
+
+    }  // End of method 'satTypeValueTable::removeRow()'
+
+
+      // Remove these satellites
+    satTypeValueTable& satTypeValueTable::removeSatID(const SatIDSet& satSet)
+    {
+        for(SatIDSet::const_iterator it = satSet.begin();
+            it != satSet.end();
+            ++it)
+        {
+            int row( satIndex(*it) );
+            if(row >= 0) removeRow(row);
+        }
+
+        return (*this);
+
+    }  // End of method 'satTypeValueTable::removeSatID()'
+
+
+      // Fill the table with the data of a satTypeValueMap
+    void satTypeValueTable::fromMap(const satTypeValueMap& stvData)
+    {
+        clear();
+        reserveRows( stvData.size() );
+
+        for(satTypeValueMap::const_iterator it = stvData.begin();
+            it != stvData.end();
+            ++it)
+        {
+            // satellites come in order, so they are appended
+            int row( addSat(it->first) );
+
+            for(typeValueMap::const_iterator itt = it->second.begin();
+                itt != it->second.end();
+                ++itt)
+            {
+                setValue(row, addType(itt->first), itt->second);
+            }
+        }
+
+    }  // End of method 'satTypeValueTable::fromMap()'
+
+
+      // Write the data of the active satellites to a satTypeValueMap
+    void satTypeValueTable::toMap(satTypeValueMap& stvData) const
+    {
+        stvData.clear();
+
+        for(size_t r=0; r<satRows.size(); r++)
+        {
+            int row( satRows[r].second );
+            if( !active[row] ) continue;
+
+            typeValueMap& tvMap( stvData[sats[row]] );
+            for(size_t c=0; c<types.size(); c++)
+            {
+                if( hasValue(row, c) )
+                {
+                    tvMap[types[c]] = value(row, c);
+                }
+            }
+        }
+
+    }  // End of method 'satTypeValueTable::toMap()'
+
+
+      // Convenience output method
+    std::ostream& satTypeValueTable::dump(std::ostream& s) const
+    {
+        for(size_t r=0; r<satRows.size(); r++)
+        {
+            int row( satRows[r].second );
+            if( !active[row] ) continue;
+
+            s << sats[row] << " ";
+            for(size_t c=0; c<types.size(); c++)
+            {
+                if( hasValue(row, c) )
+                {
+                    s << types[c] << " " << value(row, c) << " ";
+                }
+            }
+            s << endl;
+        }
+
+        return s;
+
+    }  // End of method 'satTypeValueTable::dump()'
+
+
+      // stream output for satTypeValueTable
+    std::ostream& operator<<(std::ostream& s, const satTypeValueTable& table)
+    {
+        table.dump(s);
+        return s;
+    }
+
+}  // End of namespace gnssSpace
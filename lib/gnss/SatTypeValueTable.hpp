@@ -0,0 +1,189 @@
+/**
+ * @file SatTypeValueTable.hpp
+ * Dense (structure-of-arrays) container of the data of one epoch, an
+ * alternative to satTypeValueMap for the processing classes.
+ */
+
+#ifndef SatTypeValueTable_HPP
+#define SatTypeValueTable_HPP
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <iostream>
+
+#include "Exception.hpp"
+#include "SatID.hpp"
+#include "TypeID.hpp"
+#include "DataStructures.hpp"
+
+using namespace utilSpace;
+using namespace timeSpace;
+
+namespace gnssSpace
+{
+
+      /** Data of one epoch stored as a table: one row per satellite, one
+       *  column per TypeID present in the epoch. The values of a column are
+       *  contiguous, and a bit mask per column tells which satellites have
+       *  the value.
+       *
+       *  Satellites and types are found by index: satIndex() is a binary
+       *  search over the (few) satellites, and typeIndex() a direct look-up
+       *  with the TypeID value. Processing classes should look up the
+       *  indexes of their types once per epoch, then read and write values
+       *  by (row, column) without any search or allocation.
+       *
+       *  Rows of removed satellites are kept, but are inactive, so that the
+       *  indexes stay valid during the epoch. clear() drops the data and
+       *  keeps the memory for the next epoch.
+       *
+       *  fromMap() and toMap() convert from and to satTypeValueMap, so that
+       *  the processing classes may move to this container one at a time:
+       *
+       *  @code
+       *    satTypeValueTable table;
+       *    table.fromMap(rxData.stvData);
+       *    computeDerivative.Process(rxData.currEpoch, table);
+       *    computeTrop.Process(rxData.currEpoch, table);
+       *    table.toMap(rxData.stvData);
+       *  @endcode
+       */
+    class satTypeValueTable
+    {
+    public:
+
+         /// Default constructor
+        satTypeValueTable();
+
+         /// Remove all data, keeping the memory
+        void clear();
+
+         /// Number of rows, removed satellites included
+        int numRows() const
+        { return sats.size(); }
+
+         /// Number of satellites with data
+        size_t numSats() const
+        { return nActive; }
+
+         /// Number of columns
+        int numTypes() const
+        { return types.size(); }
+
+         /// Satellite of a row
+        const SatID& getSat(int row) const
+        { return sats[row]; }
+
+         /// TypeID of a column
+        const TypeID& getType(int col) const
+        { return types[col]; }
+
+         /// true if the satellite of this row was not removed
+        bool isActive(int row) const
+        { return active[row] != 0; }
+
+         /// Row of a satellite, -1 if not found or removed
+        int satIndex(const SatID& sat) const;
+
+         /// Column of a type, -1 if not found
+        int typeIndex(const TypeID& type) const
+        {
+            return (type.type >= 0 && type.type < TypeID::count) ?
+                   colOfType[type.type] : -1;
+        }
+
+         /// Row of a satellite, added (or made active again) if not found
+        int addSat(const SatID& sat);
+
+         /// Column of a type, added if not found
+        int addType(const TypeID& type);
+
+         /// true if the satellite of this row has the value of this column
+        bool hasValue(int row, int col) const
+        {
+            return ( masks[col*nWords + (row >> 6)]
+                     >> (row & 63) ) & 1;
+        }
+
+         /// Value at (row,col), not checked
+        double value(int row, int col) const
+        { return values[col*rowCap + row]; }
+
+         /// Set the value at (row,col)
+        void setValue(int row, int col, double x)
+        {
+            values[col*rowCap + row] = x;
+            masks[col*nWords + (row >> 6)] |= (uint64_t(1) << (row & 63));
+        }
+
+         /// Remove the value at (row,col)
+        void removeValue(int row, int col)
+        { masks[col*nWords + (row >> 6)] &= ~(uint64_t(1) << (row & 63)); }
+
+         /// Values of a column, to be used with hasValue()
+        const double* column(int col) const
+        { return &values[col*rowCap]; }
+
+         /** Return the data value corresponding to provided SatID and
+          *  TypeID.
+          *
+          * @param sat     Satellite to be looked for.
+          * @param type    Type to be looked for.
+          */
+        double getValue(const SatID& sat, const TypeID& type) const
+            noexcept(false);
+
+         /// Return a reference to the value of a satellite and type, added
+         /// (as zero) if not present.
+        double& operator()(const SatID& sat, const TypeID& type);
+
+         /// Remove the satellite of this row; the row stays, inactive.
+        void removeRow(int row);
+
+         /// Remove these satellites
+        satTypeValueTable& removeSatID(const SatIDSet& satSet);
+
+         /// Fill the table with the data of a satTypeValueMap
+        void fromMap(const satTypeValueMap& stvData);
+
+         /// Write the data of the active satellites to a satTypeValueMap
+        void toMap(satTypeValueMap& stvData) const;
+
+         /// Convenience output method
+        std::ostream& dump(std::ostream& s) const;
+
+    private:
+
+         /// Make room for n rows, moving the data if needed
+        void reserveRows(int n);
+
+         /// satellites of the rows, and if they are active
+        std::vector<SatID> sats;
+        std::vector<char> active;
+        size_t nActive;
+
+         /// (satellite, row), sorted by satellite
+        std::vector< std::pair<SatID, int> > satRows;
+
+         /// types of the columns, and the column of each TypeID value
+        std::vector<TypeID> types;
+        std::vector<int> colOfType;
+
+         /// rows allocated per column, and 64 bit words of mask per column
+        int rowCap;
+        int nWords;
+
+         /// values and presence bits, column by column
+        std::vector<double> values;
+        std::vector<uint64_t> masks;
+
+    };  // End of 'satTypeValueTable'
+
+
+      /// stream output for satTypeValueTable
+    std::ostream& operator<<(std::ostream& s, const satTypeValueTable& table);
+
+}  // End of namespace gnssSpace
+
+#endif   // SatTypeValueTable_HPP
@@ -0,0 +1,239 @@
+/**
+ * @file SegmentedRun.cpp
+ * Processing of a session cut into segments run in parallel, each one
+ * starting with some epochs of warm-up, and comparison of the stitched
+ * results with those of a run over all the epochs in order.
+ */
+
+#include <cmath>
+#include <memory>
+#include <iomanip>
+#include <exception>
+#include <algorithm>
+
+#include "EpochArena.hpp"
+#include "SegmentedRun.hpp"
+
+using namespace std;
+
+namespace gnssSpace
+{
+
+      // Check that there is something to run
+    void SegmentedRun::checkSetup() const
+        noexcept(false)
+    {
+        if( !chainFactory || !loadEpoch || numEpochs == 0 )
+        {
+            InvalidRequest e( "SegmentedRun: the chain factory and the "
+                              "epochs must be given" );
+            THROW(e);
+        }
+
+    }  // End of method 'SegmentedRun::checkSetup()'
+
+
+      // Process the segments in parallel
+    void SegmentedRun::run()
+        noexcept(false)
+    {
+        checkSetup();
+
+        size_t n( std::max(1, numSegments) );
+        n = std::min(n, numEpochs);
+
+        segFirst.resize(n);
+        segEnd.resize(n);
+        segWarmUp.resize(n);
+        for(size_t k=0; k<n; k++)
+        {
+            segFirst[k] = numEpochs*k/n;
+            segEnd[k] = numEpochs*(k+1)/n;
+            segWarmUp[k] = (k == 0) ? 0 : std::min(overlap, segFirst[k]);
+        }
+
+        output.assign(numEpochs, std::vector<double>());
+        startStates.assign(n, std::vector<char>());
+        endStates.assign(n, std::vector<char>());
+
+        std::vector<std::exception_ptr> errors(n);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for(int k=0; k<int(n); k++)
+        {
+            try
+            {
+                std::unique_ptr<Chain> chain( chainFactory() );
+
+                if(k == 0 && !initialState.empty())
+                {
+                    StateReader reader(initialState);
+                    chain->restoreState(reader);
+                }
+
+                Rx3ObsData data;
+                std::vector<double> discarded;
+
+                // warm-up: the results go away
+                for(size_t i=segFirst[k]-segWarmUp[k]; i<segFirst[k]; i++)
+                {
+                    loadEpoch(i, data);
+                    discarded.clear();
+                    chain->process(data, discarded);
+                    EpochArena::local().reset();
+                }
+
+                StateWriter writer;
+                chain->saveState(writer);
+                startStates[k] = writer.getData();
+
+                for(size_t i=segFirst[k]; i<segEnd[k]; i++)
+                {
+                    loadEpoch(i, data);
+                    chain->process(data, output[i]);
+                    EpochArena::local().reset();
+                }
+
+                writer.clear();
+                chain->saveState(writer);
+                endStates[k] = writer.getData();
+            }
+            catch(...)
+            {
+                errors[k] = std::current_exception();
+            }
+        }
+
+        for(size_t k=0; k<n; k++)
+        {
+            if(errors[k])
+            {
+                std::rethrow_exception(errors[k]);
+            }
+        }
+
+        finalState = endStates.back();
+
+    }  // End of method 'SegmentedRun::run()'
+
+
+      // Process all the epochs in order with one chain
+    void SegmentedRun::runSequential()
+        noexcept(false)
+    {
+        checkSetup();
+
+        std::unique_ptr<Chain> chain( chainFactory() );
+
+        if(!initialState.empty())
+        {
+            StateReader reader(initialState);
+            chain->restoreState(reader);
+        }
+
+        seqOutput.assign(numEpochs, std::vector<double>());
+
+        Rx3ObsData data;
+        for(size_t i=0; i<numEpochs; i++)
+        {
+            loadEpoch(i, data);
+            chain->process(data, seqOutput[i]);
+            EpochArena::local().reset();
+        }
+
+    }  // End of method 'SegmentedRun::runSequential()'
+
+
+      // Compare the results of run() and runSequential()
+    std::vector<SegmentedRun::SegmentReport> SegmentedRun::compare() const
+        noexcept(false)
+    {
+        if( segFirst.empty() || seqOutput.size() != output.size() )
+        {
+            InvalidRequest e( "SegmentedRun: run() and runSequential() "
+                              "must be called before compare()" );
+            THROW(e);
+        }
+
+        std::vector<SegmentReport> reports( segFirst.size() );
+        for(size_t k=0; k<segFirst.size(); k++)
+        {
+            SegmentReport& rep( reports[k] );
+            rep.firstEpoch = segFirst[k];
+            rep.endEpoch = segEnd[k];
+            rep.warmUp = segWarmUp[k];
+            rep.stateMatch = (k == 0) || (startStates[k] == endStates[k-1]);
+            rep.numDiffering = 0;
+            rep.settleEpochs = 0;
+            rep.maxDiff = 0.0;
+
+            for(size_t i=segFirst[k]; i<segEnd[k]; i++)
+            {
+                const std::vector<double>& a( output[i] );
+                const std::vector<double>& b( seqOutput[i] );
+
+                // an epoch with results in only one of the runs differs
+                bool differs( a.size() != b.size() );
+                for(size_t j=0; j<a.size() && j<b.size(); j++)
+                {
+                    double diff( std::abs(a[j] - b[j]) );
+                    if( !(diff <= tolerance) ) differs = true;
+                    if( diff > rep.maxDiff ) rep.maxDiff = diff;
+                }
+
+                if(differs)
+                {
+                    rep.numDiffering++;
+                    rep.settleEpochs = i - segFirst[k] + 1;
+                }
+            }
+        }
+
+        return reports;
+
+    }  // End of method 'SegmentedRun::compare()'
+
+
+      // Print what compare() finds
+    void SegmentedRun::dumpReport(std::ostream& s) const
+        noexcept(false)
+    {
+        std::vector<SegmentReport> reports( compare() );
+
+        s << " segment   first     end  warm-up  state  differing  settle"
+          << "      max diff" << endl;
+
+        size_t numDiffering(0), numMatch(0), settle(0);
+        double maxDiff(0.0);
+        for(size_t k=0; k<reports.size(); k++)
+        {
+            const SegmentReport& rep( reports[k] );
+            s << setw(8) << k
+              << setw(8) << rep.firstEpoch
+              << setw(8) << rep.endEpoch
+              << setw(9) << rep.warmUp
+              << setw(7) << (rep.stateMatch ? "same" : "other")
+              << setw(11) << rep.numDiffering
+              << setw(8) << rep.settleEpochs
+              << setw(14) << scientific << setprecision(3) << rep.maxDiff
+              << endl;
+
+            numDiffering += rep.numDiffering;
+            if(rep.stateMatch) numMatch++;
+            settle = std::max(settle, rep.settleEpochs);
+            maxDiff = std::max(maxDiff, rep.maxDiff);
+        }
+
+        s << " " << numDiffering << " of " << output.size()
+          << " epochs differ from the sequential run, up to "
+          << settle << " epochs into a segment; max diff "
+          << scientific << setprecision(3) << maxDiff << "; "
+          << numMatch << " of " << reports.size()
+          << " segments start from the state of the sequential run"
+          << endl;
+
+    }  // End of method 'SegmentedRun::dumpReport()'
+
+}  // End of namespace gnssSpace
@@ -0,0 +1,238 @@
+/**
+ * @file SegmentedRun.hpp
+ * Processing of a session cut into segments run in parallel, each one
+ * starting with some epochs of warm-up, and comparison of the stitched
+ * results with those of a run over all the epochs in order.
+ */
+
+#ifndef SegmentedRun_HPP
+#define SegmentedRun_HPP
+
+#include <vector>
+#include <ostream>
+#include <functional>
+
+#include "Exception.hpp"
+#include "Rx3ObsData.hpp"
+#include "ProcessorState.hpp"
+
+using namespace utilSpace;
+
+namespace gnssSpace
+{
+
+      /** Segmented run of the stateful stages of a processing chain.
+       *
+       * DetectCSMW, MarkArc, FilterSPP and the stochastic models keep a
+       * state from one epoch to the next, so a session is processed in
+       * order. Here the epochs are cut into segments processed in
+       * parallel, each with its own chain. A segment starts 'overlap'
+       * epochs before its first one, to build up its state again (MW
+       * windows, filter covariance), and only the results of its own
+       * epochs are kept; the results of all the segments are stitched in
+       * the order of the epochs.
+       *
+       * The results depend on the state a segment starts with, so they
+       * may differ from those of a run over all the epochs. compare()
+       * tells how much, segment by segment, against runSequential():
+       * whether the state after the warm-up is the one the segment before
+       * ended with (then the segment gives exactly the results of the
+       * sequential run), how many epochs differ, for how long after the
+       * start of the segment, and by how much. Counters kept over the
+       * whole session, as the arc numbers of MarkArc, never come back
+       * after a warm-up.
+       *
+       * The state of the chains is taken with their saveState(), which
+       * also gives the state at the end of the session (to go on with the
+       * next one) and takes the state to start the first segment with.
+       *
+       * @code
+       *   class SppChain : public SegmentedRun::Chain
+       *   {
+       *      ...  // DetectCSMW, MarkArc, FilterSPP
+       *   };
+       *
+       *   SegmentedRun segRun;
+       *   segRun.setChainFactory( []() { return new SppChain; } )
+       *         .setEpochs( epochs.size(),
+       *                     [&](size_t i, Rx3ObsData& data)
+       *                     { data.currEpoch = epochs[i].currEpoch;
+       *                       data.stvData = epochs[i].stvData; } )
+       *         .setSegments(8)
+       *         .setOverlap(120);
+       *   segRun.run();
+       *   segRun.runSequential();
+       *   segRun.dumpReport(cout);
+       * @endcode
+       *
+       * Without USE_OPENMP the segments are processed one after the other.
+       */
+    class SegmentedRun
+    {
+    public:
+
+          /** Stateful stages of a processing chain. Each segment gets its
+           *  own chain from the factory.
+           */
+        class Chain
+        {
+        public:
+
+             /** Process an epoch, putting its results in 'output', which
+              *  comes empty and stays empty for an epoch without results.
+              */
+            virtual void process( Rx3ObsData& data,
+                                  std::vector<double>& output ) = 0;
+
+             /// Write the state of all the stages
+            virtual void saveState(StateWriter& writer) const = 0;
+
+             /// Restore a state written by saveState()
+            virtual void restoreState(StateReader& reader)
+                noexcept(false) = 0;
+
+             /// Destructor
+            virtual ~Chain() {};
+        };
+
+         /// Create a new chain
+        typedef std::function<Chain*()> ChainFactory;
+
+         /** Fill the data of epoch 'index'. It is called from several
+          *  threads at once, for different epochs.
+          */
+        typedef std::function<void(size_t index, Rx3ObsData& data)> EpochFunction;
+
+
+         /// What compare() found for a segment
+        struct SegmentReport
+        {
+            size_t firstEpoch;    ///< first epoch of the segment
+            size_t endEpoch;      ///< one past its last epoch
+            size_t warmUp;        ///< epochs processed before the first
+
+             /// state after the warm-up equal to the one the segment
+             /// before ended with
+            bool stateMatch;
+
+             /// epochs with other results than in the sequential run
+            size_t numDiffering;
+
+             /// epochs from the first one to the last differing one
+            size_t settleEpochs;
+
+             /// largest difference of a result
+            double maxDiff;
+        };
+
+
+         /// Default constructor: one segment, no warm-up
+        SegmentedRun()
+            : numEpochs(0), numSegments(1), overlap(0), tolerance(0.0)
+        {};
+
+
+         /// Function creating the chains
+        virtual SegmentedRun& setChainFactory(ChainFactory factory)
+        { chainFactory = factory; return (*this); };
+
+         /// Number of epochs of the session, and the function filling them
+        virtual SegmentedRun& setEpochs(size_t num, EpochFunction function)
+        { numEpochs = num; loadEpoch = function; return (*this); };
+
+         /// Number of segments
+        virtual SegmentedRun& setSegments(int num)
+        { numSegments = num; return (*this); };
+
+         /// Epochs processed before the first one of a segment
+        virtual SegmentedRun& setOverlap(size_t epochs)
+        { overlap = epochs; return (*this); };
+
+         /// Largest difference of a result taken as equal in compare()
+        virtual SegmentedRun& setTolerance(double tol)
+        { tolerance = tol; return (*this); };
+
+         /** State to start the first segment (and the sequential run)
+          *  with, e.g. the final state of the session before.
+          */
+        virtual SegmentedRun& setInitialState(const std::vector<char>& state)
+        { initialState = state; return (*this); };
+
+
+         /** Process the segments in parallel.
+          *
+          * @throw InvalidRequest if the factory or the epochs are missing.
+          *        Exceptions of the chains are thrown again, those of the
+          *        first segment first.
+          */
+        virtual void run()
+            noexcept(false);
+
+         /** Process all the epochs in order with one chain, for compare().
+          *
+          * @throw InvalidRequest if the factory or the epochs are missing
+          */
+        virtual void runSequential()
+            noexcept(false);
+
+
+         /// Stitched results of run(), one vector per epoch
+        virtual const std::vector< std::vector<double> >& getOutput() const
+        { return output; };
+
+         /// Results of runSequential(), one vector per epoch
+        virtual const std::vector< std::vector<double> >& getSequentialOutput() const
+        { return seqOutput; };
+
+         /// State at the end of the last segment of run()
+        virtual const std::vector<char>& getFinalState() const
+        { return finalState; };
+
+
+         /** Compare the results of run() and runSequential().
+          *
+          * @throw InvalidRequest if one of them is missing
+          */
+        virtual std::vector<SegmentReport> compare() const
+            noexcept(false);
+
+         /// Print what compare() finds, segment by segment and in total
+        virtual void dumpReport(std::ostream& s) const
+            noexcept(false);
+
+
+         /// Destructor
+        virtual ~SegmentedRun() {};
+
+    private:
+
+         /// Check that there is something to run
+        void checkSetup() const
+            noexcept(false);
+
+        ChainFactory chainFactory;
+        EpochFunction loadEpoch;
+
+        size_t numEpochs;
+        int numSegments;
+        size_t overlap;
+        double tolerance;
+
+        std::vector<char> initialState;
+
+         /// segments of the last run()
+        std::vector<size_t> segFirst, segEnd, segWarmUp;
+
+         /// state of each segment after its warm-up, and at its end
+        std::vector< std::vector<char> > startStates, endStates;
+
+        std::vector< std::vector<double> > output;
+        std::vector< std::vector<double> > seqOutput;
+
+        std::vector<char> finalState;
+
+    };  // End of class 'SegmentedRun'
+
+}  // End of namespace gnssSpace
+
+#endif   // SegmentedRun_HPP
@@ -0,0 +1,468 @@
+/**
+ * @file SppEngine.cpp
+ * Single point positioning of an epoch with the Gauss-Newton iterations
+ * done on arrays: what does not depend on the receiver position is
+ * computed once per epoch, and the iterations start from the solution of
+ * the epoch before.
+ */
+
+#include <cmath>
+#include <iomanip>
+
+#include <Eigen/Eigen>
+
+#include "SppEngine.hpp"
+#include "CivilTime.hpp"
+#include "constants.hpp"
+#include "MiscMath.hpp"
+#include "DataStructures.hpp"
+
+using namespace std;
+using namespace timeSpace;
+using namespace Eigen;
+
+namespace gnssSpace
+{
+
+      // code types of the systems: the one for the transmit time, the
+      // two of the equations, and their prefits
+    static const int numSys(3);
+
+    static const TypeID::ValueType pcTypes[numSys] =
+        { TypeID::PC12G, TypeID::PC15E, TypeID::PC26C };
+
+    static const TypeID::ValueType code1Types[numSys] =
+        { TypeID::C1G, TypeID::C1E, TypeID::C2C };
+    static const TypeID::ValueType code2Types[numSys] =
+        { TypeID::C2G, TypeID::C5E, TypeID::C6C };
+
+    static const TypeID::ValueType prefit1Types[numSys] =
+        { TypeID::prefitC1G, TypeID::prefitC1E, TypeID::prefitC2C };
+    static const TypeID::ValueType prefit2Types[numSys] =
+        { TypeID::prefitC2G, TypeID::prefitC5E, TypeID::prefitC6C };
+
+    static const TypeID::ValueType clockTypes[numSys] =
+        { TypeID::dcdtGPS, TypeID::dcdtGAL, TypeID::dcdtBDS };
+
+      // ratio of the ionospheric delays of the second and first code
+    static const double gammas[numSys] =
+        { GAMMA_GPS_L1L2, GAMMA_GAL_L1L5, GAMMA_BDS_L2L6 };
+
+
+      // index of the system in the tables above, -1 if not processed
+    static int sysIndex(const SatelliteSystem& sys)
+    {
+        if(sys.system == SatelliteSystem::GPS)     return 0;
+        if(sys.system == SatelliteSystem::Galileo) return 1;
+        if(sys.system == SatelliteSystem::BDS)     return 2;
+        return -1;
+    }
+
+
+      // Return a string identifying this object.
+    std::string SppEngine::getClassName() const
+    { return "SppEngine"; }
+
+
+      // Clock of a system (m) at the last epoch, 0 if not estimated
+    double SppEngine::getClock(const SatelliteSystem& sys) const
+    {
+        int s( sysIndex(sys) );
+        return (s < 0) ? 0.0 : clock[s];
+    }
+
+
+      /* Take the satellites of the epoch apart into arrays.
+       *
+       * The transmit time, orbit, clock and relativity are computed as in
+       * ComputeSatPos, from the PC combination, but the position is kept
+       * before the Earth rotation, which depends on the receiver position
+       * and is applied at each iteration.
+       */
+    void SppEngine::loadEpoch(Rx3ObsData& rxData)
+        noexcept(false)
+    {
+        sats.clear();
+        sys.clear();
+        svX0.clear(); svY0.clear(); svZ0.clear();
+        cdtSat.clear(); relativity.clear();
+        code1.clear(); code2.clear(); gravDelay.clear();
+
+        for(satTypeValueMap::iterator it = rxData.stvData.begin();
+            it != rxData.stvData.end();
+            ++it)
+        {
+            const SatID& sat( (*it).first );
+
+            int s( sysIndex(sat) );
+            if(s < 0) continue;
+
+            const double* pPC( (*it).second.tryGet(pcTypes[s]) );
+            const double* pC1( (*it).second.tryGet(code1Types[s]) );
+            const double* pC2( (*it).second.tryGet(code2Types[s]) );
+
+            // a single code is absorbed by the ionospheric delay
+            if(pPC == NULL || pC1 == NULL || pC2 == NULL) continue;
+
+            Xvt svPosVel;
+            try
+            {
+                CommonTime transmit( rxData.currEpoch );
+                transmit -= (*pPC)/C_MPS;
+
+                CommonTime tt( transmit );
+                for(int i=0; i<2; i++)
+                {
+                    svPosVel = pEphStore->getXvt(sat, tt);
+
+                    tt = transmit;
+                    tt -= (svPosVel.clkbias + svPosVel.relcorr);
+                }
+            }
+            catch(InvalidRequest& e)
+            {
+                continue;
+            }
+
+            const double* pGrav( (*it).second.tryGet(TypeID::gravDelay) );
+
+            sats.push_back(sat);
+            sys.push_back(s);
+            svX0.push_back(svPosVel.x[0]);
+            svY0.push_back(svPosVel.x[1]);
+            svZ0.push_back(svPosVel.x[2]);
+
+            // the relativity is a scalar product of position and velocity,
+            // the Earth rotation doesn't change it
+            cdtSat.push_back( svPosVel.getClockBias()*C_MPS );
+            relativity.push_back( svPosVel.computeRelativityCorrection()*C_MPS );
+
+            code1.push_back(*pC1);
+            code2.push_back(*pC2);
+            gravDelay.push_back( (pGrav == NULL) ? 0.0 : *pGrav );
+        }
+
+        size_t n( sats.size() );
+        svX.resize(n); svY.resize(n); svZ.resize(n);
+        rho.resize(n);
+        dXVec.resize(n); dYVec.resize(n); dZVec.resize(n);
+        elevVec.resize(n); azimVec.resize(n);
+        tropo.resize(n); prefit1.resize(n); prefit2.resize(n);
+        valid.resize(n);
+        used.assign(n, 1);
+
+    }  // End of method 'SppEngine::loadEpoch()'
+
+
+      /* One Gauss-Newton step from pos.
+       *
+       * The two code equations of a satellite share its ionospheric
+       * delay; eliminating it leaves
+       *
+       *    (gamma*p1 - p2)/(gamma - 1) = geometry + receiver clock
+       *
+       * with the weight (gamma-1)^2/(1+gamma^2), and the normal equations
+       * of these are those of the position and clocks of LsqSPP.
+       */
+    bool SppEngine::iterate( const CommonTime& time, const Triple& pos,
+                             bool useMask, Triple& dx )
+    {
+        int n( sats.size() );
+        if(n == 0) return false;
+
+        // Earth rotation during the signal travel, as
+        // ComputeSatPos::rotateEarth()
+        for(int i=0; i<n; i++)
+        {
+            double dt( RSS( svX0[i] - pos[0],
+                            svY0[i] - pos[1],
+                            svZ0[i] - pos[2] ) / C_MPS );
+            double wt( OMEGA_EARTH*dt );
+            double c( std::cos(wt) ), s( std::sin(wt) );
+
+            svX[i] =  c*svX0[i] + s*svY0[i];
+            svY[i] = -s*svX0[i] + c*svY0[i];
+            svZ[i] =  svZ0[i];
+        }
+
+        geometry.setReceiver( Position(pos) );
+        geometry.compute( n, &svX[0], &svY[0], &svZ[0],
+                          &rho[0], &dXVec[0], &dYVec[0], &dZVec[0],
+                          &elevVec[0], &azimVec[0], &valid[0] );
+
+        if(useMask && pTropModel != NULL)
+        {
+            computeTrop.setAllParameters( time, Position(pos) );
+        }
+
+        // normal equations of dx, dy, dz and the clocks of the systems
+        Matrix<double, 3+numSys, 3+numSys> nMatrix;
+        Matrix<double, 3+numSys, 1> nVector;
+        nMatrix.setZero();
+        nVector.setZero();
+
+        int numUsed(0);
+        bool haveSys[numSys] = { false, false, false };
+
+        for(int i=0; i<n; i++)
+        {
+            if(!used[i]) continue;
+
+            double tropoCorr(0.0);
+            if(useMask)
+            {
+                // rejected for the rest of the epoch, as the chain
+                // removes the satellite from the data
+                if( !valid[i] || elevVec[i] < minElev )
+                {
+                    used[i] = 0;
+                    continue;
+                }
+
+                if(pTropModel != NULL)
+                {
+                    try
+                    {
+                        tropoCorr = pTropModel->correction(elevVec[i]);
+                        if( !(pTropModel->isValid()) ) tropoCorr = 0.0;
+                    }
+                    catch(InvalidTropModel& e)
+                    {
+                        used[i] = 0;
+                        continue;
+                    }
+                }
+            }
+            tropo[i] = tropoCorr;
+
+            double common( -rho[i] + cdtSat[i] + relativity[i]
+                           - gravDelay[i] - tropoCorr );
+            prefit1[i] = code1[i] + common;
+            prefit2[i] = code2[i] + common;
+
+            int s( sys[i] );
+            double gamma( gammas[s] );
+            double pIF( (gamma*prefit1[i] - prefit2[i])/(gamma - 1.0) );
+            double w( (gamma - 1.0)*(gamma - 1.0)/(1.0 + gamma*gamma) );
+
+            double h[3+numSys] = { dXVec[i], dYVec[i], dZVec[i],
+                                   0.0, 0.0, 0.0 };
+            h[3+s] = 1.0;
+
+            for(int r=0; r<3+numSys; r++)
+            {
+                if(h[r] == 0.0) continue;
+                nVector(r) += w*h[r]*pIF;
+                for(int c=0; c<3+numSys; c++)
+                {
+                    nMatrix(r, c) += w*h[r]*h[c];
+                }
+            }
+
+            haveSys[s] = true;
+            numUsed++;
+        }
+
+        // the clocks of the systems not seen are not estimated
+        int numUnknowns(3);
+        for(int s=0; s<numSys; s++)
+        {
+            if(haveSys[s])
+            {
+                numUnknowns++;
+            }
+            else
+            {
+                nMatrix(3+s, 3+s) = 1.0;
+            }
+        }
+
+        if(numUsed < numUnknowns) return false;
+
+        LDLT< Matrix<double, 3+numSys, 3+numSys> > ldlt(nMatrix);
+        if(ldlt.info() != Success) return false;
+
+        Matrix<double, 3+numSys, 1> solution( ldlt.solve(nVector) );
+        if( !solution.allFinite() ) return false;
+
+        dx = Triple( solution(0), solution(1), solution(2) );
+        for(int s=0; s<numSys; s++)
+        {
+            clock[s] = haveSys[s] ? solution(3+s) : 0.0;
+        }
+
+        numSatsUsed = numUsed;
+
+        return true;
+
+    }  // End of method 'SppEngine::iterate()'
+
+
+      /* Write the model of the satellites used into rxData, with the
+       * types the "model" chain of spp writes, and remove the others.
+       */
+    void SppEngine::storeEpoch(Rx3ObsData& rxData)
+    {
+        SatIDSet satRejectedSet;
+
+        size_t i(0);
+        for(satTypeValueMap::iterator it = rxData.stvData.begin();
+            it != rxData.stvData.end();
+            ++it)
+        {
+            const SatID& sat( (*it).first );
+
+            // both are in the order of the map
+            if( i >= sats.size() || !(sats[i] == sat) )
+            {
+                satRejectedSet.insert(sat);
+                continue;
+            }
+
+            if( !used[i] )
+            {
+                satRejectedSet.insert(sat);
+                i++;
+                continue;
+            }
+
+            typeValueMap& tv( (*it).second );
+            int s( sys[i] );
+
+            tv[TypeID::satXECEF] = svX[i];
+            tv[TypeID::satYECEF] = svY[i];
+            tv[TypeID::satZECEF] = svZ[i];
+
+            // warning: the sign is changed, as in ComputeSatPos
+            tv[TypeID::relativity] = -relativity[i];
+            tv[TypeID::cdtSat] = cdtSat[i];
+
+            tv[TypeID::rho] = rho[i];
+            tv[TypeID::dX] = dXVec[i];
+            tv[TypeID::dY] = dYVec[i];
+            tv[TypeID::dZ] = dZVec[i];
+            tv[TypeID::cdt] = 1.0;
+            tv[clockTypes[s]] = 1.0;
+            tv[TypeID::elevation] = elevVec[i];
+            tv[TypeID::azimuth] = azimVec[i];
+
+            tv[TypeID::tropoSlant] = tropo[i];
+
+            tv[prefit1Types[s]] = prefit1[i];
+            tv[prefit2Types[s]] = prefit2[i];
+
+            i++;
+        }
+
+        rxData.stvData.removeSatID(satRejectedSet);
+
+    }  // End of method 'SppEngine::storeEpoch()'
+
+
+      /* Compute the position of the epoch.
+       *
+       * @param rxData   Data of the epoch, after the PC combinations
+       */
+    Rx3ObsData& SppEngine::Process(Rx3ObsData& rxData)
+        noexcept(false)
+    {
+        if(pEphStore == NULL)
+        {
+            InvalidRequest e( getClassName() + ": the ephemeris store must "
+                              "be given" );
+            THROW(e);
+        }
+
+        try
+        {
+            loadEpoch(rxData);
+
+            // far from the solution, no mask and no troposphere
+            bool useMask( haveStart );
+
+            Triple pos( haveStart ? rxPos : Triple(0.0, 0.0, 0.0) );
+
+            bool done(false);
+            int iter(0);
+            while(iter < maxIterations)
+            {
+                Triple dx;
+                if( !iterate(rxData.currEpoch, pos, useMask, dx) )
+                {
+                    SVNumException e( getClassName() + ": not enough "
+                                      "satellites at "
+                                      + CivilTime(rxData.currEpoch)
+                                            .asString() );
+                    THROW(e);
+                }
+
+                pos = pos + dx;
+                iter++;
+
+                double correction( dx.mag() );
+                if(useMask && correction < convergence)
+                {
+                    done = true;
+                    break;
+                }
+
+                // close enough for the mask: the iterations start again
+                if(!useMask && correction < 1000.0)
+                {
+                    useMask = true;
+                }
+            }
+
+            storeEpoch(rxData);
+
+            rxPos = pos;
+            haveStart = true;
+
+            numIterations = iter;
+            converged = done;
+            iterStats[iter]++;
+
+            return rxData;
+        }
+        catch(SVNumException& u)
+        {
+            THROW(u);
+        }
+        catch(Exception& u)
+        {
+            ProcessingException e( getClassName() + ":" + u.what() );
+            THROW(e);
+        }
+
+    }  // End of method 'SppEngine::Process()'
+
+
+      // Print how many iterations the epochs took
+    void SppEngine::dumpStats(std::ostream& s) const
+    {
+        s << " iterations    epochs" << endl;
+
+        int numEpochs(0), total(0);
+        for(std::map<int, int>::const_iterator it = iterStats.begin();
+            it != iterStats.end();
+            ++it)
+        {
+            s << setw(11) << (*it).first << setw(10) << (*it).second << endl;
+
+            numEpochs += (*it).second;
+            total += (*it).first * (*it).second;
+        }
+
+        s << " " << numEpochs << " epochs, "
+          << fixed << setprecision(2)
+          << (numEpochs > 0 ? double(total)/numEpochs : 0.0)
+          << " iterations per epoch" << endl;
+
+        if(computeTrop.getCacheHits() + computeTrop.getCacheMisses() > 0)
+        {
+            computeTrop.dumpCacheStats(s);
+        }
+
+    }  // End of method 'SppEngine::dumpStats()'
+
+}  // End of namespace gnssSpace
@@ -0,0 +1,254 @@
+/**
+ * @file SppEngine.hpp
+ * Single point positioning of an epoch with the Gauss-Newton iterations
+ * done on arrays: what does not depend on the receiver position is
+ * computed once per epoch, and the iterations start from the solution of
+ * the epoch before.
+ */
+
+#ifndef SppEngine_HPP
+#define SppEngine_HPP
+
+#include <map>
+#include <vector>
+#include <ostream>
+
+#include "Exception.hpp"
+#include "XvtStore.hpp"
+#include "Position.hpp"
+#include "Triple.hpp"
+#include "TropModel.hpp"
+#include "ComputeTropModel.hpp"
+#include "Rx3ObsData.hpp"
+#include "SatGeometry.hpp"
+
+using namespace utilSpace;
+using namespace coordSpace;
+using namespace mathSpace;
+
+namespace gnssSpace
+{
+
+      /** Single point positioning, with the model of the "model" chain
+       *  of spp (ComputeSatPos, ComputeDerivative, ComputeTropModel, the
+       *  prefit combinations) and the solution of LsqSPP, in one object.
+       *
+       * The spp loop runs the whole chain at each iteration, and LsqSPP
+       * prepares its equation system anew each time. Here the epoch is
+       * taken apart once into arrays:
+       *
+       *  - per epoch: the transmit time, orbit, clock and relativity of
+       *    each satellite (from the PC combination, as ComputeSatPos),
+       *    the code observables and the gravitational delay;
+       *  - per iteration: the Earth rotation during the signal travel,
+       *    the geometry (SatGeometry), the troposphere, the prefits and
+       *    the solution.
+       *
+       * The slant ionospheric delay of a satellite, estimated by LsqSPP
+       * from its two codes, is eliminated beforehand: what is left of the
+       * two equations is the ionosphere-free one, weighted by
+       * (gamma-1)^2/(1+gamma^2). The normal equations only have the
+       * position and one clock per system, and give the LsqSPP solution.
+       * Satellites with a single code don't take part, as in LsqSPP,
+       * where their ionospheric delay absorbs the code.
+       *
+       * The iterations start from the solution of the epoch before, or
+       * from the a priori position for the first one, and stop when the
+       * correction is below the convergence threshold (1 cm), or after
+       * the largest number of iterations (6), as in spp. With the warm
+       * start, one or two are usually enough; how many each epoch takes
+       * is kept, see getNumIterations() and dumpStats(). Without an a
+       * priori position, the first epoch starts from the center of the
+       * Earth, with neither elevation mask nor troposphere until the
+       * correction is below 1 km.
+       *
+       * @code
+       *   SppEngine engine(navStore);
+       *   engine.setTropModel(neillTM)
+       *         .setApriori(rxHeader.antennaPosition);
+       *
+       *   while( ... )   // epochs after "preprocess"
+       *   {
+       *      engine.Process(rxData);
+       *      printSols.printRecord( rxData.currEpoch, rxData.numSats(),
+       *                             engine.getRxPos() );
+       *   }
+       *   engine.dumpStats(cout);
+       * @endcode
+       *
+       * After Process(), rxData holds the satellites used, with the values
+       * the "model" chain writes (satellite position and clock,
+       * relativity, rho, partials, elevation, azimuth, troposphere and
+       * prefits) at the last position.
+       *
+       * GPS, Galileo and BDS are processed; satellites of other systems
+       * are removed, as LsqSPP has no equations for them.
+       */
+    class SppEngine
+    {
+    public:
+
+         /// Default constructor
+        SppEngine()
+            : pEphStore(NULL), pTropModel(NULL),
+              minElev(10.0), maxIterations(6), convergence(0.01),
+              haveStart(false), numIterations(0), converged(false),
+              numSatsUsed(0)
+        { clock[0] = clock[1] = clock[2] = 0.0; };
+
+
+         /// Constructor, with the store of the orbits and clocks
+        SppEngine(XvtStore<SatID>& ephStore)
+            : pEphStore(&ephStore), pTropModel(NULL),
+              minElev(10.0), maxIterations(6), convergence(0.01),
+              haveStart(false), numIterations(0), converged(false),
+              numSatsUsed(0)
+        { clock[0] = clock[1] = clock[2] = 0.0; };
+
+
+         /// Store of the orbits and clocks
+        virtual SppEngine& setEphStore(XvtStore<SatID>& ephStore)
+        { pEphStore = &ephStore; return (*this); };
+
+         /// Tropospheric model; without one, no troposphere is modeled
+        virtual SppEngine& setTropModel(TropModel& tropModel)
+        { pTropModel = &tropModel; computeTrop.setTropModel(tropModel);
+          return (*this); };
+
+         /// Keep the parameters of the tropospheric model from one
+         /// iteration and epoch to the next, see ComputeTropModel::setCache()
+        virtual SppEngine& setTropCache(bool use)
+        { computeTrop.setCache(use); return (*this); };
+
+         /// Elevation cut-off, in degrees (10 by default)
+        virtual SppEngine& setMinElev(double elev)
+        { minElev = elev; return (*this); };
+
+         /// Largest number of iterations of an epoch (6 by default)
+        virtual SppEngine& setMaxIterations(int num)
+        { maxIterations = num; return (*this); };
+
+         /// Correction (m) below which the iterations stop (0.01 by default)
+        virtual SppEngine& setConvergence(double threshold)
+        { convergence = threshold; return (*this); };
+
+         /** Position the next epoch starts from, e.g. the one of the
+          *  RINEX header; the epochs after start from the solution of
+          *  the one before.
+          */
+        virtual SppEngine& setApriori(const Triple& pos)
+        { rxPos = pos; haveStart = true; return (*this); };
+
+
+         /** Compute the position of the epoch.
+          *
+          * @throw InvalidRequest if the ephemeris store is not given
+          * @throw SVNumException if there are not enough satellites for
+          *        a solution; the start of the next epoch is unchanged
+          */
+        virtual Rx3ObsData& Process(Rx3ObsData& rxData)
+            noexcept(false);
+
+
+         /// Position of the last epoch
+        virtual Triple getRxPos() const
+        { return rxPos; };
+
+         /// Clock of a system (m) at the last epoch, 0 if not estimated
+        virtual double getClock(const SatelliteSystem& sys) const;
+
+         /// Iterations of the last epoch
+        virtual int getNumIterations() const
+        { return numIterations; };
+
+         /// Whether the last epoch converged before the largest number of
+         /// iterations
+        virtual bool isConverged() const
+        { return converged; };
+
+         /// Satellites used in the solution of the last epoch
+        virtual int getNumSatsUsed() const
+        { return numSatsUsed; };
+
+         /// Number of epochs solved with each number of iterations
+        virtual const std::map<int, int>& getIterationStats() const
+        { return iterStats; };
+
+         /// Print how many iterations the epochs took, and the hits of
+         /// the troposphere cache
+        virtual void dumpStats(std::ostream& s) const;
+
+
+         /// Return a string identifying this object.
+        virtual std::string getClassName(void) const;
+
+         /// Destructor.
+        virtual ~SppEngine() {};
+
+    private:
+
+         /// Take the satellites of the epoch apart into arrays, with
+         /// what doesn't depend on the receiver position
+        void loadEpoch(Rx3ObsData& rxData)
+            noexcept(false);
+
+         /** One Gauss-Newton step from pos: geometry, troposphere and
+          *  prefits at pos, and the solution of the normal equations.
+          *
+          *  Without useMask (while the position is far from the solution)
+          *  neither the elevation mask nor the troposphere are applied,
+          *  and no satellite is rejected.
+          *
+          * @return false if there are not enough satellites
+          */
+        bool iterate( const CommonTime& time, const Triple& pos,
+                      bool useMask, Triple& dx );
+
+         /// Write the model of the satellites used into rxData, and
+         /// remove the others
+        void storeEpoch(Rx3ObsData& rxData);
+
+
+        XvtStore<SatID>* pEphStore;
+        TropModel* pTropModel;
+
+        double minElev;
+        int maxIterations;
+        double convergence;
+
+         /// Position the next epoch starts from, and the one of the last
+         /// epoch after Process()
+        Triple rxPos;
+        bool haveStart;
+
+        int numIterations;
+        bool converged;
+        int numSatsUsed;
+
+        std::map<int, int> iterStats;
+
+         /// Clocks of the systems at the last iteration (m)
+        double clock[3];
+
+         /// Satellites of the epoch and what doesn't change over the
+         /// iterations; sys is 0 (GPS), 1 (Galileo) or 2 (BDS)
+        std::vector<SatID> sats;
+        std::vector<int> sys;
+        std::vector<double> svX0, svY0, svZ0;      ///< at transmit time
+        std::vector<double> cdtSat, relativity;   ///< as ComputeSatPos (m)
+        std::vector<double> code1, code2, gravDelay;
+
+         /// Per iteration
+        std::vector<double> svX, svY, svZ;
+        std::vector<double> rho, dXVec, dYVec, dZVec, elevVec, azimVec;
+        std::vector<double> tropo, prefit1, prefit2;
+        std::vector<char> valid, used;
+
+        SatGeometry geometry;
+        ComputeTropModel computeTrop;
+
+    }; // End of class 'SppEngine'
+
+}  // End of namespace gnssSpace
+
+#endif   // SppEngine_HPP
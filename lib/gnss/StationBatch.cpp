@@ -0,0 +1,162 @@
+/**
+ * @file StationBatch.cpp
+ * Processing of many stations in one process, several at a time, with
+ * the ephemeris and the other read-only data loaded once for all.
+ */
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <exception>
+#include <system_error>
+
+#include "EpochArena.hpp"
+#include "StationBatch.hpp"
+
+using namespace std;
+
+namespace gnssSpace
+{
+
+      // Seconds since 'begin' on a steady clock: Counter::now() is the CPU
+      // time of the process without OpenMP, which adds up the threads
+    static double secondsSince(const std::chrono::steady_clock::time_point& begin)
+    {
+        return std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - begin ).count();
+    }
+
+      // Process a station, filling its report
+    void StationBatch::processStation(size_t index, int thread)
+    {
+        StationReport& rep( reports[index] );
+        rep.station = stations[index];
+        rep.ok = false;
+        rep.thread = thread;
+
+        std::chrono::steady_clock::time_point begin(
+            std::chrono::steady_clock::now() );
+        try
+        {
+            stationFunction(index, stations[index]);
+            rep.ok = true;
+        }
+        catch(Exception& u)
+        {
+            rep.error = u.getText();
+        }
+        catch(std::exception& u)
+        {
+            rep.error = u.what();
+        }
+        catch(...)
+        {
+            rep.error = "unknown exception";
+        }
+        rep.seconds = secondsSince(begin);
+
+        // the next station on this thread starts with an empty arena
+        EpochArena::local().reset();
+
+    }  // End of method 'StationBatch::processStation()'
+
+
+      // Process all the stations
+    void StationBatch::run()
+        noexcept(false)
+    {
+        if(!stationFunction)
+        {
+            InvalidRequest e( "StationBatch: the station function must be "
+                              "given" );
+            THROW(e);
+        }
+
+        reports.assign(stations.size(), StationReport());
+
+        size_t threads( numThreads > 0 ? numThreads
+                                       : std::thread::hardware_concurrency() );
+        threads = std::max<size_t>( 1, std::min(threads, stations.size()) );
+
+        std::chrono::steady_clock::time_point begin(
+            std::chrono::steady_clock::now() );
+
+        // the threads take the stations in the order of the list, each
+        // one the next as soon as it is done with its own
+        std::atomic<size_t> next(0);
+        std::function<void(int)> worker = [&](int thread)
+        {
+            while(true)
+            {
+                size_t i( next.fetch_add(1) );
+                if(i >= stations.size()) break;
+                processStation(i, thread);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for(size_t t=1; t<threads; t++)
+        {
+            try
+            {
+                pool.push_back( std::thread(worker, int(t)) );
+            }
+            catch(std::system_error& e)
+            {
+                // no more threads: go on with those there are
+                break;
+            }
+        }
+
+        worker(0);
+
+        for(size_t t=0; t<pool.size(); t++)
+        {
+            pool[t].join();
+        }
+
+        seconds = secondsSince(begin);
+
+    }  // End of method 'StationBatch::run()'
+
+
+      // Number of stations of the last run() stopped by an exception
+    size_t StationBatch::numFailed() const
+    {
+        size_t num(0);
+        for(size_t i=0; i<reports.size(); i++)
+        {
+            if(!reports[i].ok) num++;
+        }
+        return num;
+
+    }  // End of method 'StationBatch::numFailed()'
+
+
+      // Print the reports of the last run()
+    void StationBatch::dumpReport(std::ostream& s) const
+    {
+        s << " station                      thread   seconds  result" << endl;
+
+        double busy(0.0);
+        for(size_t i=0; i<reports.size(); i++)
+        {
+            const StationReport& rep( reports[i] );
+            s << " " << left << setw(28) << rep.station << right
+              << setw(7) << rep.thread
+              << setw(10) << fixed << setprecision(3) << rep.seconds
+              << "  " << (rep.ok ? "ok" : rep.error)
+              << endl;
+
+            busy += rep.seconds;
+        }
+
+        s << " " << reports.size() << " stations, " << numFailed()
+          << " failed, in " << fixed << setprecision(3) << seconds
+          << " s (" << busy << " s of station time)" << endl;
+
+    }  // End of method 'StationBatch::dumpReport()'
+
+}  // End of namespace gnssSpace
@@ -0,0 +1,158 @@
+/**
+ * @file StationBatch.hpp
+ * Processing of many stations in one process, several at a time, with
+ * the ephemeris and the other read-only data loaded once for all.
+ */
+
+#ifndef StationBatch_HPP
+#define StationBatch_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <functional>
+
+#include "Exception.hpp"
+
+using namespace utilSpace;
+
+namespace gnssSpace
+{
+
+      /** Processing of a list of stations on several threads.
+       *
+       * Each station is processed by the station function, on one thread,
+       * from the first epoch to the last; the stations are tasks taken by
+       * the threads as they become free, so a long station does not hold
+       * back the others. The function builds its own processing objects
+       * (they keep the state of the station) and may share the objects it
+       * only reads, e.g. an Rx3NavStore or SP3EphStore loaded beforehand,
+       * and the tables of LinearCombinations.
+       *
+       * The library keeps no state shared by the stations: the processing
+       * objects keep theirs as members, EpochArena and the time counters
+       * of Counter are per thread, and the stores are not changed by the
+       * lookups, except SP3EpochStore, which keeps the epoch of the last
+       * one and must be built by each station. The stores must not be
+       * loaded or changed while run() is going on.
+       *
+       * An exception of a station stops that station only; it is kept in
+       * the report of the station, and the others go on.
+       *
+       * The threads are std::thread, not OpenMP ones: ThreadSanitizer
+       * sees how they synchronize, but not how the threads of libgomp do,
+       * so a batch can be checked for races with -fsanitize=thread
+       * (the USE_TSAN option of CMake, see batch_test).
+       *
+       * @code
+       *   Rx3NavStore navStore;
+       *   navStore.loadFile(navFile);
+       *
+       *   StationBatch batch;
+       *   batch.setStations(obsFiles)
+       *        .setStationFunction( [&](size_t i, const std::string& obsFile)
+       *        {
+       *            ComputeSatPos computeSatPos(navStore);
+       *            ...   // read and process obsFile
+       *        } );
+       *   batch.run();
+       *   batch.dumpReport(cout);
+       * @endcode
+       */
+    class StationBatch
+    {
+    public:
+
+         /** Process the station 'station', the 'index'-th of the list. It
+          *  is called from several threads at once, for different
+          *  stations.
+          */
+        typedef std::function<void(size_t index, const std::string& station)> StationFunction;
+
+
+         /// What happened to a station in run()
+        struct StationReport
+        {
+            std::string station;
+
+            bool ok;              ///< processed without exception
+            std::string error;    ///< what the exception said, if not ok
+
+            double seconds;       ///< wall-clock time of the station function
+            int thread;           ///< thread it ran on
+        };
+
+
+         /// Default constructor: one thread per core
+        StationBatch()
+            : numThreads(0), seconds(0.0)
+        {};
+
+
+         /// Stations to process, e.g. the names of their observation files
+        virtual StationBatch& setStations(const std::vector<std::string>& list)
+        { stations = list; return (*this); };
+
+         /// Add a station to process
+        virtual StationBatch& addStation(const std::string& station)
+        { stations.push_back(station); return (*this); };
+
+         /// Function processing a station
+        virtual StationBatch& setStationFunction(StationFunction function)
+        { stationFunction = function; return (*this); };
+
+         /// Number of threads; 0 (the default) for one per core
+        virtual StationBatch& setThreads(int num)
+        { numThreads = num; return (*this); };
+
+
+         /** Process all the stations.
+          *
+          * @throw InvalidRequest if the station function is missing.
+          *        The exceptions of the stations are not thrown again,
+          *        see getReports().
+          */
+        virtual void run()
+            noexcept(false);
+
+
+         /// Stations of the list
+        virtual const std::vector<std::string>& getStations() const
+        { return stations; };
+
+         /// Reports of the last run(), in the order of the list
+        virtual const std::vector<StationReport>& getReports() const
+        { return reports; };
+
+         /// Number of stations of the last run() stopped by an exception
+        virtual size_t numFailed() const;
+
+         /// Wall-clock time of the last run()
+        virtual double getSeconds() const
+        { return seconds; };
+
+         /// Print the reports of the last run()
+        virtual void dumpReport(std::ostream& s) const;
+
+
+         /// Destructor
+        virtual ~StationBatch() {};
+
+    private:
+
+         /// Process a station on the given thread, filling its report
+        void processStation(size_t index, int thread);
+
+        std::vector<std::string> stations;
+        StationFunction stationFunction;
+
+        int numThreads;
+
+        std::vector<StationReport> reports;
+        double seconds;
+
+    };  // End of class 'StationBatch'
+
+}  // End of namespace gnssSpace
+
+#endif   // StationBatch_HPP
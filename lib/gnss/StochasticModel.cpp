@@ -13,6 +13,8 @@
 //============================================================================
 
 
+#include <stdint.h>
+
 #include "StochasticModel.hpp"
 
 using namespace utilSpace;
@@ -99,13 +101,13 @@ namespace gnssSpace
       /* This method checks if a cycle slip happened.
        *
        * @param sat        Satellite.
-       * @param data       Object holding the data.
+       * @param data       Data of the satellite.
        * @param source     Object holding the source of data.
        *
        */
    void PhaseAmbiguityModel::checkCS( const SourceID& source,
                                       const SatID& sat,
-                                      satTypeValueMap& data
+                                      typeValueMap& data
                                        )
    {
 
@@ -115,20 +117,11 @@ namespace gnssSpace
             // By default, assume there is no cycle slip
          setCS(false);
 
-            // Check if satellite is present at this epoch
-         if( data.find(sat) == data.end() )
-         {
-            // If satellite is not present, declare CS and exit
-            setCS(true);
-
-            return;
-         }
-
          if (!watchSatArc)
          {
                // In this case, we only use cycle slip flags
                // Check if there was a cycle slip
-            if (data(sat)(csFlagType) > 0.0)
+            if (data(csFlagType) > 0.0)
             {
                setCS(true);
             }
@@ -136,19 +129,14 @@ namespace gnssSpace
          }
          else
          {
-            // Check if this satellite has previous entries
-            if( satArcMap[ source ].find(sat) == satArcMap[ source ].end() )
-            {
-                  // If it doesn't have an entry, insert one
-               satArcMap[ source ][ sat ] = 0.0;
-            };
-
+            // Arc number in storage; a new satellite gets 0.0
+            double& satArc( satArcMap[ source ][ sat ] );
 
             // Check if arc number is different than arc number in storage
-            if ( data(sat)(csFlagType) != satArcMap[ source ][ sat ] )
+            if ( data(csFlagType) != satArc )
             {
                setCS(true);
-               satArcMap[ source ][ sat ] = data(sat)(csFlagType);
+               satArc = data(csFlagType);
             }
 
          }
@@ -722,4 +710,335 @@ namespace gnssSpace
    }  // End of method 'IFCBRandomWalkModel::computeQ()'
 
 
+      // Write the state kept from one epoch to the next
+   void RandomWalkModel::saveState(StateWriter& writer) const
+   {
+      writer.beginBlock("RandomWalkModel", 1);
+      writer.putTime(previousTime);
+      writer.putTime(currentTime);
+
+   }  // End of method 'RandomWalkModel::saveState()'
+
+
+      // Restore a state written by saveState()
+   void RandomWalkModel::restoreState(StateReader& reader)
+      noexcept(false)
+   {
+      reader.checkBlock("RandomWalkModel", 1);
+      previousTime = reader.getTime();
+      currentTime = reader.getTime();
+
+   }  // End of method 'RandomWalkModel::restoreState()'
+
+
+
+      // Write the state kept from one epoch to the next
+   void PhaseAmbiguityModel::saveState(StateWriter& writer) const
+   {
+      writer.beginBlock("PhaseAmbiguityModel", 1);
+      writer.put(cycleSlip);
+
+      writer.put( uint32_t(satArcMap.size()) );
+      for( std::map<SourceID, SatStateArray<double> >::const_iterator it
+              = satArcMap.begin();
+           it != satArcMap.end();
+           ++it )
+      {
+         std::vector<SatID> sats( (*it).second.getSats() );
+
+         writer.putSource( (*it).first );
+         writer.put( uint32_t(sats.size()) );
+         for(size_t i=0; i<sats.size(); i++)
+         {
+            writer.putSat( sats[i] );
+            writer.put( (*it).second.at(sats[i]) );
+         }
+      }
+
+   }  // End of method 'PhaseAmbiguityModel::saveState()'
+
+
+      // Restore a state written by saveState()
+   void PhaseAmbiguityModel::restoreState(StateReader& reader)
+      noexcept(false)
+   {
+      reader.checkBlock("PhaseAmbiguityModel", 1);
+      cycleSlip = reader.get<bool>();
+
+      satArcMap.clear();
+      uint32_t numSources( reader.get<uint32_t>() );
+      for(uint32_t s=0; s<numSources; s++)
+      {
+         SatStateArray<double>& satArc( satArcMap[ reader.getSource() ] );
+
+         uint32_t numSats( reader.get<uint32_t>() );
+         for(uint32_t i=0; i<numSats; i++)
+         {
+            SatID sat( reader.getSat() );
+            satArc[sat] = reader.get<double>();
+         }
+      }
+
+   }  // End of method 'PhaseAmbiguityModel::restoreState()'
+
+
+
+      // Write the state kept from one epoch to the next
+   void TropoRandomWalkModel::saveState(StateWriter& writer) const
+   {
+      writer.beginBlock("TropoRandomWalkModel", 1);
+      writer.put( uint32_t(tmData.size()) );
+      for( std::map<SourceID, tropModelData>::const_iterator it = tmData.begin();
+           it != tmData.end();
+           ++it )
+      {
+         writer.putSource( (*it).first );
+         writer.putTime( (*it).second.previousTime );
+         writer.putTime( (*it).second.currentTime );
+      }
+
+   }  // End of method 'TropoRandomWalkModel::saveState()'
+
+
+      // Restore a state written by saveState()
+   void TropoRandomWalkModel::restoreState(StateReader& reader)
+      noexcept(false)
+   {
+      reader.checkBlock("TropoRandomWalkModel", 1);
+      tmData.clear();
+      uint32_t numSources( reader.get<uint32_t>() );
+      for(uint32_t s=0; s<numSources; s++)
+      {
+         tropModelData& data( tmData[ reader.getSource() ] );
+         data.previousTime = reader.getTime();
+         data.currentTime = reader.getTime();
+      }
+
+   }  // End of method 'TropoRandomWalkModel::restoreState()'
+
+
+
+      // Write the state kept from one epoch to the next
+   void TropoGradRandomWalkModel::saveState(StateWriter& writer) const
+   {
+      writer.beginBlock("TropoGradRandomWalkModel", 1);
+      writer.put( uint32_t(gmData.size()) );
+      for( std::map<SourceID, tropGradModelData>::const_iterator it = gmData.begin();
+           it != gmData.end();
+           ++it )
+      {
+         writer.putSource( (*it).first );
+         writer.putTime( (*it).second.previousTime );
+         writer.putTime( (*it).second.currentTime );
+      }
+
+   }  // End of method 'TropoGradRandomWalkModel::saveState()'
+
+
+      // Restore a state written by saveState()
+   void TropoGradRandomWalkModel::restoreState(StateReader& reader)
+      noexcept(false)
+   {
+      reader.checkBlock("TropoGradRandomWalkModel", 1);
+      gmData.clear();
+      uint32_t numSources( reader.get<uint32_t>() );
+      for(uint32_t s=0; s<numSources; s++)
+      {
+         tropGradModelData& data( gmData[ reader.getSource() ] );
+         data.previousTime = reader.getTime();
+         data.currentTime = reader.getTime();
+      }
+
+   }  // End of method 'TropoGradRandomWalkModel::restoreState()'
+
+
+
+      // Write the state kept from one epoch to the next
+   void IonoRandomWalkModel::saveState(StateWriter& writer) const
+   {
+      writer.beginBlock("IonoRandomWalkModel", 1);
+      std::vector<SatID> sats( imData.getSats() );
+
+      writer.put( uint32_t(sats.size()) );
+      for(size_t i=0; i<sats.size(); i++)
+      {
+         writer.putSat( sats[i] );
+         writer.putTime( imData.at(sats[i]).previousTime );
+         writer.putTime( imData.at(sats[i]).currentTime );
+      }
+
+   }  // End of method 'IonoRandomWalkModel::saveState()'
+
+
+      // Restore a state written by saveState()
+   void IonoRandomWalkModel::restoreState(StateReader& reader)
+      noexcept(false)
+   {
+      reader.checkBlock("IonoRandomWalkModel", 1);
+      imData.clear();
+      uint32_t numSats( reader.get<uint32_t>() );
+      for(uint32_t i=0; i<numSats; i++)
+      {
+         ionoModelData& data( imData[ reader.getSat() ] );
+         data.previousTime = reader.getTime();
+         data.currentTime = reader.getTime();
+      }
+
+   }  // End of method 'IonoRandomWalkModel::restoreState()'
+
+
+
+      // Write the state kept from one epoch to the next
+   void RecBiasRandomWalkModel::saveState(StateWriter& writer) const
+   {
+      writer.beginBlock("RecBiasRandomWalkModel", 1);
+      writer.put( uint32_t(rbData.size()) );
+      for( std::map<SourceID, recBiasModelData>::const_iterator it = rbData.begin();
+           it != rbData.end();
+           ++it )
+      {
+         writer.putSource( (*it).first );
+         writer.putTime( (*it).second.previousTime );
+         writer.putTime( (*it).second.currentTime );
+      }
+
+   }  // End of method 'RecBiasRandomWalkModel::saveState()'
+
+
+      // Restore a state written by saveState()
+   void RecBiasRandomWalkModel::restoreState(StateReader& reader)
+      noexcept(false)
+   {
+      reader.checkBlock("RecBiasRandomWalkModel", 1);
+      rbData.clear();
+      uint32_t numSources( reader.get<uint32_t>() );
+      for(uint32_t s=0; s<numSources; s++)
+      {
+         recBiasModelData& data( rbData[ reader.getSource() ] );
+         data.previousTime = reader.getTime();
+         data.currentTime = reader.getTime();
+      }
+
+   }  // End of method 'RecBiasRandomWalkModel::restoreState()'
+
+
+
+      // Write the state kept from one epoch to the next
+   void SatBiasRandomWalkModel::saveState(StateWriter& writer) const
+   {
+      writer.beginBlock("SatBiasRandomWalkModel", 1);
+      std::vector<SatID> sats( sbData.getSats() );
+
+      writer.put( uint32_t(sats.size()) );
+      for(size_t i=0; i<sats.size(); i++)
+      {
+         writer.putSat( sats[i] );
+         writer.putTime( sbData.at(sats[i]).previousTime );
+         writer.putTime( sbData.at(sats[i]).currentTime );
+      }
+
+   }  // End of method 'SatBiasRandomWalkModel::saveState()'
+
+
+      // Restore a state written by saveState()
+   void SatBiasRandomWalkModel::restoreState(StateReader& reader)
+      noexcept(false)
+   {
+      reader.checkBlock("SatBiasRandomWalkModel", 1);
+      sbData.clear();
+      uint32_t numSats( reader.get<uint32_t>() );
+      for(uint32_t i=0; i<numSats; i++)
+      {
+         satBiasModelData& data( sbData[ reader.getSat() ] );
+         data.previousTime = reader.getTime();
+         data.currentTime = reader.getTime();
+      }
+
+   }  // End of method 'SatBiasRandomWalkModel::restoreState()'
+
+
+
+      // Write the state kept from one epoch to the next
+   void ISBRandomWalkModel::saveState(StateWriter& writer) const
+   {
+      writer.beginBlock("ISBRandomWalkModel", 1);
+      writer.put( uint32_t(ISBmData.size()) );
+      for( std::map<SourceID, ISBData>::const_iterator it = ISBmData.begin();
+           it != ISBmData.end();
+           ++it )
+      {
+         writer.putSource( (*it).first );
+         writer.putTime( (*it).second.previousTime );
+         writer.putTime( (*it).second.currentTime );
+      }
+
+   }  // End of method 'ISBRandomWalkModel::saveState()'
+
+
+      // Restore a state written by saveState()
+   void ISBRandomWalkModel::restoreState(StateReader& reader)
+      noexcept(false)
+   {
+      reader.checkBlock("ISBRandomWalkModel", 1);
+      ISBmData.clear();
+      uint32_t numSources( reader.get<uint32_t>() );
+      for(uint32_t s=0; s<numSources; s++)
+      {
+         ISBData& data( ISBmData[ reader.getSource() ] );
+         data.previousTime = reader.getTime();
+         data.currentTime = reader.getTime();
+      }
+
+   }  // End of method 'ISBRandomWalkModel::restoreState()'
+
+
+
+      // Write the state kept from one epoch to the next
+   void IFCBRandomWalkModel::saveState(StateWriter& writer) const
+   {
+      writer.beginBlock("IFCBRandomWalkModel", 1);
+      writer.put( uint32_t(IFCBmData.size()) );
+      for( std::map<SourceID, SatStateArray<IFCBData> >::const_iterator it
+              = IFCBmData.begin();
+           it != IFCBmData.end();
+           ++it )
+      {
+         std::vector<SatID> sats( (*it).second.getSats() );
+
+         writer.putSource( (*it).first );
+         writer.put( uint32_t(sats.size()) );
+         for(size_t i=0; i<sats.size(); i++)
+         {
+            writer.putSat( sats[i] );
+            writer.putTime( (*it).second.at(sats[i]).previousTime );
+            writer.putTime( (*it).second.at(sats[i]).currentTime );
+         }
+      }
+
+   }  // End of method 'IFCBRandomWalkModel::saveState()'
+
+
+      // Restore a state written by saveState()
+   void IFCBRandomWalkModel::restoreState(StateReader& reader)
+      noexcept(false)
+   {
+      reader.checkBlock("IFCBRandomWalkModel", 1);
+      IFCBmData.clear();
+      uint32_t numSources( reader.get<uint32_t>() );
+      for(uint32_t s=0; s<numSources; s++)
+      {
+         SatStateArray<IFCBData>& satData( IFCBmData[ reader.getSource() ] );
+
+         uint32_t numSats( reader.get<uint32_t>() );
+         for(uint32_t i=0; i<numSats; i++)
+         {
+            IFCBData& data( satData[ reader.getSat() ] );
+            data.previousTime = reader.getTime();
+            data.currentTime = reader.getTime();
+         }
+      }
+
+   }  // End of method 'IFCBRandomWalkModel::restoreState()'
+
+
 }  // End of namespace gnssSpace
@@ -44,6 +44,8 @@
 
 #include "CommonTime.hpp"
 #include "DataStructures.hpp"
+#include "SatIndex.hpp"
+#include "ProcessorState.hpp"
 
 using namespace utilSpace;
 using namespace timeSpace;
@@ -83,6 +85,25 @@ namespace gnssSpace
       { return; };
 
 
+         /** Write the state kept from one epoch to the next (epochs of
+          *  the last measurements, arcs), to start another model from it
+          *  with restoreState(). The settings (Qprime, sigma, ...) are not
+          *  part of it. Models without state write nothing.
+          */
+      virtual void saveState(StateWriter& writer) const
+      { return; };
+
+
+         /** Restore a state written by saveState() of a model of the same
+          *  class.
+          *
+          * @throw InvalidRequest if the state is not one of this class
+          */
+      virtual void restoreState(StateReader& reader)
+         noexcept(false)
+      { return; };
+
+
          /// Destructor
       virtual ~StochasticModel() {};
 
@@ -175,6 +196,13 @@ namespace gnssSpace
                             const SatID& sat,
                             typeValueMap& tData);
 
+         /// Write the state kept from one epoch to the next
+      virtual void saveState(StateWriter& writer) const;
+
+         /// Restore a state written by saveState()
+      virtual void restoreState(StateReader& reader)
+         noexcept(false);
+
          /// Destructor
       virtual ~RandomWalkModel() {};
 
@@ -334,15 +362,19 @@ namespace gnssSpace
                             const SatID& sat,
                             typeValueMap& tData)
       {
-         satTypeValueMap satData;
-         satData[sat] = tData;
-
-         checkCS(source, sat, satData); 
+         checkCS(source, sat, tData); 
 
          return;
       }
 
 
+         /// Write the state kept from one epoch to the next
+      virtual void saveState(StateWriter& writer) const;
+
+         /// Restore a state written by saveState()
+      virtual void restoreState(StateReader& reader)
+         noexcept(false);
+
          /// Destructor
       virtual ~PhaseAmbiguityModel() {};
 
@@ -363,19 +395,19 @@ namespace gnssSpace
       TypeID csFlagType;
 
          /// Map holding information regarding every satellite
-      std::map<SourceID, std::map<SatID, double> > satArcMap;
+      std::map<SourceID, SatStateArray<double> > satArcMap;
 
 
          /** This method checks if a cycle slip happened.
           *
           * @param sat        Satellite.
-          * @param data       Object holding the data.
+          * @param data       Data of the satellite.
           * @param source     Object holding the source of data.
           *
           */
       virtual void checkCS( const SourceID& source,
                             const SatID& sat,
-                            satTypeValueMap& data );
+                            typeValueMap& data );
 
    }; // End of class 'PhaseAmbiguityModel'
 
@@ -485,6 +517,13 @@ namespace gnssSpace
                             typeValueMap& tData);
 
 
+         /// Write the state kept from one epoch to the next
+      virtual void saveState(StateWriter& writer) const;
+
+         /// Restore a state written by saveState()
+      virtual void restoreState(StateReader& reader)
+         noexcept(false);
+
          /// Destructor
       virtual ~TropoRandomWalkModel() {};
 
@@ -634,6 +673,13 @@ namespace gnssSpace
                             typeValueMap& tData);
 
 
+         /// Write the state kept from one epoch to the next
+      virtual void saveState(StateWriter& writer) const;
+
+         /// Restore a state written by saveState()
+      virtual void restoreState(StateReader& reader)
+         noexcept(false);
+
          /// Destructor
       virtual ~TropoGradRandomWalkModel() {};
 
@@ -816,6 +862,13 @@ namespace gnssSpace
                             const SatID& sat,
                             typeValueMap& tData);
 
+         /// Write the state kept from one epoch to the next
+      virtual void saveState(StateWriter& writer) const;
+
+         /// Restore a state written by saveState()
+      virtual void restoreState(StateReader& reader)
+         noexcept(false);
+
          /// Destructor
       virtual ~IonoRandomWalkModel() {};
 
@@ -852,7 +905,7 @@ namespace gnssSpace
       double qprime;
 
          /// Map holding the information regarding each source
-      std::map<SatID, ionoModelData> imData;
+      SatStateArray<ionoModelData> imData;
 
 
          /// Field holding value of current variance
@@ -986,6 +1039,13 @@ namespace gnssSpace
                             typeValueMap& tData);
 
 
+         /// Write the state kept from one epoch to the next
+      virtual void saveState(StateWriter& writer) const;
+
+         /// Restore a state written by saveState()
+      virtual void restoreState(StateReader& reader)
+         noexcept(false);
+
          /// Destructor
       virtual ~RecBiasRandomWalkModel() {};
 
@@ -1139,6 +1199,13 @@ namespace gnssSpace
                             const SatID& sat,
                             typeValueMap& tData);
 
+         /// Write the state kept from one epoch to the next
+      virtual void saveState(StateWriter& writer) const;
+
+         /// Restore a state written by saveState()
+      virtual void restoreState(StateReader& reader)
+         noexcept(false);
+
          /// Destructor
       virtual ~SatBiasRandomWalkModel() {};
 
@@ -1164,7 +1231,7 @@ namespace gnssSpace
          double qprime;          ///< Process spectral density
 
          /// Map holding the information regarding each source
-      std::map<SatID, satBiasModelData> sbData;
+      SatStateArray<satBiasModelData> sbData;
 
 
          /// Field holding value of current variance
@@ -1296,6 +1363,13 @@ namespace gnssSpace
                             typeValueMap& tData);
 
 
+         /// Write the state kept from one epoch to the next
+      virtual void saveState(StateWriter& writer) const;
+
+         /// Restore a state written by saveState()
+      virtual void restoreState(StateReader& reader)
+         noexcept(false);
+
          /// Destructor
       virtual ~ISBRandomWalkModel() {};
 
@@ -1457,6 +1531,13 @@ namespace gnssSpace
                             typeValueMap& tData);
 
 
+         /// Write the state kept from one epoch to the next
+      virtual void saveState(StateWriter& writer) const;
+
+         /// Restore a state written by saveState()
+      virtual void restoreState(StateReader& reader)
+         noexcept(false);
+
          /// Destructor
       virtual ~IFCBRandomWalkModel() {};
 
@@ -1479,7 +1560,7 @@ namespace gnssSpace
          double qprime;          ///< Process spectral density
 
          /// Map holding the information regarding each source and each satellite
-	  std::map<SourceID,std::map<SatID, IFCBData>  >IFCBmData;
+	  std::map<SourceID, SatStateArray<IFCBData> > IFCBmData;
 
 
          /// Field holding value of current variance
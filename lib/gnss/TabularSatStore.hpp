@@ -772,6 +772,19 @@ namespace gnssSpace
       /// same as ndata()
       inline int size(void) const throw() { return ndata(); }
 
+      /// Get the data table of the given satellite, e.g. to copy it into
+      /// another storage.
+      /// @throw InvalidRequest if the satellite is not found
+      const DataTable& getDataTable(const SatID& sat) const noexcept(false)
+      {
+         typename SatTable::const_iterator it(tables.find(sat));
+         if(it == tables.end()) {
+            InvalidRequest e("Satellite " + sat.toString() + " not found.");
+            THROW(e);
+         }
+         return it->second;
+      }
+
       /// compute the nominal timestep of the data table for the given satellite
       /// @return 0 if satellite is not found, else the nominal timestep in seconds.
       double nomTimeStep(const SatID& sat) const throw()
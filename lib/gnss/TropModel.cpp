@@ -7,6 +7,13 @@
  */
 
 #include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "TropModel.hpp"
 #include "GPSEllipsoid.hpp"
 #include "constants.hpp"
@@ -2900,6 +2907,32 @@ namespace gnssSpace
    }
 
 
+      // Latitude, height and day of year set by setAllParameters()
+   bool NeillTropModel::saveParameters(std::vector<double>& params) const
+   {
+      params.resize(3);
+      params[0] = NeillLat;
+      params[1] = NeillHeight;
+      params[2] = NeillDOY;
+
+      return true;
+
+   }
+
+
+      // Set the parameters kept by saveParameters()
+   void NeillTropModel::restoreParameters(const std::vector<double>& params)
+   {
+      NeillLat = params[0];
+      NeillHeight = params[1];
+      NeillDOY = static_cast<int>(params[2]);
+
+      validLat = validHeight = validDOY = true;
+      valid = true;
+
+   }
+
+
    //---------------------------------------------------------------------
       /* Tropospheric model based in the Vienna mapping functions.
        *
@@ -2937,6 +2970,7 @@ namespace gnssSpace
       // @param time Time.
     ViennaTropModel::ViennaTropModel(const Position& RX,
                                      const CommonTime& time)
+        : gridSize(0), seasonStep(0.0), seasonMJD(0.0)
     {
         setReceiverLatitude(RX.getGeodeticLatitude( ));
         setReceiverLongitude(RX.getLongitude());
@@ -2945,16 +2979,16 @@ namespace gnssSpace
     }
 
 
-      // Load GPT2 grid file.
+    const char ViennaTropModel::GPT2BinaryFormat::magic[8] =
+        { 'G','B','X','G','P','T','2','\0' };
+
+
+      // Load GPT2 grid file, text or binary.
       // @param file GPT2 grid file.
     void ViennaTropModel::loadFile(const string& file)
         noexcept(false)
     {
-        gpt2DataVec.clear();
-
-        double vec[44] = {0.0};
-
-        ifstream inpf( file.c_str() );
+        ifstream inpf( file.c_str(), ios::in | ios::binary );
 
         if( !inpf )
         {
@@ -2962,16 +2996,39 @@ namespace gnssSpace
             THROW(fme);
         }
 
+        char magic[8] = { 0 };
+        inpf.read(magic, sizeof(magic));
+        bool binary( inpf.gcount() == sizeof(magic) &&
+                     std::memcmp( magic, GPT2BinaryFormat::magic,
+                                  sizeof(magic) ) == 0 );
+        inpf.close();
+
+        seasonIndex.clear();
+        seasonCells.clear();
+
+        if(binary)
+        {
+            mapBinaryFile(file);
+            return;
+        }
+
+        inpf.open( file.c_str() );
+
+        std::shared_ptr< std::vector<GPT2Data> > grid(
+                                              new std::vector<GPT2Data>() );
+        grid->reserve(180*360);
+
         string temp;
 
         // first comment line
         getline(inpf, temp);
 
-
-        bool ok(true);
-
         string line;
 
+        // the values of a line, read in place: 2 coordinates then
+        // 42 values
+        double vec[44];
+
         while( !inpf.eof() && inpf.good() )
         {
             getline(inpf,line);
@@ -2979,55 +3036,182 @@ namespace gnssSpace
 
             if( inpf.eof() ) break;
 
-            if( inpf.bad() ) { ok = false; break; }
+            if( inpf.bad() ) break;
 
-//            cout << line << endl;
+            const char* p( line.c_str() );
+            int n(0);
+            while(n < 44)
+            {
+                char* end(NULL);
+                vec[n] = std::strtod(p, &end);
+                if(end == p) break;
+                p = end;
+                n++;
+            }
 
-            vector<string> data( split(line) );
+            // blank line
+            if(n == 0) continue;
+
+            if(n < 44)
+            {
+                FFStreamError e("Bad line in GPT2 file " + file + ": " + line);
+                THROW(e);
+            }
 
             GPT2Data gpt2Data;
 
             //pgrid(n,1:5)  = vec(3:7) -  pressure in Pascal
             for (int i=0; i<5; i++)
-                gpt2Data.pgrid[i] = asDouble(data[i+2]);
+                gpt2Data.pgrid[i] = vec[i+2];
 
             //Tgrid(n,1:5)  = vec (8:12) - temperature in Kelvin
             for (int i=0; i<5; i++)
-                gpt2Data.Tgrid[i] = asDouble(data[i+7]);
+                gpt2Data.Tgrid[i] = vec[i+7];
 
             //Qgrid(n,1:5)  = vec(13:17)/1000.d0 // specific humidity in kg/kg
             for (int i=0; i<5; i++)
-                gpt2Data.Qgrid[i] = asDouble(data[i+12])/1e+3;
+                gpt2Data.Qgrid[i] = vec[i+12]/1e+3;
 
             //dTgrid(n,1:5) = vec(18:22)/1000.d0 // temperature lapse rate in Kelvin/m
             for (int i=0; i<5; i++)
-                gpt2Data.dTgrid[i] = asDouble(data[i+17])/1e+3;
+                gpt2Data.dTgrid[i] = vec[i+17]/1e+3;
             // u(n) = vec(23)            // geoid undulation in m
-            gpt2Data.undu = asDouble(data[22]);
+            gpt2Data.undu = vec[22];
             //Hs(n) = vec(24)            // orthometric grid height in m
-            gpt2Data.Hs = asDouble(data[23]);
+            gpt2Data.Hs = vec[23];
             //ahgrid(n,1:5) = vec(25:29)/1000.d0 // hydrostatic mapping function coefficient, dimensionless
             for (int i=0; i<5; i++)
-                gpt2Data.ahgrid[i] = asDouble(data[i+24])/1e+3;
+                gpt2Data.ahgrid[i] = vec[i+24]/1e+3;
             //awgrid(n,1:5) = vec(30:34)/1000.d0 // wet mapping function coefficient, dimensionless
             for (int i=0; i<5; i++)
-                gpt2Data.awgrid[i] = asDouble(data[i+29])/1e+3;
+                gpt2Data.awgrid[i] = vec[i+29]/1e+3;
             //lagrid(n,1:5) = vec(35:39)         // water vapour decrease factor, dimensionless
             for (int i=0; i<5; i++)
-                gpt2Data.lagrid[i] = asDouble(data[i+34]);
+                gpt2Data.lagrid[i] = vec[i+34];
             //Tmgrid(n,1:5) = vec(40:44)         // weighted mean temperature, Kelvin
             for (int i=0; i<5; i++)
-                gpt2Data.Tmgrid[i] = asDouble(data[i+39]);
+                gpt2Data.Tmgrid[i] = vec[i+39];
 
-            gpt2DataVec.push_back( gpt2Data );
+            grid->push_back( gpt2Data );
 
         } // End of 'while(...)'
 
         inpf.close();
 
+        // the cells are owned by the vector
+        gridData = std::shared_ptr<const GPT2Data>( grid, grid->data() );
+        gridSize = grid->size();
+
    }  // end ViennaTropModel::loadFile()
 
 
+      // Map a binary grid file into memory, read only: the processes
+      // mapping the same file share its pages.
+   void ViennaTropModel::mapBinaryFile(const string& file)
+      noexcept(false)
+   {
+      int fd( ::open(file.c_str(), O_RDONLY) );
+      if(fd < 0)
+      {
+         FileMissingException fme("Could not open GPT2 file " + file);
+         THROW(fme);
+      }
+
+      struct stat st;
+      if( ::fstat(fd, &st) != 0 ||
+          size_t(st.st_size) < GPT2BinaryFormat::headerSize )
+      {
+         ::close(fd);
+         FFStreamError e("Truncated GPT2 binary file " + file);
+         THROW(e);
+      }
+
+      size_t length( st.st_size );
+      void* base( ::mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0) );
+      ::close(fd);
+
+      if(base == MAP_FAILED)
+      {
+         FFStreamError e("Could not map GPT2 binary file " + file);
+         THROW(e);
+      }
+
+      // unmapped when the last model using it is gone
+      std::shared_ptr<const char> mapping( static_cast<const char*>(base),
+                                           [length](const char* p)
+                                           {
+                                              ::munmap( const_cast<char*>(p),
+                                                        length );
+                                           } );
+
+      uint32_t header[2];
+      uint64_t size(0);
+      std::memcpy(header, mapping.get() + 8, sizeof(header));
+      std::memcpy(&size, mapping.get() + 16, sizeof(size));
+
+      if(header[1] != GPT2BinaryFormat::byteOrderMark)
+      {
+         FFStreamError e("Byte order of GPT2 binary file " + file
+                         + " differs from this machine");
+         THROW(e);
+      }
+
+      if(header[0] > GPT2BinaryFormat::version)
+      {
+         FFStreamError e("GPT2 binary file " + file
+                         + " has a newer format version");
+         THROW(e);
+      }
+
+      if( size > (length - GPT2BinaryFormat::headerSize)/sizeof(GPT2Data) )
+      {
+         FFStreamError e("Truncated GPT2 binary file " + file);
+         THROW(e);
+      }
+
+      gridData = std::shared_ptr<const GPT2Data>( mapping,
+                    reinterpret_cast<const GPT2Data*>( mapping.get()
+                                         + GPT2BinaryFormat::headerSize ) );
+      gridSize = size;
+
+   }  // end ViennaTropModel::mapBinaryFile()
+
+
+      // Write the grid loaded into a binary file, for loadFile().
+   void ViennaTropModel::writeBinaryFile(const string& file) const
+      noexcept(false)
+   {
+      if(gridSize == 0)
+      {
+         InvalidRequest e("ViennaTropModel: no GPT2 grid to write");
+         THROW(e);
+      }
+
+      ofstream strm( file.c_str(), ios::out | ios::binary );
+      if(!strm)
+      {
+         FileMissingException e("Could not create GPT2 file " + file);
+         THROW(e);
+      }
+
+      uint32_t header[2] = { GPT2BinaryFormat::version,
+                             GPT2BinaryFormat::byteOrderMark };
+      uint64_t size( gridSize );
+      strm.write(GPT2BinaryFormat::magic, sizeof(GPT2BinaryFormat::magic));
+      strm.write(reinterpret_cast<const char*>(header), sizeof(header));
+      strm.write(reinterpret_cast<const char*>(&size), sizeof(size));
+      strm.write( reinterpret_cast<const char*>(gridData.get()),
+                  gridSize*sizeof(GPT2Data) );
+
+      if(!strm)
+      {
+         FFStreamError e("Error writing GPT2 file " + file);
+         THROW(e);
+      }
+
+   }  // end ViennaTropModel::writeBinaryFile()
+
+
    //mean gravity in m/s**2
    static const double meanGravity( 9.80665 );
 
@@ -3431,15 +3615,31 @@ namespace gnssSpace
                                   date before computing weather " );
       }
 
-      if( gpt2DataVec.empty() )
+      if( gridSize == 0 )
       {
          valid = false;
          throw InvalidTropModel( "ViennaTropModel must have GPT2 grid data \
                                   before computing weather ");
       }
 
+      // date of the seasonal terms: the epoch, or the middle of the
+      // step it is in
+      double seasonDate( ViennaMJD );
+      if(seasonStep > 0.0)
+      {
+         seasonDate = (std::floor(ViennaMJD/seasonStep) + 0.5)*seasonStep;
+      }
+
+      // the terms kept are those of another date
+      if(seasonDate != seasonMJD)
+      {
+         seasonIndex.clear();
+         seasonCells.clear();
+         seasonMJD = seasonDate;
+      }
+
       //change the reference epoch to January 1 2000
-      double mjd( ViennaMJD - 51544.5 );
+      double mjd( seasonDate - 51544.5 );
 
       //factors for amplitudes
       double cosfy = std::cos(mjd/365.25*2.0*PI);
@@ -3491,34 +3691,20 @@ namespace gnssSpace
 
           int ix = indx[0] - 1;  //-1 to use in c
 
-          GPT2Data data( gpt2DataVec[ix] );
+          GPT2Season cell( cellSeason(ix, cosfy, sinfy, coshy, sinhy) );
 
           // transforming ellipsoidal height to orthometric height
-          double hgt = ViennaHeight - data.undu;
+          double hgt = ViennaHeight - cell.undu;
 
-          double T0, p0, Q;
-
-          // pressure, temperature at the height of the grid
-          T0 = data.Tgrid[0] +
-               data.Tgrid[1]*cosfy + data.Tgrid[2]*sinfy +
-               data.Tgrid[3]*coshy + data.Tgrid[4]*sinhy;
-
-          p0 = data.pgrid[0] +
-               data.pgrid[1]*cosfy + data.pgrid[2]*sinfy +
-               data.pgrid[3]*coshy + data.pgrid[4]*sinhy;
-
-          // specific humidity
-          Q = data.Qgrid[0] +
-              data.Qgrid[1]*cosfy + data.Qgrid[2]*sinfy +
-              data.Qgrid[3]*coshy + data.Qgrid[4]*sinhy;
+          // pressure, temperature and specific humidity at the height
+          // of the grid
+          double T0( cell.T0 ), p0( cell.p0 ), Q( cell.Q );
 
           // lapse rate of the temperature
-          tLapseRate = data.dTgrid[0] +
-                       data.dTgrid[1]*cosfy + data.dTgrid[2]*sinfy +
-                       data.dTgrid[3]*coshy + data.dTgrid[4]*sinhy;
+          tLapseRate = cell.dT;
 
           // station height - grid height
-          double redh = hgt - data.Hs;
+          double redh = hgt - cell.Hs;
 
           // temperature at station height in Celsius
           temperature = T0 + tLapseRate*redh - 273.150;
@@ -3535,24 +3721,16 @@ namespace gnssSpace
           pressure = (p0*::exp(-c*redh))/100.0;
 
           // hydrostatic coefficient ah
-          hmfCoeff = data.ahgrid[0] +
-                     data.ahgrid[1]*cosfy + data.ahgrid[2]*sinfy +
-                     data.ahgrid[3]*coshy + data.ahgrid[4]*sinhy;
+          hmfCoeff = cell.ah;
 
           // wet coefficient aw
-          wmfCoeff = data.awgrid[0] +
-                     data.awgrid[1]*cosfy + data.awgrid[2]*sinfy +
-                     data.awgrid[3]*coshy + data.awgrid[4]*sinhy;
+          wmfCoeff = cell.aw;
 
           // water vapour decrease factor la - added by GP
-          dfWaterVapor = data.lagrid[0] +
-                         data.lagrid[1]*cosfy + data.lagrid[2]*sinfy +
-                         data.lagrid[3]*coshy + data.lagrid[4]*sinhy;
+          dfWaterVapor = cell.la;
 
           // mean temperature of the water vapor Tm - added by GP
-          mtWaterVapor = data.Tmgrid[0] +
-                         data.Tmgrid[1]*cosfy + data.Tmgrid[2]*sinfy +
-                         data.Tmgrid[3]*coshy + data.Tmgrid[4]*sinhy;
+          mtWaterVapor = cell.Tm;
 
           // water vapor pressure in hPa - changed by GP
           double e0 = Q*p0/(0.622 + 0.378*Q)/100.0;  // on the grid
@@ -3586,8 +3764,6 @@ namespace gnssSpace
 
           int l = 0;
 
-          GPT2Data data;
-
           double undul[4] = {0.0};
           double Ql[4] = {0.0};
           double dTl[4] = {0.0};
@@ -3605,34 +3781,22 @@ namespace gnssSpace
               //Hortho = -N + Hell
               int ix = indx[l];
 
-              data = gpt2DataVec[ix];
+              GPT2Season cell( cellSeason(ix, cosfy, sinfy, coshy, sinhy) );
 
-              undul[l] = data.undu;
-              double hgt = ViennaHeight - data.undu;
-
-              double T0, p0, Q;
+              undul[l] = cell.undu;
+              double hgt = ViennaHeight - cell.undu;
 
               //pressure, temperature at the height of the grid
-              T0 = data.Tgrid[0] +
-                   data.Tgrid[1]*cosfy + data.Tgrid[2]*sinfy +
-                   data.Tgrid[3]*coshy + data.Tgrid[4]*sinhy;
-
-              p0 = data.pgrid[0] +
-                   data.pgrid[1]*cosfy + data.pgrid[2]*sinfy +
-                   data.pgrid[3]*coshy + data.pgrid[4]*sinhy;
+              double T0( cell.T0 ), p0( cell.p0 );
 
               //humidity
-              Ql[l] = data.Qgrid[0] +
-                      data.Qgrid[1]*cosfy + data.Qgrid[2]*sinfy +
-                      data.Qgrid[3]*coshy + data.Qgrid[4]*sinhy;
+              Ql[l] = cell.Q;
 
               //reduction = stationheight - gridheight
-              double redh = hgt - data.Hs;
+              double redh = hgt - cell.Hs;
 
               //lapse rate of the temperature in degree / m
-              dTl[l] = data.dTgrid[0] +
-                       data.dTgrid[1]*cosfy + data.dTgrid[2]*sinfy +
-                       data.dTgrid[3]*coshy + data.dTgrid[4]*sinhy;
+              dTl[l] = cell.dT;
 
               //temperature reduction to station height
               Tl[l] = T0 + dTl[l]*redh - 273.150;
@@ -3645,24 +3809,16 @@ namespace gnssSpace
               pl[l] = (p0 * std::exp(-c*redh))/100.0;
 
               //hydrostatic coefficient ah
-              ahl[l] = data.ahgrid[0] +
-                       data.ahgrid[1]*cosfy + data.ahgrid[2]*sinfy +
-                       data.ahgrid[3]*coshy + data.ahgrid[4]*sinhy;
+              ahl[l] = cell.ah;
 
               //wet coefficient aw
-              awl[l] = data.awgrid[0] +
-                       data.awgrid[1]*cosfy + data.awgrid[2]*sinfy +
-                       data.awgrid[3]*coshy + data.awgrid[4]*sinhy;
+              awl[l] = cell.aw;
 
               //water vapor decrease factor la - added by GP
-              lal[l] = data.lagrid[0] +
-                       data.lagrid[1]*cosfy + data.lagrid[2]*sinfy +
-                       data.lagrid[3]*coshy + data.lagrid[4]*sinhy;
+              lal[l] = cell.la;
 
               //mean temperature of the water vapor Tm - added by GP
-              Tml[l] = data.Tmgrid[0] +
-                       data.Tmgrid[1]*cosfy + data.Tmgrid[2]*sinfy +
-                       data.Tmgrid[3]*coshy + data.Tmgrid[4]*sinhy;
+              Tml[l] = cell.Tm;
 
               //water vapor pressure in hPa - changed by GP
               double e0 = Ql[l]*p0/(0.622 + 0.378*Ql[l])/100.0; // on the grid
@@ -3732,6 +3888,80 @@ namespace gnssSpace
    }  // end ViennaTropModel::setWeather()
 
 
+      // Seasonal terms of the grid cell ix at the date seasonMJD, given
+      // the factors of the amplitudes at that date; evaluated the first
+      // time the cell is needed at the date, and kept in seasonCells.
+      // A station needs a few cells, looked for in order.
+   ViennaTropModel::GPT2Season ViennaTropModel::cellSeason( int ix,
+                                                            double cosfy,
+                                                            double sinfy,
+                                                            double coshy,
+                                                            double sinhy )
+      noexcept(false)
+   {
+      for(size_t i=0; i<seasonIndex.size(); i++)
+      {
+         if(seasonIndex[i] == ix) return seasonCells[i];
+      }
+
+      if( ix < 0 || size_t(ix) >= gridSize )
+      {
+         throw InvalidTropModel( "ViennaTropModel: position out of the GPT2 \
+                                  grid" );
+      }
+
+      const GPT2Data& data( gridData.get()[ix] );
+      GPT2Season cell;
+
+      cell.T0 = data.Tgrid[0] +
+                data.Tgrid[1]*cosfy + data.Tgrid[2]*sinfy +
+                data.Tgrid[3]*coshy + data.Tgrid[4]*sinhy;
+
+      cell.p0 = data.pgrid[0] +
+                data.pgrid[1]*cosfy + data.pgrid[2]*sinfy +
+                data.pgrid[3]*coshy + data.pgrid[4]*sinhy;
+
+      cell.Q = data.Qgrid[0] +
+               data.Qgrid[1]*cosfy + data.Qgrid[2]*sinfy +
+               data.Qgrid[3]*coshy + data.Qgrid[4]*sinhy;
+
+      cell.dT = data.dTgrid[0] +
+                data.dTgrid[1]*cosfy + data.dTgrid[2]*sinfy +
+                data.dTgrid[3]*coshy + data.dTgrid[4]*sinhy;
+
+      cell.ah = data.ahgrid[0] +
+                data.ahgrid[1]*cosfy + data.ahgrid[2]*sinfy +
+                data.ahgrid[3]*coshy + data.ahgrid[4]*sinhy;
+
+      cell.aw = data.awgrid[0] +
+                data.awgrid[1]*cosfy + data.awgrid[2]*sinfy +
+                data.awgrid[3]*coshy + data.awgrid[4]*sinhy;
+
+      cell.la = data.lagrid[0] +
+                data.lagrid[1]*cosfy + data.lagrid[2]*sinfy +
+                data.lagrid[3]*coshy + data.lagrid[4]*sinhy;
+
+      cell.Tm = data.Tmgrid[0] +
+                data.Tmgrid[1]*cosfy + data.Tmgrid[2]*sinfy +
+                data.Tmgrid[3]*coshy + data.Tmgrid[4]*sinhy;
+
+      cell.undu = data.undu;
+      cell.Hs = data.Hs;
+
+      // a moving receiver goes over many cells: keep the last ones
+      if(seasonIndex.size() >= 16)
+      {
+         seasonIndex.clear();
+         seasonCells.clear();
+      }
+      seasonIndex.push_back(ix);
+      seasonCells.push_back(cell);
+
+      return cell;
+
+   }  // end ViennaTropModel::cellSeason()
+
+
       // Define the receiver latitude; this is required before calling
       // correction() or any of the zenith_delay routines.
       //
@@ -3853,6 +4083,54 @@ namespace gnssSpace
    }
 
 
+      // Receiver position, date, and the values setWeather() interpolated
+      // from the GPT2 grid
+   bool ViennaTropModel::saveParameters(std::vector<double>& params) const
+   {
+      params.resize(13);
+      params[0]  = ViennaMJD;
+      params[1]  = ViennaLat;
+      params[2]  = ViennaLon;
+      params[3]  = ViennaHeight;
+      params[4]  = pressure;
+      params[5]  = temperature;
+      params[6]  = tLapseRate;
+      params[7]  = mtWaterVapor;
+      params[8]  = pWaterVapor;
+      params[9]  = hmfCoeff;
+      params[10] = wmfCoeff;
+      params[11] = dfWaterVapor;
+      params[12] = geoidUndu;
+
+      return true;
+
+   }
+
+
+      // Set the parameters kept by saveParameters(), without interpolating
+      // the grid again
+   void ViennaTropModel::restoreParameters(const std::vector<double>& params)
+   {
+      ViennaMJD    = params[0];
+      ViennaLat    = params[1];
+      ViennaLon    = params[2];
+      ViennaHeight = params[3];
+      pressure     = params[4];
+      temperature  = params[5];
+      tLapseRate   = params[6];
+      mtWaterVapor = params[7];
+      pWaterVapor  = params[8];
+      hmfCoeff     = params[9];
+      wmfCoeff     = params[10];
+      dfWaterVapor = params[11];
+      geoidUndu    = params[12];
+
+      validMJD = validLat = validLon = validHeight = true;
+      valid = true;
+
+   }
+
+
 using namespace utilSpace;
 using namespace coordSpace;
 using namespace timeSpace;
@@ -14,6 +14,8 @@
 #include "Position.hpp"
 #include "constants.hpp"
 
+#include <vector>
+#include <memory>
 #include <Eigen/Eigen>
 
 
@@ -141,6 +143,15 @@ namespace gnssSpace
 
       virtual void setAllParameters(const CommonTime& time, const Position& rxPos) {};
 
+         /// Put into params what setAllParameters() computed, for
+         /// restoreParameters() to set it again without computing it.
+         /// @return false if the model doesn't support it
+      virtual bool saveParameters(std::vector<double>& params) const
+         { return false; }
+
+         /// Set the parameters kept by saveParameters()
+      virtual void restoreParameters(const std::vector<double>& params) {};
+
 
          /// get weather data by a standard atmosphere model
          /// reference to white paper of Bernese 5.0, P243
@@ -1483,6 +1494,13 @@ namespace gnssSpace
                                      const Position& rxPos );
 
 
+         /// Latitude, height and day of year set by setAllParameters()
+      virtual bool saveParameters(std::vector<double>& params) const;
+
+         /// Set the parameters kept by saveParameters()
+      virtual void restoreParameters(const std::vector<double>& params);
+
+
    private:
 
 
@@ -1527,6 +1545,18 @@ namespace gnssSpace
        *   trop = viennaTM.correction(elevation);
        * @endcode
        *
+       * The GPT2 grid may be given as the text file of the model or as a
+       * binary file written by writeBinaryFile() (see gpt2_convert). The
+       * binary file is mapped into memory instead of being read, so the
+       * processes using the same file share one copy of it, and copies
+       * of a model share the grid they loaded.
+       *
+       * The seasonal terms of the grid cells are evaluated once per date
+       * for the cells used, and kept while the date doesn't change; with
+       * setSeasonStep(1.0) they are evaluated once a day, at noon, and
+       * the weather of a station is then the reduction to its height and
+       * the bilinear interpolation of those values.
+       *
        */
    class ViennaTropModel : public TropModel
    {
@@ -1546,17 +1576,29 @@ namespace gnssSpace
            double Tmgrid[5];
        };
 
+         /// Layout of the binary grid files: the magic "GBXGPT2", the
+         /// format version (uint32), the byte order mark 0x01020304
+         /// (uint32) and the number of cells (uint64), then the cells as
+         /// GPT2Data, in the order of the text file.
+       struct GPT2BinaryFormat
+       {
+           static const char magic[8];
+           static const unsigned int version = 1;
+           static const unsigned int byteOrderMark = 0x01020304;
+           static const size_t headerSize = 24;
+       };
+
    public:
 
          /// Default constructor
       ViennaTropModel(void)
+         : gridSize(0), seasonStep(0.0), seasonMJD(0.0)
       {
           validLat=false;
           validLon=false;
           validHeight=false;
           validMJD=false;
           valid=false;
-          gpt2DataVec.clear();
       };
 
 
@@ -1574,6 +1616,7 @@ namespace gnssSpace
                        const double& lon,
                        const double& ht,
                        const double& mjd )
+         : gridSize(0), seasonStep(0.0), seasonMJD(0.0)
       {
           setReceiverLatitude(lat);
           setReceiverLongitude(lon);
@@ -1591,13 +1634,33 @@ namespace gnssSpace
                        const CommonTime& time );
 
 
-         /// Load GPT2 grid file.
+         /// Load GPT2 grid file, the text file of the model or a binary
+         /// file written by writeBinaryFile().
          ///
          /// @param file GPT2 grid file.
       void loadFile(const std::string& file)
          noexcept(false);
 
 
+         /// Write the grid loaded into a binary file, for loadFile().
+         ///
+         /// @param file Binary GPT2 grid file.
+      void writeBinaryFile(const std::string& file) const
+         noexcept(false);
+
+
+         /// Number of cells of the grid loaded
+      size_t getGridSize() const
+         { return gridSize; }
+
+
+         /// Time step of the seasonal terms of the grid, in days: 0 (the
+         /// default) to evaluate them at each date, 1 to evaluate them
+         /// once a day.
+      void setSeasonStep(double days)
+         { seasonStep = days; seasonIndex.clear(); seasonCells.clear(); }
+
+
          /// Compute and return the full tropospheric delay. The receiver
          /// latitude, longitude, height and modified julian date must has
          /// been set before using the appropriate constructor or the provided
@@ -1761,9 +1824,45 @@ namespace gnssSpace
                                      const Position& rxPos );
 
 
+         /// Receiver position, date and the weather and mapping function
+         /// coefficients interpolated from the GPT2 grid by
+         /// setAllParameters()
+      virtual bool saveParameters(std::vector<double>& params) const;
+
+         /// Set the parameters kept by saveParameters()
+      virtual void restoreParameters(const std::vector<double>& params);
+
+
    private:
 
-      std::vector<GPT2Data> gpt2DataVec;
+         /// Map a binary grid file into memory
+      void mapBinaryFile(const std::string& file)
+         noexcept(false);
+
+         /// Seasonal terms of a grid cell at the date seasonMJD
+      struct GPT2Season
+      {
+         double T0, p0, Q, dT;
+         double ah, aw, la, Tm;
+         double undu, Hs;
+      };
+
+         /// Seasonal terms of the cell ix, from seasonCells or evaluated
+      GPT2Season cellSeason( int ix,
+                             double cosfy, double sinfy,
+                             double coshy, double sinhy )
+         noexcept(false);
+
+         /// Grid, owned by the vector read from a text file or by the
+         /// mapping of a binary file, and shared by the copies
+      std::shared_ptr<const GPT2Data> gridData;
+      size_t gridSize;
+
+         /// Cells evaluated at seasonMJD, a few for a station
+      double seasonStep;
+      double seasonMJD;
+      std::vector<int> seasonIndex;
+      std::vector<GPT2Season> seasonCells;
 
       double ViennaMJD;
       double ViennaLat;
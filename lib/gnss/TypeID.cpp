@@ -12,6 +12,8 @@
  * add "MWC78", "MWC75", "MWC71"
  */
 
+#include <unordered_map>
+
 #include "TypeID.hpp"
 #include "Exception.hpp"
 
@@ -531,16 +533,124 @@ namespace gnssSpace
     };
 
 
+    // Index from the names of tStrings to their ValueType, built once on
+    // first use (thread-safe, as a function-local static)
+    static const std::unordered_map<std::string, int>& nameIndex()
+    {
+        static const std::unordered_map<std::string, int> index = []()
+        {
+            std::unordered_map<std::string, int> m(2*TypeID::count);
+            for(int i=0; i<TypeID::count; i++)
+            {
+                m.emplace(TypeID::tStrings[i], i);
+            }
+            return m;
+        }();
+
+        return index;
+    }
+
+
+    // Relations between the types, found once from the names in
+    // tStrings; -1 where there is no related type
+    struct TypeRelations
+    {
+        int diff[TypeID::count];
+        int prefit[TypeID::count];
+        int satArc[TypeID::count];
+        int csFlag[TypeID::count];
+        signed char band[TypeID::count];
+        char sysChar[TypeID::count];
+
+        TypeRelations()
+        {
+            const std::unordered_map<std::string, int>& index( nameIndex() );
+
+            for(int i=0; i<TypeID::count; i++)
+            {
+                const std::string& name( TypeID::tStrings[i] );
+
+                diff[i] = find(index, name + "Diff");
+                prefit[i] = find(index, "prefit" + name);
+                csFlag[i] = find(index, "CSFlag" + name);
+
+                // ambiguities (BL1G) share the arc of their phase (L1G)
+                if(name.size() > 1 && name[0] == 'B')
+                    satArc[i] = find(index, "satArc" + name.substr(1));
+                else
+                    satArc[i] = find(index, "satArc" + name);
+
+                // observations: C1G, L1CG, ...
+                band[i] = 0;
+                sysChar[i] = 0;
+                if( (name.size() == 3 || name.size() == 4) &&
+                    std::string("CLDS").find(name[0]) != std::string::npos &&
+                    name[1] >= '1' && name[1] <= '9' &&
+                    std::string("GRECJSI").find(name[name.size()-1])
+                        != std::string::npos )
+                {
+                    band[i] = name[1] - '0';
+                    sysChar[i] = name[name.size()-1];
+                }
+            }
+        }
+
+        static int find( const std::unordered_map<std::string, int>& index,
+                         const std::string& name )
+        {
+            std::unordered_map<std::string, int>::const_iterator it( index.find(name) );
+            return (it == index.end() ? -1 : it->second);
+        }
+    };
+
+    static const TypeRelations& relations()
+    {
+        static const TypeRelations rel;
+        return rel;
+    }
+
+    // the related type of a table, or InvalidType
+    static TypeID related( const int table[], const TypeID& type,
+                           const std::string& what )
+        noexcept(false)
+    {
+        int i( table[type.type] );
+        if(i < 0)
+        {
+            InvalidType e("No " + what + " type for " + type.asString());
+            THROW(e);
+        }
+        return TypeID(static_cast<TypeID::ValueType>(i));
+    }
+
+    TypeID diffOf(const TypeID& type) noexcept(false)
+    { return related(relations().diff, type, "Diff"); }
+
+    TypeID prefitOf(const TypeID& type) noexcept(false)
+    { return related(relations().prefit, type, "prefit"); }
+
+    TypeID satArcOf(const TypeID& type) noexcept(false)
+    { return related(relations().satArc, type, "satArc"); }
+
+    TypeID csFlagOf(const TypeID& type) noexcept(false)
+    { return related(relations().csFlag, type, "CSFlag"); }
+
+    int bandOf(const TypeID& type)
+    { return relations().band[type.type]; }
+
+    char systemCharOf(const TypeID& type)
+    { return relations().sysChar[type.type]; }
+
+
     // Explicit constructor
-    TypeID::TypeID(std::string name)
+    TypeID::TypeID(const std::string& name)
     {
-        for(int i=0; i<count; i++) 
+        const std::unordered_map<std::string, int>& index( nameIndex() );
+        std::unordered_map<std::string, int>::const_iterator it( index.find(name) );
+        if( it != index.end() )
         {
-           if(tStrings[i] == name ) 
-           {
-              type = static_cast<ValueType>(i);
-              return;
-           }
+            type = static_cast<ValueType>(it->second);
+            return;
         }
 
         // if it comes here, the type is unknown
@@ -581,9 +691,7 @@ namespace gnssSpace
     // convert this object to a string representation
     std::string TypeID::asString() const
     {
-        std::ostringstream oss;
-        oss << TypeID::tStrings[type];
-        return oss.str();
+        return TypeID::tStrings[type];
     }
 
 
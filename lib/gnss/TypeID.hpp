@@ -594,11 +594,11 @@ namespace gnssSpace
 
         /** Explicit constructor
          *
-         * @param name string name for ValueType, first search tString and
-         *             then search mapUserTypeID, if it is not found, create
-         *             it.
+         * @param name string name for ValueType, looked up in a hash index
+         *             of tStrings built on first use.
+         * @throw InvalidType if the name is unknown
          */
-        TypeID(std::string name);
+        TypeID(const std::string& name);
 
 
         /// Equality requires all fields to be the same
@@ -658,6 +658,43 @@ namespace gnssSpace
     /// stream output for TypeID
     std::ostream& operator<<(std::ostream& s, const TypeID& p);
 
+
+    /** @name Related types
+     *
+     * Types derived from another one by name, e.g. prefitC1G -> 
+     * prefitC1GDiff, BL1G -> satArcL1G. The relations are found once, from
+     * tStrings (which is parallel to the ValueType enum), and kept in tables
+     * indexed by ValueType, so hot paths get them without building strings.
+     */
+    //@{
+
+    /// The differenced type: prefitC1G -> prefitC1GDiff
+    /// @throw InvalidType if there is no such type
+    TypeID diffOf(const TypeID& type) noexcept(false);
+
+    /// The prefit residual type: C1G -> prefitC1G, PC12G -> prefitPC12G
+    /// @throw InvalidType if there is no such type
+    TypeID prefitOf(const TypeID& type) noexcept(false);
+
+    /// The arc number type of a phase or ambiguity: L1G -> satArcL1G,
+    /// BL1G -> satArcL1G, WL12G -> satArcWL12G
+    /// @throw InvalidType if there is no such type
+    TypeID satArcOf(const TypeID& type) noexcept(false);
+
+    /// The cycle slip flag type of a phase: L1G -> CSFlagL1G
+    /// @throw InvalidType if there is no such type
+    TypeID csFlagOf(const TypeID& type) noexcept(false);
+
+    /// Frequency band of an observation (C1G, L2WG, ... -> 1, 2), 0 if
+    /// the type is not an observation; see getFreq() in constants.hpp
+    int bandOf(const TypeID& type);
+
+    /// System character of an observation (C1G -> 'G'), 0 if the type is
+    /// not an observation
+    char systemCharOf(const TypeID& type);
+
+    //@}
+
     /// some useful TypeID data structures
     typedef std::set<TypeID> TypeIDSet;
     typedef std::vector<TypeID> TypeIDVec;
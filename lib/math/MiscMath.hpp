@@ -140,6 +140,107 @@ namespace mathSpace
       }
    }  // end void LagrangeInterpolation(vector, vector, const T, T&, T&)
 
+   /// Compute the Lagrange weights Li(x) on the nodes X, with their first and
+   /// second derivatives, so that y(x) = SUM[L[i]*Yi], dy/dx = SUM[Lp[i]*Yi]
+   /// and d2y/dx2 = SUM[Lpp[i]*Yi]. Useful when several series are given on
+   /// the same nodes (e.g. X,Y,Z of an ephemeris), the weights are then
+   /// computed only once. Pi = PROD(j!=i)[x-Xj] and its derivatives are
+   /// accumulated factor by factor, so x may coincide with a node.
+   template <class T>
+   void LagrangeWeights(const std::vector<T>& X, const T& x,
+      std::vector<T>& L, std::vector<T>& Lp, std::vector<T>& Lpp) noexcept(false)
+   {
+      if(X.size() < 2) {
+         THROW(Exception("Input vector must have length at least 2"));
+      }
+
+      std::size_t i,j,N=X.size();
+      L.resize(N); Lp.resize(N); Lpp.resize(N);
+      for(i=0; i<N; i++) {
+         T P(1),P1(0),P2(0),D(1);
+         for(j=0; j<N; j++) {
+            if(i == j) continue;
+            T f(x-X[j]);
+            P2 = P2*f + T(2)*P1;
+            P1 = P1*f + P;
+            P *= f;
+            D *= X[i]-X[j];
+         }
+         L[i] = P/D;
+         Lp[i] = P1/D;
+         Lpp[i] = P2/D;
+      }
+   }  // end void LagrangeWeights(vector, const T, vector&, vector&, vector&)
+
+   // Fixed order Lagrange kernels.
+   // The number of nodes N is a template parameter and the data are given in
+   // plain arrays (usually on the stack), so there is no heap traffic and the
+   // compiler can unroll and vectorize the loops. Any N >= 2 is allowed, and x
+   // may coincide with a node. Use the std::vector versions above when the
+   // order is known only at run time.
+
+   /// Lagrange weights Li(x) on the N nodes X: y(x) = SUM[L[i]*Yi].
+   template <int N, class T>
+   inline void FixedLagrangeWeights(const T *X, const T& x, T *L) throw()
+   {
+      T f[N];
+      for(int j=0; j<N; j++) f[j] = x-X[j];
+      for(int i=0; i<N; i++) {
+         T P(1),D(1);
+         for(int j=0; j<N; j++) {
+            if(j == i) continue;
+            P *= f[j];
+            D *= X[i]-X[j];
+         }
+         L[i] = P/D;
+      }
+   }
+
+   /// Lagrange weights Li(x) on the N nodes X, and their derivatives:
+   /// y(x) = SUM[L[i]*Yi] and dy/dx = SUM[Lp[i]*Yi].
+   template <int N, class T>
+   inline void FixedLagrangeWeights(const T *X, const T& x, T *L, T *Lp) throw()
+   {
+      T f[N];
+      for(int j=0; j<N; j++) f[j] = x-X[j];
+      for(int i=0; i<N; i++) {
+         T P(1),P1(0),D(1);
+         for(int j=0; j<N; j++) {
+            if(j == i) continue;
+            P1 = P1*f[j] + P;
+            P *= f[j];
+            D *= X[i]-X[j];
+         }
+         L[i] = P/D;
+         Lp[i] = P1/D;
+      }
+   }
+
+   /// Lagrange interpolation of order N on the data (X[i],Y[i]), i=0,N-1.
+   template <int N, class T>
+   inline T FixedLagrangeInterpolation(const T *X, const T *Y, const T& x) throw()
+   {
+      T L[N], y(0);
+      FixedLagrangeWeights<N>(X,x,L);
+      for(int i=0; i<N; i++) y += L[i]*Y[i];
+      return y;
+   }
+
+   /// Lagrange interpolation of order N on the data (X[i],Y[i]), i=0,N-1,
+   /// returning Y(x) and dY(x)/dx.
+   template <int N, class T>
+   inline void FixedLagrangeInterpolation(const T *X, const T *Y, const T& x,
+      T& y, T& dydx) throw()
+   {
+      T L[N], Lp[N];
+      FixedLagrangeWeights<N>(X,x,L,Lp);
+      y = dydx = T(0);
+      for(int i=0; i<N; i++) {
+         y += L[i]*Y[i];
+         dydx += Lp[i]*Y[i];
+      }
+   }
+
 
       /// Returns the second derivative of Lagrange interpolation.
    template <class T>
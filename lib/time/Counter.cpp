@@ -6,7 +6,7 @@
 
 namespace timeSpace{
 
-double  Counter::m_begin_clock = (double)clock();
+thread_local double  Counter::m_begin_clock = (double)clock();
 
 void Counter::begin(){
 #ifndef USE_OPENMP
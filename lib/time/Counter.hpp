@@ -17,7 +17,8 @@ class Counter{
       static double end(); 
    
    private:
-      static double  m_begin_clock;
+      // one per thread, so that threads time their own work
+      static thread_local double  m_begin_clock;
 };
 
 }
@@ -0,0 +1,139 @@
+/**
+ * @file EpochArena.cpp
+ * Monotonic memory arena for the temporaries of one epoch.
+ */
+
+#include <new>
+#include <algorithm>
+#include <cstdint>
+
+#include "EpochArena.hpp"
+
+using namespace std;
+
+namespace utilSpace
+{
+
+    EpochArena::EpochArena(size_t firstBlockSize)
+        : curBlock(0), offset(0), live(0),
+          nAllocs(0), nBytes(0), nHeapAllocs(0)
+    {
+        addBlock(firstBlockSize);
+        nHeapAllocs = 0;
+    }
+
+
+    EpochArena::~EpochArena()
+    {
+        for(size_t i=0; i<blocks.size(); i++)
+        {
+            ::operator delete(blocks[i].data);
+        }
+    }
+
+
+      // Memory for n bytes aligned to align (a power of 2)
+    void* EpochArena::allocate(size_t n, size_t align)
+    {
+        // first block, from the current one, with room for n bytes
+        for(; curBlock < blocks.size(); curBlock++, offset = 0)
+        {
+            uintptr_t base( reinterpret_cast<uintptr_t>(blocks[curBlock].data) );
+            uintptr_t p( (base + offset + align - 1) & ~uintptr_t(align - 1) );
+            if(p + n <= base + blocks[curBlock].size)
+            {
+                offset = p + n - base;
+                break;
+            }
+        }
+
+        if(curBlock == blocks.size())
+        {
+            // blocks grow by doubling
+            addBlock( std::max(n + align, 2*blocks.back().size) );
+            offset = n;
+        }
+
+        live++;
+        nAllocs++;
+        nBytes += n;
+
+        return blocks[curBlock].data + (offset - n);
+
+    }  // End of method 'EpochArena::allocate()'
+
+
+      // Give back memory taken with allocate()
+    void EpochArena::deallocate(void*, size_t)
+    {
+        // nothing in use: start again from the first block
+        if(--live == 0)
+        {
+            curBlock = 0;
+            offset = 0;
+        }
+
+    }  // End of method 'EpochArena::deallocate()'
+
+
+      // End of the epoch: clear the statistics, and merge the blocks into a
+      // single one if nothing is in use.
+    void EpochArena::reset()
+    {
+        if(live == 0 && blocks.size() > 1)
+        {
+            size_t size( capacity() );
+            for(size_t i=0; i<blocks.size(); i++)
+            {
+                ::operator delete(blocks[i].data);
+            }
+            blocks.clear();
+            addBlock(size);
+        }
+
+        if(live == 0)
+        {
+            curBlock = 0;
+            offset = 0;
+        }
+
+        nAllocs = 0;
+        nBytes = 0;
+        nHeapAllocs = 0;
+
+    }  // End of method 'EpochArena::reset()'
+
+
+      // Total size of the blocks
+    size_t EpochArena::capacity() const
+    {
+        size_t size(0);
+        for(size_t i=0; i<blocks.size(); i++)
+        {
+            size += blocks[i].size;
+        }
+        return size;
+    }
+
+
+      // Add a block of at least n bytes, and make it current
+    void EpochArena::addBlock(size_t n)
+    {
+        Block b;
+        b.data = static_cast<char*>(::operator new(n));
+        b.size = n;
+        blocks.push_back(b);
+
+        curBlock = blocks.size() - 1;
+        nHeapAllocs++;
+    }
+
+
+      // The arena of the calling thread
+    EpochArena& EpochArena::local()
+    {
+        static thread_local EpochArena arena;
+        return arena;
+    }
+
+}  // End of namespace utilSpace
@@ -0,0 +1,174 @@
+/**
+ * @file EpochArena.hpp
+ * Monotonic memory arena for the temporaries of one epoch, and the
+ * allocator to use it with the standard containers.
+ */
+
+#ifndef EpochArena_HPP
+#define EpochArena_HPP
+
+#include <cstddef>
+#include <vector>
+#include <set>
+#include <map>
+#include <functional>
+
+namespace utilSpace
+{
+
+      /** Monotonic memory arena for the short-lived containers built while
+       *  processing one epoch (rejected satellites, look-up vectors, the
+       *  unknowns and terms of the equations of EquSysForPoint, ...).
+       *
+       *  allocate() takes the memory from the current block by moving an
+       *  offset; deallocate() only counts what is given back. When nothing
+       *  is left in use, the arena starts again from its first block, so
+       *  the next processing step reuses the same memory. reset(), called
+       *  after each epoch, merges the blocks into one as large as all of
+       *  them, so that after the first epochs the arena takes no memory
+       *  from the heap at all.
+       *
+       *  Containers using the arena must not outlive the epoch. Each thread
+       *  has its own arena, local(), which is the one used by default by
+       *  ArenaAllocator:
+       *
+       *  @code
+       *    while( rxObsFile >> rxData )
+       *    {
+       *       keepSystems.Process(rxData);
+       *       ...
+       *       EpochArena::local().reset();
+       *    }
+       *  @endcode
+       */
+    class EpochArena
+    {
+    public:
+
+         /// Constructor, with the size of the first block
+        explicit EpochArena(size_t firstBlockSize = 64*1024);
+
+         /// Destructor, the blocks go back to the heap
+        ~EpochArena();
+
+         /// Memory for n bytes aligned to align (a power of 2)
+        void* allocate(size_t n, size_t align);
+
+         /// Give back memory taken with allocate()
+        void deallocate(void*, size_t);
+
+         /** End of the epoch: clear the statistics, and merge the blocks
+          *  into a single one if nothing is in use.
+          */
+        void reset();
+
+         /// Number of allocations since the last reset
+        size_t numAllocs() const
+        { return nAllocs; }
+
+         /// Bytes allocated since the last reset
+        size_t bytesAllocated() const
+        { return nBytes; }
+
+         /// Number of blocks taken from the heap since the last reset
+        size_t numHeapAllocs() const
+        { return nHeapAllocs; }
+
+         /// Total size of the blocks
+        size_t capacity() const;
+
+         /// The arena of the calling thread
+        static EpochArena& local();
+
+    private:
+
+        EpochArena(const EpochArena&);
+        EpochArena& operator=(const EpochArena&);
+
+         /// Add a block of at least n bytes, and make it current
+        void addBlock(size_t n);
+
+        struct Block
+        {
+            char* data;
+            size_t size;
+        };
+
+         /// blocks, the current one, and the offset in it
+        std::vector<Block> blocks;
+        size_t curBlock;
+        size_t offset;
+
+         /// number of allocations not given back yet
+        size_t live;
+
+         /// statistics since the last reset
+        size_t nAllocs;
+        size_t nBytes;
+        size_t nHeapAllocs;
+
+    };  // End of class 'EpochArena'
+
+
+      /** Allocator taking its memory from an EpochArena, by default the one
+       *  of the calling thread.
+       */
+    template <class T>
+    class ArenaAllocator
+    {
+    public:
+
+        typedef T value_type;
+
+        ArenaAllocator()
+            : pArena(&EpochArena::local())
+        {}
+
+        explicit ArenaAllocator(EpochArena& arena)
+            : pArena(&arena)
+        {}
+
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U>& right)
+            : pArena(right.arena())
+        {}
+
+        T* allocate(size_t n)
+        { return static_cast<T*>(pArena->allocate(n*sizeof(T), alignof(T))); }
+
+        void deallocate(T* p, size_t n)
+        { pArena->deallocate(p, n*sizeof(T)); }
+
+        EpochArena* arena() const
+        { return pArena; }
+
+    private:
+
+        EpochArena* pArena;
+
+    };  // End of class 'ArenaAllocator'
+
+
+    template <class T, class U>
+    bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+    { return a.arena() == b.arena(); }
+
+    template <class T, class U>
+    bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+    { return a.arena() != b.arena(); }
+
+
+      /// Containers for the temporaries of one epoch
+    template <class T>
+    using EpochVector = std::vector<T, ArenaAllocator<T> >;
+
+    template <class T, class Compare = std::less<T> >
+    using EpochSet = std::set<T, Compare, ArenaAllocator<T> >;
+
+    template <class K, class V, class Compare = std::less<K> >
+    using EpochMap = std::map< K, V, Compare,
+                               ArenaAllocator< std::pair<const K, V> > >;
+
+}  // End of namespace utilSpace
+
+#endif   // EpochArena_HPP